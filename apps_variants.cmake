@@ -0,0 +1,90 @@
+# Extra builds of a target side by side with the default one, one per entry of
+# APPS_VARIANTS. An entry is one or more of the features below joined with '+':
+#   O0 O1 O2 O3 Os Og           optimisation level, after the build type's own
+#   lto                         link time optimisation
+#   flash copy_to_ram no_flash  pico_set_binary_type
+# e.g. -DAPPS_VARIANTS="O2;O3;Os;lto;O3+copy_to_ram" adds lab07_O2 ... lab07_O3_copy_to_ram.
+# Each variant is built with APPS_VARIANT defined to its name, which startup_report() prints.
+# no_flash is skipped for targets linking xip_cache, whose linker script places code in FLASH.
+set(APPS_VARIANTS "" CACHE STRING "Optimisation and binary type variants of the benchmark targets")
+
+# tools/host/size_report, if the host tools have been built into build-host.
+find_program(SIZE_REPORT size_report HINTS ${PICO_APPS_PATH}/build-host/size_report)
+set(APPS_VARIANT_RESULTS "" CACHE PATH "Directory of telemetry_decode captures named <target>.csv for size_report")
+
+# Call after the target is fully set up, the variants copy its sources, libraries,
+# definitions, options and stdio settings as they are at that point.
+function(apps_add_variants TARGET)
+    set_property(GLOBAL APPEND PROPERTY APPS_VARIANT_TARGETS ${TARGET})
+    get_target_property(BINARY_TYPE ${TARGET} PICO_TARGET_BINARY_TYPE)
+    get_target_property(LIBRARIES ${TARGET} LINK_LIBRARIES)
+
+    foreach(VARIANT ${APPS_VARIANTS})
+        string(REPLACE "+" ";" FEATURES ${VARIANT})
+        if ("no_flash" IN_LIST FEATURES AND "xip_cache" IN_LIST LIBRARIES)
+            message(WARNING "APPS_VARIANTS: skipping ${VARIANT} for ${TARGET}, xip_cache needs a FLASH region")
+            continue()
+        endif()
+        string(REPLACE "+" "_" NAME ${VARIANT})
+        set(V ${TARGET}_${NAME})
+        add_executable(${V})
+
+        foreach(PROP SOURCES LINK_LIBRARIES INCLUDE_DIRECTORIES COMPILE_DEFINITIONS COMPILE_OPTIONS LINK_OPTIONS
+                PICO_TARGET_STDIO_USB PICO_TARGET_STDIO_UART MANUALLY_ADDED_DEPENDENCIES)
+            get_target_property(VALUE ${TARGET} ${PROP})
+            # skip only unset or empty ones, a 0 such as PICO_TARGET_STDIO_UART is copied too
+            if ("${VALUE}" STREQUAL "" OR "${VALUE}" MATCHES "-NOTFOUND$")
+                continue()
+            endif()
+            if (PROP STREQUAL "MANUALLY_ADDED_DEPENDENCIES")
+                add_dependencies(${V} ${VALUE})
+            else()
+                set_target_properties(${V} PROPERTIES ${PROP} "${VALUE}")
+            endif()
+        endforeach()
+        target_compile_definitions(${V} PRIVATE APPS_VARIANT="${NAME}")
+        if (BINARY_TYPE)
+            pico_set_binary_type(${V} ${BINARY_TYPE})
+        endif()
+
+        foreach(FEATURE ${FEATURES})
+            if (FEATURE MATCHES "^O[0123sg]$")
+                target_compile_options(${V} PRIVATE -${FEATURE})
+            elseif (FEATURE STREQUAL "lto")
+                target_compile_options(${V} PRIVATE -flto)
+                target_link_options(${V} PRIVATE -flto)
+            elseif (FEATURE MATCHES "^(flash|copy_to_ram|no_flash)$")
+                pico_set_binary_type(${V} ${FEATURE})
+            else()
+                message(FATAL_ERROR "APPS_VARIANTS: unknown feature ${FEATURE} in ${VARIANT}")
+            endif()
+        endforeach()
+
+        pico_add_extra_outputs(${V})
+        apps_auto_set_url(${V})
+        set_property(GLOBAL APPEND PROPERTY APPS_VARIANT_TARGETS ${V})
+    endforeach()
+endfunction()
+
+# Call once every target is defined: size_report builds every target passed to
+# apps_add_variants with its variants and tabulates their sizes and, from
+# APPS_VARIANT_RESULTS, their benchmark results.
+function(apps_size_report)
+    get_property(TARGETS GLOBAL PROPERTY APPS_VARIANT_TARGETS)
+    if (NOT TARGETS OR NOT SIZE_REPORT)
+        return()
+    endif()
+    set(ARGS)
+    if (APPS_VARIANT_RESULTS)
+        list(APPEND ARGS --results ${APPS_VARIANT_RESULTS})
+    endif()
+    foreach(T ${TARGETS})
+        list(APPEND ARGS $<TARGET_FILE:${T}>)
+    endforeach()
+    add_custom_target(size_report
+            COMMAND ${SIZE_REPORT} ${ARGS}
+            DEPENDS ${TARGETS}
+            COMMENT "Sizes and benchmark results of the variants"
+            VERBATIM
+            )
+endfunction()
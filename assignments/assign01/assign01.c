@@ -1,9 +1,48 @@
 #include <stdio.h>
 #include "pico/stdlib.h"
 #include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/timer.h"
+#include "telemetry.h"
+#include "profiler.h"
+#include "trace.h"
+#include "led_signal.h"
+#include "idle.h"
+#include "deferred.h"
+#include "startup.h"
+#include "stack_usage.h"
+
+// build with -DASSIGN01_PROFILE=ON to sample where the core spends its time,
+// main_asm never returns so read profiler_histograms over SWD for profile_report
+#ifndef ASSIGN01_PROFILE
+#define ASSIGN01_PROFILE 0
+#endif
+#define PROFILE_RATE_HZ 1000
+
+// build with -DASSIGN01_LED_OFFLOAD=ON to blink the LED in hardware instead of
+// from the alarm ISR, the up/down buttons then only rewrite a clock divider
+#ifndef ASSIGN01_LED_OFFLOAD
+#define ASSIGN01_LED_OFFLOAD 0
+#endif
+#define LED_PIN 25
+
+// deferred work level of the ISR messages, below the telemetry report at 0
+#define DEFER_PRINT 1
+
+static led_signal_t led;
 
 void main_asm();
 
+// starts, stops or re-times the hardware blink, ltimer is the half period in us
+void asm_led_update(uint32_t lstate, uint32_t ltimer) {
+    if (lstate) {
+        led_signal_set_rate(&led, ltimer);
+    } else {
+        // paused, hold the LED where it is like the alarm version does
+        led_signal_stop(&led, gpio_get(LED_PIN));
+    }
+}
+
 void asm_gpio_init(uint pin) {
     gpio_init(pin);
 }
@@ -24,9 +63,60 @@ void asm_gpio_set_irq(uint pin) {
     gpio_set_irq_enabled(pin, GPIO_IRQ_EDGE_FALL, true);
 }
 
+// the NVIC priority registers only take word writes, which the SDK takes care of
+void asm_irq_set_priority(uint irq, uint prio) {
+    irq_set_priority(irq, prio);
+}
+
+// main_asm calls this once its ISRs are installed, from thread mode so no handler is running
+// while the vectors, PendSV's included, are rewritten
+void asm_stack_watch(void) {
+    stack_usage_watch_exceptions();
+}
+
+static void print_msg(uint32_t msg) {
+    printf("%s", (const char *)msg);
+}
+
+// prints a message from PendSV once the ISRs are done, instead of inside them
+void asm_defer_print(const char *msg) {
+    deferred_queue(DEFER_PRINT, print_msg, (uint32_t)msg);
+}
+
+// sends the LED state over the binary telemetry channel, safe to call from the ISRs
+void asm_telemetry_state(uint32_t lstate, uint32_t ltimer, uint32_t led, uint32_t alarm_lat_max) {
+    telemetry_value("lstate", lstate);
+    telemetry_value("ltimer", ltimer);
+    telemetry_value("led", led);
+    telemetry_value("alarm_lat_max_us", alarm_lat_max);
+
+    idle_stats_t stats;
+    idle_get_stats(get_core_num(), &stats);
+    telemetry_value("idle_permille", idle_residency_permille(&stats));
+    telemetry_value("stack_used", stack_usage_used(0));
+    telemetry_value("stack_isr_entry", stack_usage_exception_depth(0));
+}
+
 
 int main() {
-    stdio_init_all();
+    stack_usage_paint();
+    startup_stdio_init(STARTUP_CONSOLE_TIMEOUT_MS);
+    telemetry_init_default();
+    idle_init(IDLE_WFE);
+    deferred_init();
+    // assign01.S drives ALARM0 directly, keep the profiler off it
+    hardware_alarm_claim(0);
+    if (ASSIGN01_PROFILE) {
+        profiler_start(PROFILE_RATE_HZ);
+    }
+    if (TRACE_ENABLED) {
+        // read trace_buffers over SWD with tools/openocd/scripts/tools/pico_dump.tcl
+        trace_init();
+    }
+    if (ASSIGN01_LED_OFFLOAD) {
+        led_signal_init(&led, LED_PIN);
+    }
+    startup_report();
     main_asm();
     return 0;
 }
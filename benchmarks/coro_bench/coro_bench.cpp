@@ -0,0 +1,96 @@
+/*****************************************************************//**
+ * \file   coro_bench.cpp
+ * \brief  cost of the coroutine scheduler in lib/coro
+ *
+ * Measures the cycles per task switch with two tasks yielding to each
+ * other, how late timer wakeups are compared with their deadline, and
+ * how much of the frame pool the tasks use.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include <cstdio>
+#include <cstdint>
+#include "pico/stdlib.h"
+#include "cycle_counter.h"
+#include "startup.h"
+#include "coro.hpp"
+
+// yields per task in the ping-pong test
+constexpr uint32_t YIELDS = 1000;
+
+// timer wakeups measured and the delay before each one
+constexpr uint32_t WAKEUPS = 100;
+constexpr uint32_t WAKE_DELAY_US = 1000;
+
+
+/**
+ * @brief give the core to the other ready task n times
+ */
+coro::task ping_pong(uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        co_await coro::yield{};
+    }
+}
+
+
+struct wake_stats {
+    uint64_t total_us;
+    uint32_t min_us;
+    uint32_t max_us;
+};
+
+/**
+ * @brief sleep until a deadline n times, recording how late each wakeup was
+ */
+coro::task late_wakeups(uint32_t n, wake_stats& stats) {
+    stats = {0, UINT32_MAX, 0};
+    for (uint32_t i = 0; i < n; i++) {
+        absolute_time_t deadline = make_timeout_time_us(WAKE_DELAY_US);
+        co_await coro::delay_until(deadline);
+        uint32_t late = (uint32_t)absolute_time_diff_us(deadline, get_absolute_time());
+        stats.total_us += late;
+        if (late < stats.min_us) stats.min_us = late;
+        if (late > stats.max_us) stats.max_us = late;
+    }
+}
+
+
+/**
+ * @brief Main function to run the scheduler benchmarks
+ *
+ * @return int  Application return code (zero for success).
+ */
+int main() {
+    // straight on once a terminal is open
+    startup_stdio_init(STARTUP_CONSOLE_TIMEOUT_MS);
+    startup_report();
+
+    cycle_counter_init();
+    coro::scheduler& sched = coro::scheduler::current();
+
+    // switch cost, the run includes the two final resumes that finish the tasks
+    sched.spawn(ping_pong(YIELDS));
+    sched.spawn(ping_pong(YIELDS));
+    uint32_t switches = sched.switches();
+    uint32_t start = cycle_counter_read();
+    sched.run();
+    uint32_t cycles = cycle_counter_elapsed(start, cycle_counter_read());
+    switches = sched.switches() - switches;
+    printf("\nswitch: %lu switches, %lu.%02lu cycles each\n", switches,
+           cycles / switches, (cycles % switches) * 100 / switches);
+
+    // wakeup latency, the core sleeps in WFE until the alarm fires
+    wake_stats stats;
+    sched.spawn(late_wakeups(WAKEUPS, stats));
+    sched.run();
+    printf("wakeup: %lu us delay, late by min %lu / avg %lu / max %lu us\n", WAKE_DELAY_US,
+           stats.min_us, (uint32_t)(stats.total_us / WAKEUPS), stats.max_us);
+
+    coro::frame_stats frames = coro::get_frame_stats();
+    printf("frames: %d x %d bytes, largest %lu, in use %lu, failed %lu\n", CORO_MAX_FRAMES, CORO_FRAME_SIZE,
+           frames.largest, frames.in_use, frames.failed);
+
+    return 0;
+}
@@ -0,0 +1,186 @@
+/*****************************************************************//**
+ * \file   float_bench.cpp
+ * \brief  per-operation float/double micro-benchmark
+ *
+ * The same operation suite is built once per float/double support
+ * option (see CMakeLists.txt) and prints a cycles-per-operation table
+ * followed by end-to-end timings of the wallis kernels, so the builds
+ * can be compared line by line.
+ *
+ * Every operation runs over a small array of operands, stores its
+ * results to memory so nothing is folded away, and the cost of the
+ * same loop doing a plain copy is subtracted. The minimum over a
+ * number of repeats is kept, which filters out USB interrupts.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include <cstdio>
+#include <cstdint>
+#include <cmath>
+#include "pico/stdlib.h"
+#include "cycle_counter.h"
+#include "startup.h"
+#include "wallis.hpp"
+#include "dfloat.hpp"
+
+#ifndef FLOAT_BENCH_IMPL
+#define FLOAT_BENCH_IMPL "default"
+#endif
+
+// number of operands each operation is applied to per measurement
+constexpr int OPERANDS = 16;
+
+// number of measurements, the fastest one is reported
+constexpr int REPEATS = 32;
+
+// iterations for the end-to-end wallis runs
+constexpr size_t WALLIS_ITERATIONS = 100000;
+
+
+// operands and results live in RAM so every access is a real load/store
+static float fa[OPERANDS], fb[OPERANDS], fres[OPERANDS];
+static double da[OPERANDS], db[OPERANDS], dres[OPERANDS];
+static int32_t ia[OPERANDS], ires[OPERANDS];
+
+
+/**
+ * @brief one benchmarked operation, applied to all OPERANDS
+ */
+struct float_op {
+    const char* name;
+    void (*run)();
+};
+
+
+// ---- operation kernels ---- //
+
+static void __noinline op_copy()  { for (int i = 0; i < OPERANDS; i++) fres[i] = fa[i]; }
+static void __noinline op_dcopy() { for (int i = 0; i < OPERANDS; i++) dres[i] = da[i]; }
+
+static void __noinline op_fadd()  { for (int i = 0; i < OPERANDS; i++) fres[i] = fa[i] + fb[i]; }
+static void __noinline op_fmul()  { for (int i = 0; i < OPERANDS; i++) fres[i] = fa[i] * fb[i]; }
+static void __noinline op_fdiv()  { for (int i = 0; i < OPERANDS; i++) fres[i] = fa[i] / fb[i]; }
+static void __noinline op_fsqrt() { for (int i = 0; i < OPERANDS; i++) fres[i] = sqrtf(fa[i]); }
+static void __noinline op_i2f()   { for (int i = 0; i < OPERANDS; i++) fres[i] = (float)ia[i]; }
+static void __noinline op_f2i()   { for (int i = 0; i < OPERANDS; i++) ires[i] = (int32_t)fa[i]; }
+static void __noinline op_f2d()   { for (int i = 0; i < OPERANDS; i++) dres[i] = (double)fa[i]; }
+
+static void __noinline op_dadd()  { for (int i = 0; i < OPERANDS; i++) dres[i] = da[i] + db[i]; }
+static void __noinline op_dmul()  { for (int i = 0; i < OPERANDS; i++) dres[i] = da[i] * db[i]; }
+static void __noinline op_ddiv()  { for (int i = 0; i < OPERANDS; i++) dres[i] = da[i] / db[i]; }
+static void __noinline op_dsqrt() { for (int i = 0; i < OPERANDS; i++) dres[i] = sqrt(da[i]); }
+static void __noinline op_i2d()   { for (int i = 0; i < OPERANDS; i++) dres[i] = (double)ia[i]; }
+static void __noinline op_d2i()   { for (int i = 0; i < OPERANDS; i++) ires[i] = (int32_t)da[i]; }
+static void __noinline op_d2f()   { for (int i = 0; i < OPERANDS; i++) fres[i] = (float)da[i]; }
+
+
+// single precision ops are measured against a float copy, double ops against a double copy
+static const float_op float_ops[] = {
+    { "fadd",  op_fadd  },
+    { "fmul",  op_fmul  },
+    { "fdiv",  op_fdiv  },
+    { "fsqrt", op_fsqrt },
+    { "i2f",   op_i2f   },
+    { "f2i",   op_f2i   },
+    { "f2d",   op_f2d   },
+};
+
+static const float_op double_ops[] = {
+    { "dadd",  op_dadd  },
+    { "dmul",  op_dmul  },
+    { "ddiv",  op_ddiv  },
+    { "dsqrt", op_dsqrt },
+    { "i2d",   op_i2d   },
+    { "d2i",   op_d2i   },
+    { "d2f",   op_d2f   },
+};
+
+
+/**
+ * @brief fill the operand arrays with values that avoid any special cases
+ */
+static void init_operands() {
+    for (int i = 0; i < OPERANDS; i++) {
+        fa[i] = 1.5f + 0.37f * i;
+        fb[i] = 0.75f + 0.11f * i;
+        da[i] = 1.5 + 0.37 * i;
+        db[i] = 0.75 + 0.11 * i;
+        ia[i] = 12345 * (i + 1);
+    }
+}
+
+
+/**
+ * @brief fastest of REPEATS runs of an operation, in cycles
+ */
+static uint32_t measure(void (*run)()) {
+    uint32_t best = UINT32_MAX;
+    for (int r = 0; r < REPEATS; r++) {
+        uint32_t start = cycle_counter_read();
+        run();
+        uint32_t cycles = cycle_counter_elapsed(start, cycle_counter_read());
+        if (cycles < best) {
+            best = cycles;
+        }
+    }
+    return best;
+}
+
+
+/**
+ * @brief print the cycles per operation for a group of ops sharing a baseline
+ */
+static void print_ops(const float_op* ops, size_t count, void (*baseline)()) {
+    uint32_t overhead = measure(baseline);
+    for (size_t i = 0; i < count; i++) {
+        uint32_t cycles = measure(ops[i].run);
+        uint32_t per_op = cycles > overhead ? (cycles - overhead) / OPERANDS : 0;
+        printf("%-10s | %-6s | %8lu\n", FLOAT_BENCH_IMPL, ops[i].name, (unsigned long)per_op);
+    }
+}
+
+
+/**
+ * @brief time one wallis kernel end to end and print the result row
+ */
+template <typename T>
+static void run_wallis(const char* name) {
+    uint64_t start = time_us_64();
+    volatile double pi = static_cast<double>(wallis_prod<T>(WALLIS_ITERATIONS));
+    uint64_t elapsed = time_us_64() - start;
+    printf("%-10s | %-6s | %10llu | %.11f\n", FLOAT_BENCH_IMPL, name, elapsed, (double)pi);
+}
+
+
+/**
+ * @brief BENCHMARK - FLOAT_BENCH
+ *        Prints the per-operation cost table and the wallis kernel
+ *        timings for the float/double implementation this image
+ *        was built with.
+ *
+ * @return int  Application return code (zero for success).
+ */
+int main() {
+    // straight on once a terminal is open
+    startup_stdio_init(STARTUP_CONSOLE_TIMEOUT_MS);
+    startup_report();
+
+    init_operands();
+    cycle_counter_init();
+
+    printf("\nfloat/double implementation: %s\n\n", FLOAT_BENCH_IMPL);
+    printf("impl       | op     | cycles/op\n");
+    printf("-----------------------------------\n");
+    print_ops(float_ops, count_of(float_ops), op_copy);
+    print_ops(double_ops, count_of(double_ops), op_dcopy);
+
+    printf("\nimpl       | wallis | time (us)  | pi\n");
+    printf("-----------------------------------------------------\n");
+    run_wallis<float>("float");
+    run_wallis<double>("double");
+    run_wallis<dfloat>("dfloat");
+
+    return 0;
+}
@@ -0,0 +1,187 @@
+/*****************************************************************//**
+ * \file   interp_bench.c
+ * \brief  interpolator kernels vs. plain C
+ *
+ * Runs each kernel from lib/interp_kernels and an equivalent plain C
+ * loop over the same data, checks the outputs match and prints the
+ * cycles per element of both. The C versions are placed in RAM like
+ * the interpolator ones so that only the arithmetic differs.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "cycle_counter.h"
+#include "startup.h"
+#include "interp_kernels.h"
+
+// number of elements processed by each kernel per run
+#define ELEMENTS 256
+
+// number of runs per kernel, the fastest one is reported
+#define REPEATS 16
+
+// texture is 2^TEX_BITS x 2^TEX_BITS colours, coordinates are 16.16 fixed point
+#define TEX_BITS 5
+#define UV_FRAC_BITS 16
+
+
+static uint8_t lut[256];
+static uint8_t bytes_in[ELEMENTS];
+static uint8_t bytes_c[ELEMENTS], bytes_interp[ELEMENTS];
+static uint32_t colours_from[ELEMENTS], colours_to[ELEMENTS];
+static uint32_t colours_c[ELEMENTS], colours_interp[ELEMENTS];
+static uint32_t texture[1 << (2 * TEX_BITS)];
+
+// span parameters, a shallow diagonal through the texture
+static const uint32_t span_u = 3 << UV_FRAC_BITS;
+static const uint32_t span_v = 7 << UV_FRAC_BITS;
+static const uint32_t span_du = 0x00013000;
+static const uint32_t span_dv = 0x00004800;
+static const uint blend_alpha = 100;
+
+
+// ---- plain C reference kernels ---- //
+
+static void __not_in_flash_func(lut_map_c)(const uint8_t *src, uint8_t *dst, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = lut[src[i]];
+    }
+}
+
+
+// same formula as the hardware: base0 + alpha * (base1 - base0) / 256
+static uint32_t blend_channel_c(uint32_t from, uint32_t to, uint shift, uint alpha) {
+    int32_t a = (from >> shift) & 0xff;
+    int32_t b = (to >> shift) & 0xff;
+    return (uint32_t)(a + (((b - a) * (int32_t)alpha) >> 8)) << shift;
+}
+
+
+static void __not_in_flash_func(blend_span_c)(const uint32_t *from, const uint32_t *to, uint32_t *dst,
+                                              size_t count, uint alpha) {
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = blend_channel_c(from[i], to[i], 0, alpha) |
+                 blend_channel_c(from[i], to[i], 8, alpha) |
+                 blend_channel_c(from[i], to[i], 16, alpha);
+    }
+}
+
+
+static void __not_in_flash_func(texture_span_c)(uint32_t *dst, uint32_t u, uint32_t v,
+                                                uint32_t du, uint32_t dv, size_t count) {
+    const uint32_t mask = (1u << TEX_BITS) - 1;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t x = (u >> UV_FRAC_BITS) & mask;
+        uint32_t y = (v >> UV_FRAC_BITS) & mask;
+        dst[i] = texture[(y << TEX_BITS) | x];
+        u += du;
+        v += dv;
+    }
+}
+
+
+// ---- benchmark wrappers, one run of each kernel ---- //
+
+static void run_lut_c(void) { lut_map_c(bytes_in, bytes_c, ELEMENTS); }
+static void run_lut_interp(void) { interp_lut_map_u8(interp1, bytes_in, bytes_interp, ELEMENTS); }
+
+static void run_blend_c(void) { blend_span_c(colours_from, colours_to, colours_c, ELEMENTS, blend_alpha); }
+static void run_blend_interp(void) {
+    interp_blend_span_grb(interp0, colours_from, colours_to, colours_interp, ELEMENTS, blend_alpha);
+}
+
+static void run_texture_c(void) { texture_span_c(colours_c, span_u, span_v, span_du, span_dv, ELEMENTS); }
+static void run_texture_interp(void) {
+    interp_texture_span_u32(interp0, colours_interp, span_u, span_v, span_du, span_dv, ELEMENTS);
+}
+
+
+/**
+ * @brief fastest of REPEATS runs of a kernel, in cycles
+ */
+static uint32_t measure(void (*run)(void)) {
+    uint32_t best = UINT32_MAX;
+    for (int r = 0; r < REPEATS; r++) {
+        uint32_t start = cycle_counter_read();
+        run();
+        uint32_t cycles = cycle_counter_elapsed(start, cycle_counter_read());
+        if (cycles < best) {
+            best = cycles;
+        }
+    }
+    return best;
+}
+
+
+/**
+ * @brief time the C and interpolator versions of a kernel and print a row
+ */
+static void compare(const char *name, void (*run_c)(void), void (*run_interp)(void),
+                    const void *out_c, const void *out_interp, size_t out_size) {
+    uint32_t cycles_c = measure(run_c);
+    uint32_t cycles_interp = measure(run_interp);
+    bool match = memcmp(out_c, out_interp, out_size) == 0;
+
+    printf("%-8s | %8lu.%02lu | %8lu.%02lu | %s\n", name,
+           (unsigned long)(cycles_c / ELEMENTS), (unsigned long)(cycles_c % ELEMENTS * 100 / ELEMENTS),
+           (unsigned long)(cycles_interp / ELEMENTS), (unsigned long)(cycles_interp % ELEMENTS * 100 / ELEMENTS),
+           match ? "ok" : "MISMATCH");
+}
+
+
+/**
+ * @brief fill the tables and inputs with repeatable pseudo-random data
+ */
+static void init_data(void) {
+    uint32_t x = 0x12345678;
+    for (int i = 0; i < 256; i++) {
+        lut[i] = (uint8_t)(255 - i);
+    }
+    for (int i = 0; i < ELEMENTS; i++) {
+        x = x * 1664525 + 1013904223;
+        bytes_in[i] = (uint8_t)(x >> 24);
+        colours_from[i] = x & 0x00ffffff;
+        x = x * 1664525 + 1013904223;
+        colours_to[i] = x & 0x00ffffff;
+    }
+    for (uint i = 0; i < count_of(texture); i++) {
+        x = x * 1664525 + 1013904223;
+        texture[i] = x & 0x00ffffff;
+    }
+}
+
+
+/**
+ * @brief BENCHMARK - INTERP_BENCH
+ *        Compares the interpolator kernels against plain C and
+ *        prints the cycles per element of each.
+ *
+ * @return int  Application return code (zero for success).
+ */
+int main() {
+    // straight on once a terminal is open
+    startup_stdio_init(STARTUP_CONSOLE_TIMEOUT_MS);
+    startup_report();
+
+    init_data();
+    cycle_counter_init();
+
+    printf("\nkernel   | C cyc/elem  | interp cyc/elem | output\n");
+    printf("----------------------------------------------------\n");
+
+    interp_lut_init(interp1, lut, 0, 0, 8);
+    compare("lut", run_lut_c, run_lut_interp, bytes_c, bytes_interp, sizeof(bytes_c));
+
+    // blend mode only exists on interp0
+    interp_blend_init(interp0);
+    compare("blend", run_blend_c, run_blend_interp, colours_c, colours_interp, sizeof(colours_c));
+
+    interp_texture_init(interp0, texture, 2, TEX_BITS, TEX_BITS, UV_FRAC_BITS);
+    compare("texture", run_texture_c, run_texture_interp, colours_c, colours_interp, sizeof(colours_c));
+
+    return 0;
+}
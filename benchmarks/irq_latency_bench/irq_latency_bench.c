@@ -0,0 +1,181 @@
+/*****************************************************************//**
+ * \file   irq_latency_bench.c
+ * \brief  worst case alarm latency under a storm of button interrupts
+ *
+ * A hardware alarm fires every ALARM_PERIOD_US, and its handler notes
+ * how long after the alarm time it started. Meanwhile a PWM slice
+ * toggles STORM_PIN, whose edge interrupt stands in for a bouncing
+ * button and prints a message like assign01's gpio_isr does.
+ *
+ *   inline     both interrupts at the default priority, the button
+ *              handler prints from inside the interrupt, as assign01
+ *              used to
+ *   deferred   the alarm at 0x00 and the button at 0x40, the button
+ *              handler hands the printing to lib/deferred
+ *
+ * No wiring is needed, the storm pin only drives its own input. stdio
+ * is on the UART (GP0) so that the prints take real time and USB
+ * doesn't interrupt the measurement.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/irq.h"
+#include "hardware/pwm.h"
+#include "hardware/timer.h"
+#include "deferred.h"
+#include "startup.h"
+
+// ALARM0, which raises TIMER_IRQ_0
+#define ALARM_NUM 0
+#define ALARM_PERIOD_US 1000
+
+// the edges of this pin are the storm, 2 * STORM_HZ interrupts a second
+#define STORM_PIN 15
+#define STORM_HZ 100
+
+// time each mode is measured for
+#define MEASURE_MS 4000
+
+#define PRIO_ALARM 0x00
+#define PRIO_STORM 0x40
+
+// deferred work level of the message, as in assign01
+#define DEFER_PRINT 1
+
+static const char storm_msg[] = "LED flashing rate halved\n";
+
+static volatile uint32_t alarm_target;
+static volatile uint32_t alarms;
+static volatile uint32_t lat_sum;
+static volatile uint32_t lat_max;
+static volatile uint32_t edges;
+static volatile bool deferred_mode;
+
+typedef struct {
+    uint32_t alarms;
+    uint32_t edges;
+    uint32_t lat_avg;
+    uint32_t lat_max;
+    uint32_t dropped;
+} result_t;
+
+
+static void alarm_isr(void) {
+    uint32_t lat = timer_hw->timerawl - alarm_target;
+    hw_clear_bits(&timer_hw->intr, 1u << ALARM_NUM);
+
+    alarms++;
+    lat_sum += lat;
+    if (lat > lat_max) {
+        lat_max = lat;
+    }
+
+    alarm_target += ALARM_PERIOD_US;
+    timer_hw->alarm[ALARM_NUM] = alarm_target;
+}
+
+
+static void print_msg(uint32_t msg) {
+    printf("%s", (const char *)msg);
+}
+
+
+static void storm_isr(void) {
+    gpio_acknowledge_irq(STORM_PIN, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL);
+    edges++;
+    if (deferred_mode) {
+        deferred_queue(DEFER_PRINT, print_msg, (uint32_t)storm_msg);
+    } else {
+        printf("%s", storm_msg);
+    }
+}
+
+
+static void start_storm(void) {
+    uint slice = pwm_gpio_to_slice_num(STORM_PIN);
+    pwm_config c = pwm_get_default_config();
+    // count at 1 MHz, so the wrap is the period in microseconds
+    pwm_config_set_clkdiv_int(&c, clock_get_hz(clk_sys) / 1000000);
+    pwm_config_set_wrap(&c, 1000000 / STORM_HZ - 1);
+    pwm_init(slice, &c, false);
+    pwm_set_gpio_level(STORM_PIN, 1000000 / STORM_HZ / 2);
+    gpio_set_function(STORM_PIN, GPIO_FUNC_PWM);
+
+    irq_set_exclusive_handler(IO_IRQ_BANK0, storm_isr);
+    gpio_set_irq_enabled(STORM_PIN, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, true);
+    irq_set_enabled(IO_IRQ_BANK0, true);
+    pwm_set_enabled(slice, true);
+}
+
+
+static void stop_storm(void) {
+    pwm_set_enabled(pwm_gpio_to_slice_num(STORM_PIN), false);
+    gpio_set_irq_enabled(STORM_PIN, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, false);
+    irq_set_enabled(IO_IRQ_BANK0, false);
+    irq_remove_handler(IO_IRQ_BANK0, storm_isr);
+}
+
+
+/**
+ * @brief run the alarm and the storm for MEASURE_MS and collect the latencies
+ */
+static result_t measure(bool deferred) {
+    deferred_mode = deferred;
+    irq_set_priority(TIMER_IRQ_0, deferred ? PRIO_ALARM : PICO_DEFAULT_IRQ_PRIORITY);
+    irq_set_priority(IO_IRQ_BANK0, deferred ? PRIO_STORM : PICO_DEFAULT_IRQ_PRIORITY);
+
+    alarms = lat_sum = lat_max = edges = 0;
+    uint32_t dropped = deferred_dropped();
+
+    irq_set_exclusive_handler(TIMER_IRQ_0, alarm_isr);
+    hw_set_bits(&timer_hw->inte, 1u << ALARM_NUM);
+    irq_set_enabled(TIMER_IRQ_0, true);
+    alarm_target = timer_hw->timerawl + ALARM_PERIOD_US;
+    timer_hw->alarm[ALARM_NUM] = alarm_target;
+    start_storm();
+
+    busy_wait_ms(MEASURE_MS);
+
+    stop_storm();
+    irq_set_enabled(TIMER_IRQ_0, false);
+    hw_clear_bits(&timer_hw->inte, 1u << ALARM_NUM);
+    timer_hw->armed = 1u << ALARM_NUM;
+    irq_remove_handler(TIMER_IRQ_0, alarm_isr);
+
+    // let the queued messages drain
+    sleep_ms(100);
+    return (result_t){alarms, edges, alarms ? lat_sum / alarms : 0, lat_max, deferred_dropped() - dropped};
+}
+
+
+static void report(const char *mode, const result_t *r) {
+    printf("%-8s | %6lu | %5lu | %6lu | %6lu | %7lu\n", mode, r->alarms, r->edges, r->lat_avg, r->lat_max, r->dropped);
+}
+
+
+/**
+ * @brief Main function to compare the alarm latency with inline and deferred printing
+ *
+ * @return int  Application return code (zero for success).
+ */
+int main() {
+    // stdio is on the UART, so this goes straight on and reports the boot time
+    startup_stdio_init(STARTUP_CONSOLE_TIMEOUT_MS);
+    deferred_init();
+    hardware_alarm_claim(ALARM_NUM);
+    startup_report();
+
+    result_t inline_result = measure(false);
+    result_t deferred_result = measure(true);
+
+    printf("\nmode     | alarms | edges | avg us | max us | dropped\n");
+    printf("-------------------------------------------------------\n");
+    report("inline", &inline_result);
+    report("deferred", &deferred_result);
+    return 0;
+}
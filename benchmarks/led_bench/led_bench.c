@@ -0,0 +1,111 @@
+/*****************************************************************//**
+ * \file   led_bench.c
+ * \brief  CPU wake-ups per second of each way of blinking an LED
+ *
+ * Each mode blinks the on-board LED for a while with the core asleep
+ * in WFI, counting how many times it wakes. The timer mode toggles the
+ * LED from an alarm interrupt, like assign01; a sleep_ms loop as in
+ * blink_c and the old lab01 wakes on one alarm per sleep as well, so
+ * costs the same. The other modes use lib/led_signal.
+ *
+ * stdio is on the UART (GP0) because USB takes an interrupt every
+ * millisecond.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "led_signal.h"
+#include "startup.h"
+
+#define LED_PIN 25
+
+// time each mode is measured for
+#define MEASURE_MS 4000
+
+
+static led_signal_t led;
+
+
+static bool toggle_led(repeating_timer_t *rt) {
+    (void)rt;
+    gpio_xor_mask(1u << LED_PIN);
+    return true;
+}
+
+
+static int64_t measure_done(alarm_id_t id, void *done) {
+    (void)id;
+    *(volatile bool *)done = true;
+    return 0;
+}
+
+
+/**
+ * @brief sleep in WFI for MEASURE_MS and count the wake-ups
+ *
+ * @return uint32_t wake-ups per second, not counting the one that ends the measurement
+ */
+static uint32_t wakeups_per_second(void) {
+    volatile bool done = false;
+    uint32_t wakeups = 0;
+    add_alarm_in_ms(MEASURE_MS, measure_done, (void *)&done, true);
+    while (!done) {
+        __wfi();
+        wakeups++;
+    }
+    return (wakeups - 1) * 1000 / MEASURE_MS;
+}
+
+
+static void report(const char *mode, const char *period) {
+    printf("%-10s | %11s | %6lu\n", mode, period, wakeups_per_second());
+}
+
+
+/**
+ * @brief Main function to compare the LED blinking modes
+ *
+ * @return int  Application return code (zero for success).
+ */
+int main() {
+    // stdio is on the UART, so this goes straight on and reports the boot time
+    startup_stdio_init(STARTUP_CONSOLE_TIMEOUT_MS);
+    startup_report();
+
+    printf("\nmode       | half period | wake-ups/s\n");
+    printf("---------------------------------------\n");
+
+    static const uint32_t half_periods_us[] = {500000, 20000};
+    for (uint i = 0; i < count_of(half_periods_us); i++) {
+        uint32_t half = half_periods_us[i];
+        char period[16];
+        snprintf(period, sizeof(period), "%lu us", half);
+
+        gpio_init(LED_PIN);
+        gpio_set_dir(LED_PIN, GPIO_OUT);
+        repeating_timer_t timer;
+        add_repeating_timer_us(-(int64_t)half, toggle_led, NULL, &timer);
+        report("timer isr", period);
+        cancel_repeating_timer(&timer);
+
+        // PWM for the short period, PIO for the long one
+        led_signal_init(&led, LED_PIN);
+        led_signal_blink(&led, half);
+        report(led.mode == LED_SIGNAL_PWM ? "pwm" : "pio", period);
+        led_signal_stop(&led, false);
+    }
+
+    // heartbeat: two short flashes then a pause
+    static const uint32_t heartbeat[] = {
+        LED_SIGNAL_STEP(1, 100000), LED_SIGNAL_STEP(0, 100000),
+        LED_SIGNAL_STEP(1, 100000), LED_SIGNAL_STEP(0, 700000),
+    };
+    led_signal_pattern(&led, heartbeat, count_of(heartbeat));
+    report("pattern", "-");
+    led_signal_stop(&led, false);
+
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include "hardware/gpio.h"
+#include "led_signal.h"
 
 // Must declare the main assembly entry point before use.
 void main_asm();
@@ -51,6 +52,20 @@ void asm_gpio_put(int pin, int value) {
 }
 
 
+/**
+ * @brief Wrapper to allow the assembly code to hand the blinking
+ *        over to lib/led_signal (BLINK_ASM_OFFLOAD builds).
+ * 
+ * @param pin       The GPIO pin number of the LED.
+ * @param delay_ms  Time the LED stays on, and then off, in milliseconds.
+ */
+void asm_led_blink(int pin, int delay_ms) {
+    static led_signal_t led;
+    led_signal_init(&led, pin);
+    led_signal_blink(&led, delay_ms * 1000);
+}
+
+
 /**
  * @brief EXAMPLE - BLINK_ASM
  *        Simple example that uses assembly code to initialise
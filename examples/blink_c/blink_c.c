@@ -1,4 +1,10 @@
 #include "pico/stdlib.h"
+#include "led_signal.h"
+
+// build with -DBLINK_C_OFFLOAD=ON to blink from PIO instead of the sleep_ms loop
+#ifndef BLINK_C_OFFLOAD
+#define BLINK_C_OFFLOAD 0
+#endif
 
 /**
  * @brief EXAMPLE - BLINK_C
@@ -13,6 +19,16 @@ int main() {
     const uint LED_PIN   =  25;
     const uint LED_DELAY = 500;
 
+    if (BLINK_C_OFFLOAD) {
+        // Blink in hardware, then sleep with no interrupts left to wake the core
+        static led_signal_t led;
+        led_signal_init(&led, LED_PIN);
+        led_signal_blink(&led, LED_DELAY * 1000);
+        while (true) {
+            __wfi();
+        }
+    }
+
     // Setup the LED pin as an output.
     gpio_init(LED_PIN);
     gpio_set_dir(LED_PIN, GPIO_OUT);
@@ -1,14 +1,22 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <math.h>
 
 #include "pico/stdlib.h"
 #include "hardware/pio.h"
 #include "hardware/clocks.h"
+#include "interp_kernels.h"
 #include "ws2812.pio.h"
 
 #define IS_RGBW true        // Will use RGBW format
 #define NUM_PIXELS 1        // There is 1 WS2812 device in the chain
 #define WS2812_PIN 28       // The GPIO pin that the WS2812 connected to
+#define FADE_STEPS 32       // Number of steps in each colour cross-fade
+#define FADE_TIME_MS 500    // Time taken by each colour cross-fade
+#define GAMMA 2.2f          // Gamma of the LED brightness response
+
+// Gamma correction table, applied to each colour channel via interp1
+static uint8_t gamma_lut[256];
 
 
 /**
@@ -42,12 +50,43 @@ static inline uint32_t urgb_u32(uint8_t r, uint8_t g, uint8_t b) {
 }
 
 
+/**
+ * @brief Function to fill the gamma correction table so that equal
+ *        steps in a colour channel look like equal steps in
+ *        brightness.
+ */
+static void init_gamma_lut() {
+    for (int i = 0; i < 256; i++) {
+        gamma_lut[i] = (uint8_t) (powf(i / 255.0f, GAMMA) * 255.0f + 0.5f);
+    }
+}
+
+
+/**
+ * @brief Function to cross-fade the LED from one colour to the
+ *        next. The blend is calculated by interp0 and the result
+ *        gamma corrected through the lookup table on interp1.
+ * 
+ * @param from  The 32-bit colour value the fade starts at
+ * @param to    The 32-bit colour value the fade ends at
+ */
+static void fade_pixel(uint32_t from, uint32_t to) {
+    for (uint step = 0; step < FADE_STEPS; step++) {
+        uint32_t colour = interp_blend_grb(interp0, from, to, step * 256 / FADE_STEPS);
+        interp_lut_map_grb(interp1, &colour, &colour, 1);
+        put_pixel(colour);
+        sleep_ms(FADE_TIME_MS / FADE_STEPS);
+    }
+}
+
+
 /**
  * @brief EXAMPLE - WS2812_RGB
  *        Simple example to initialise the NeoPixel RGB LED on
- *        the MAKER-PI-PICO and then flash it in alternating
- *        colours between red, green and blue forever using
- *        one of the RP2040 built-in PIO controllers.
+ *        the MAKER-PI-PICO and then fade it between red, green
+ *        and blue forever using one of the RP2040 built-in PIO
+ *        controllers, with the colour maths done by the
+ *        interpolators.
  * 
  * @return int  Application return code (zero for success).
  */
@@ -61,20 +100,25 @@ int main() {
     uint offset = pio_add_program(pio, &ws2812_program);
     ws2812_program_init(pio, 0, offset, WS2812_PIN, 800000, IS_RGBW);
 
-    // Do forever...
-    while(true) {
+    // Set up interp0 for blending and interp1 for gamma correction
+    init_gamma_lut();
+    interp_blend_init(interp0);
+    interp_lut_init(interp1, gamma_lut, 0, 0, 8);
 
-        // Set the color to red at half intensity
-        put_pixel(urgb_u32(0x7F, 0x00, 0x00));
-        sleep_ms(500);
+    // Red, green and blue at half intensity
+    const uint32_t colours[] = {
+        urgb_u32(0x7F, 0x00, 0x00),
+        urgb_u32(0x00, 0x7F, 0x00),
+        urgb_u32(0x00, 0x00, 0x7F),
+    };
 
-        // Set the color to green at half intensity
-        put_pixel(urgb_u32(0x00, 0x7F, 0x00));
-        sleep_ms(500);
+    // Do forever...
+    while(true) {
 
-        // Set the color to blue at half intensity
-        put_pixel(urgb_u32(0x00, 0x00, 0x7F));
-        sleep_ms(500);
+        // Fade from each colour to the next, wrapping back to red
+        for (uint i = 0; i < count_of(colours); i++) {
+            fade_pixel(colours[i], colours[(i + 1) % count_of(colours)]);
+        }
 
     }
 
@@ -4,6 +4,9 @@
  * 
  * The program uses the Pico SDK to blink the onboard LED
  * at a defined interval using the RP2040 SDK.
+ *
+ * The blink runs as a coro::task, so the core sleeps in the
+ * scheduler between LED changes instead of spinning in sleep_ms.
  * 
  * \author marco
  * \date   January 2025
@@ -11,6 +14,9 @@
 
 
 #include "pico/stdlib.h"
+#include "coro.hpp"
+#include "idle.h"
+#include "startup.h"
 #include <cstdint>
 
  // LED GPIO pin number
@@ -19,37 +25,65 @@ constexpr uint32_t LED_PIN = 25;
 // LED blink delay in milliseconds
 constexpr uint32_t LED_DELAY = 500;
 
+// how often the idle residency is printed, in milliseconds
+constexpr uint32_t IDLE_REPORT = 10000;
+
 
 /**
  * @brief Blinks an LED on the specified GPIO pin at a given interval
  * 
+ * Deadlines advance from the previous one, so the period doesn't
+ * drift by the time spent between wakeups.
+ * 
  * @param pin_num The GPIO pin number to blink
  * @param sleep_delay The delay in milliseconds between LED state changes
  */
-void blink_led(uint32_t pin_num, uint32_t sleep_delay);
+coro::task blink_led(uint32_t pin_num, uint32_t sleep_delay);
+
+
+/**
+ * @brief Prints the share of time the core spent asleep every IDLE_REPORT ms
+ */
+coro::task report_idle();
 
 
 /**
  * @brief Main function to initialise GPIO and control LED
  * 
  * Function initialises the GPIO pin for the LED and then
- * continuously calls the blink_led function
+ * runs the blink_led task on this core's scheduler
  * 
  * @return int Return 0 for success (never returns)
  */
 int main() {
+    startup_stdio_init(STARTUP_CONSOLE_TIMEOUT_MS);
+    startup_report();
     gpio_init(LED_PIN);
     gpio_set_dir(LED_PIN, GPIO_OUT);
-    while (true) {
-		blink_led(LED_PIN, LED_DELAY);
-    }
+
+    coro::scheduler& sched = coro::scheduler::current();
+    sched.spawn(blink_led(LED_PIN, LED_DELAY));
+    sched.spawn(report_idle());
+    sched.run(); // blink_led never finishes, so this doesn't return
     return 0;
 }
 
-void blink_led(uint32_t pin_num, uint32_t sleep_delay) {
-    gpio_put(pin_num, 1); // Turn LED on
-	sleep_ms(sleep_delay); // Sleep for delay
+coro::task blink_led(uint32_t pin_num, uint32_t sleep_delay) {
+    absolute_time_t next = get_absolute_time();
+    while (true) {
+        gpio_put(pin_num, 1); // Turn LED on
+        next = delayed_by_ms(next, sleep_delay);
+        co_await coro::delay_until(next); // Sleep for delay
 
-	gpio_put(pin_num, 0); // Turn LED off
-	sleep_ms(sleep_delay); // Sleep for delay
+        gpio_put(pin_num, 0); // Turn LED off
+        next = delayed_by_ms(next, sleep_delay);
+        co_await coro::delay_until(next); // Sleep for delay
+    }
+}
+
+coro::task report_idle() {
+    while (true) {
+        co_await coro::delay_ms(IDLE_REPORT);
+        idle_print();
+    }
 }
@@ -5,6 +5,11 @@
  * This is similar to lab01.cpp but uses the multicore API to
  * run the LED blink on core 1. This allows the main core to
  * keep running and do other things.
+ *
+ * Core 1 runs a coroutine scheduler rather than a sleep_ms loop: the
+ * blink task sleeps between LED changes and a second task waits on
+ * the inter-core FIFO, so core 0 can change the blink delay at any
+ * time by pushing the new delay in milliseconds.
  * 
  * \note    This doesn't work on the wokwi simulator 
  *          (it only supports single core),
@@ -17,6 +22,10 @@
 
 #include "pico/stdlib.h"
 #include "pico/multicore.h"
+#include "coro.hpp"
+#include "idle.h"
+#include "startup.h"
+#include "stack_usage.h"
 #include <cstdint>
 
 
@@ -24,6 +33,9 @@
 uint32_t g_led_pin = 25;
 uint32_t g_led_delay = 500;
 
+// how often each core prints its idle residency, in milliseconds
+constexpr uint32_t IDLE_REPORT = 10000;
+
 
 /**
  * @brief launches the blinking logic on the second core (non-blocking)
@@ -40,11 +52,29 @@ void blink_led(uint32_t pin_num, uint32_t sleep_delay);
 /**
  * @brief Entry function for core 1, which performs the actual blinking
  * 
- * Runs indefinitely, toggling the LED state at the specified interval.
+ * Runs the blink and delay tasks on core 1's scheduler indefinitely.
  */
 void core1_entry();
 
 
+/**
+ * @brief toggles the LED every g_led_delay milliseconds
+ */
+coro::task blink_task();
+
+
+/**
+ * @brief sets g_led_delay to each word core 0 pushes into the FIFO
+ */
+coro::task delay_task();
+
+
+/**
+ * @brief prints core 1's idle residency every IDLE_REPORT ms
+ */
+coro::task report_task();
+
+
 /**
  * @brief Main function to initialise GPIO and control LED
  * 
@@ -59,11 +89,19 @@ int main() {
 	// Can change g_led_pin and g_led_delay here
     ///
     
+    stack_usage_paint(); // before core 1 is launched onto its stack
+    startup_stdio_init(STARTUP_CONSOLE_TIMEOUT_MS);
+    startup_report();
     blink_led(g_led_pin, g_led_delay);
 
     while (true) {
 
-        // Main loop is free to do something else
+        // Main loop is free to do something else,
+        // multicore_fifo_push_blocking(ms) changes the blink delay.
+        // Until then it idles and reports how much of the time it slept.
+        idle_sleep_ms(IDLE_REPORT);
+        idle_print();
+        stack_usage_print();
 
     }
 
@@ -85,13 +123,37 @@ void core1_entry() {
     gpio_init(g_led_pin);
     gpio_set_dir(g_led_pin, GPIO_OUT);
 
+    // Both tasks share core 1, each only runs when it has something to do
+    coro::scheduler& sched = coro::scheduler::current();
+    sched.spawn(blink_task());
+    sched.spawn(delay_task());
+    sched.spawn(report_task());
+    sched.run();
+}
 
-	// Repeatedly blink the LED (only blocks this core)
+coro::task blink_task() {
+    absolute_time_t next = get_absolute_time();
     while (true) {
         gpio_put(g_led_pin, 1);
-        sleep_ms(g_led_delay);
+        next = delayed_by_ms(next, g_led_delay);
+        co_await coro::delay_until(next);
 
         gpio_put(g_led_pin, 0);
-        sleep_ms(g_led_delay);
+        next = delayed_by_ms(next, g_led_delay);
+        co_await coro::delay_until(next);
+    }
+}
+
+coro::task delay_task() {
+    while (true) {
+        // takes effect from the next LED change
+        g_led_delay = co_await coro::fifo_pop();
+    }
+}
+
+coro::task report_task() {
+    while (true) {
+        co_await coro::delay_ms(IDLE_REPORT);
+        idle_print();
     }
-}
\ No newline at end of file
+}
@@ -1,7 +1,7 @@
 /*****************************************************************//**
  * \file   lab02.c
  * \brief  approximation of pi using wallis product, comparing precision
- *		   of float and double
+ *		   of float, double and double-float
  * 
  * \author marco
  * \date   February 2025
@@ -14,49 +14,48 @@
 #include "pico/double.h"
 #include "pico/stdlib.h"
 
-#define ITERATIONS 100000
-#define ACTUAL_PI 3.14159265359
-
 // uncomment below if running in wokwi
 // #define WOKWI
 
+// the original float and double kernels, add wallis.h and wallis_legacy.c from lib/wallis
+// to the simulator project alongside this file
+#include "wallis.h"
 
-/**
- * @brief computes pi approximation using wallis product formula with single precision floats
- * 
- * pi / 2 = product from i = 1 to n of [(2i / (2i - 1)) * (2i / (2i + 1))]
- * multiply the final product by 2 to get pi approximation
- * 
- * @param n Number of iterations
- */
-float wallis_prod_float(size_t n);
-
+// the other shared libraries are only available when building with CMake
+#ifndef WOKWI
+#include "wallis_bench.h"
+#include "telemetry.h"
+#include "startup.h"
+#include "bench_log.h"
+#endif
 
-/**
- * @brief computes pi approximation using wallis product formula with double precision floats
- * 
- * calculation is identical to wallis_prod_float except with doubles instead of floats
- * 
- * @param n Number of iterations
- */
-double wallis_prod_double(size_t n);
+#define ITERATIONS 100000
+#define ACTUAL_PI 3.14159265359
 
 
 /**
- * @brief main computes pi approximations and prints their values and the associated errors
+ * @brief main computes pi approximations and prints their values, the associated errors
+ *        and the time each kernel took, then times every variant of the kernel template
+ *        against the original kernels
  */
 int main() {
 	// needed for hardware (initialises USB input/output)
 	// not needed for Wokwi simulator
 #ifndef WOKWI
-	stdio_init_all();
+	// waits for the console to open instead of a fixed delay
+	startup_stdio_init(STARTUP_CONSOLE_TIMEOUT_MS);
+	telemetry_init_default();
+	startup_report();
+	bench_log_init();
 #endif
 
-	// give time to prepare console
-	sleep_ms(10000);
+	uint64_t start_time = time_us_64();
+	float pi_float = wallis_prod_float_legacy(ITERATIONS);
+	uint64_t time_float = time_us_64() - start_time;
 
-	float pi_float = wallis_prod_float(ITERATIONS);
-	double pi_double = wallis_prod_double(ITERATIONS);
+	start_time = time_us_64();
+	double pi_double = wallis_prod_double_legacy(ITERATIONS);
+	uint64_t time_double = time_us_64() - start_time;
 
 	// Calculate errors for float and double
 	float error_float = fabsf(pi_float - ACTUAL_PI);
@@ -64,32 +63,48 @@ int main() {
 	float percentage_error_float = (error_float / ACTUAL_PI) * 100.0f;
 	double percentage_error_double = (error_double / ACTUAL_PI) * 100.0;
 
-	printf("\n\n\n\t   Precision   |   Calculated PI   |   Absolute Error   |   Percentage Error   \n");
-	printf("\t-------------------------------------------------------------------------------\n");
-	printf("\t     Float     |   %.11f   |   %.11f    |     %.11f%%\n", pi_float, error_float, percentage_error_float);
-	printf("\t-------------------------------------------------------------------------------\n");
-	printf("\t     Double    |   %.11lf   |   %.11lf    |     %.11lf%%\n\n", pi_double, error_double, percentage_error_double);
+#ifndef WOKWI
+	start_time = time_us_64();
+	double pi_dfloat = wallis_prod_dfloat(ITERATIONS);
+	uint64_t time_dfloat = time_us_64() - start_time;
+	double error_dfloat = fabs(pi_dfloat - ACTUAL_PI);
+	double percentage_error_dfloat = (error_dfloat / ACTUAL_PI) * 100.0;
+
+	// binary copy of the results on uart0, see tools/host/telemetry_decode
+	telemetry_bench(1, 0, ITERATIONS, (uint32_t)time_float, pi_float, "float");
+	telemetry_bench(1, 0, ITERATIONS, (uint32_t)time_double, pi_double, "double");
+	telemetry_bench(1, 0, ITERATIONS, (uint32_t)time_dfloat, pi_dfloat, "dfloat");
+
+	// history in flash, compared with the previous build, see lib/bench_log
+	bench_log_result("float", (uint32_t)time_float);
+	bench_log_result("double", (uint32_t)time_double);
+	bench_log_result("dfloat", (uint32_t)time_dfloat);
+	bench_log_commit();
+#endif
 
+	printf("\n\n\n\t   Precision   |   Calculated PI   |   Absolute Error   |   Percentage Error   |   Time (us)   \n");
+	printf("\t-----------------------------------------------------------------------------------------------\n");
+	printf("\t     Float     |   %.11f   |   %.11f    |     %.11f%%    |   %10llu\n", pi_float, error_float, percentage_error_float, time_float);
+	printf("\t-----------------------------------------------------------------------------------------------\n");
+	printf("\t     Double    |   %.11lf   |   %.11lf    |     %.11lf%%    |   %10llu\n", pi_double, error_double, percentage_error_double, time_double);
+#ifndef WOKWI
+	printf("\t-----------------------------------------------------------------------------------------------\n");
+	printf("\t  Double-float |   %.11lf   |   %.11lf    |     %.11lf%%    |   %10llu\n", pi_dfloat, error_dfloat, percentage_error_dfloat, time_dfloat);
+#endif
+	printf("\n");
 
-	return 0;
-}
 
-float wallis_prod_float(size_t n) {
-	float product = 1.0f;
-	for (size_t i = 1; i <= n; i++) {
-		float term = (2.0f * i) / (2.0f * i - 1.0f);
-		product *= term;
-		product *= (2.0f * i) / (2.0f * i + 1.0f);
-	}
-	return product * 2.0f;
-}
+#ifndef WOKWI
+	// every instantiation of the kernel template in lib/wallis against the original lab kernels
+	static wallis_result_t results[WALLIS_VARIANT_MAX];
+	wallis_benchmark(ITERATIONS, results);
+	wallis_print_results(results);
 
-double wallis_prod_double(size_t n) {
-	double product = 1.0;
-	for (size_t i = 1; i <= n; i++) {
-		double term = (2.0 * i) / (2.0 * i - 1.0);
-		product *= term;
-		product *= (2.0 * i) / (2.0 * i + 1.0);
+	for (size_t v = 0; v < wallis_variant_count; v++) {
+		telemetry_bench(2, 0, ITERATIONS, (uint32_t)results[v].time_us, results[v].pi, results[v].variant->name);
 	}
-	return product * 2.0;
+	telemetry_flush();
+#endif
+
+	return 0;
 }
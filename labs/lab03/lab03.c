@@ -1,4 +1,7 @@
+#include "pico/stdlib.h"
 #include "hardware/gpio.h"
+#include "idle.h"
+#include "startup.h"
 
 // Must declare the main assembly entry point before use.
 void main_asm();
@@ -51,6 +54,27 @@ void asm_gpio_put(int pin, int value) {
 }
 
 
+/**
+ * @brief Button edge callback, only there so that the edge interrupt
+ *        wakes the core from idle_wait() (the SDK clears the event).
+ */
+static void button_wake(uint gpio, uint32_t events) {
+    (void)gpio;
+    (void)events;
+}
+
+
+/**
+ * @brief Wrapper to allow the assembly code to enable the button
+ *        edge interrupts that wake the core from idle_wait().
+ *
+ * @param pin       The GPIO pin number of the button.
+ */
+void asm_gpio_set_irq(int pin) {
+    gpio_set_irq_enabled_with_callback(pin, GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE, true, button_wake);
+}
+
+
 /**
  * @brief EXAMPLE - BLINK_ASM
  *        Simple example that uses assembly code to initialise
@@ -62,6 +86,11 @@ void asm_gpio_put(int pin, int value) {
  */
 int main() {
 
+    // Residency is printed on stdio, idle in WFE so no edge is missed
+    startup_stdio_init(STARTUP_CONSOLE_TIMEOUT_MS);
+    startup_report();
+    idle_init(IDLE_WFE);
+
     // Jump into the main assembly code subroutine.
     main_asm();
 
@@ -1,4 +1,7 @@
+#include "pico/stdlib.h"
 #include "hardware/gpio.h"
+#include "idle.h"
+#include "startup.h"
 
 // Must declare the main assembly entry point before use.
 void main_asm();
@@ -51,6 +54,17 @@ void asm_gpio_put(int pin, int value) {
 }
 
 
+/**
+ * @brief Wrapper to allow the assembly code to call the idle_sleep_ms()
+ *        function, which is inline in idle.h.
+ * 
+ * @param ms        The number of milliseconds to idle for.
+ */
+void asm_idle_sleep_ms(int ms) {
+    idle_sleep_ms(ms);
+}
+
+
 /**
  * @brief EXAMPLE - BLINK_ASM
  *        Simple example that uses assembly code to initialise
@@ -62,6 +76,11 @@ void asm_gpio_put(int pin, int value) {
  */
 int main() {
 
+    // Residency is printed on stdio
+    startup_stdio_init(STARTUP_CONSOLE_TIMEOUT_MS);
+    startup_report();
+    idle_init(IDLE_WFE);
+
     // Jump into the main assembly code subroutine.
     main_asm();
 
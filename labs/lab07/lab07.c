@@ -1,44 +1,67 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <pico/stdlib.h>
 #include <pico/multicore.h>
 #include <hardware/structs/xip_ctrl.h>
+#include "wallis.h"
+#include "wallis_bench.h"
+#include "telemetry.h"
+#include "profiler.h"
+#include "trace.h"
+#include "startup.h"
+#include "bench_log.h"
+#include "xip_cache.h"
+#include "stack_usage.h"
+#include "shell.h"
 
 // define the cache enable bit mask for XIP_CTRL register
 #define XIP_CACHE_ENABLE_MASK 0x01
 
+// build with -DLAB07_PROFILE=ON to sample both cores, see tools/host/profile_report
+#ifndef LAB07_PROFILE
+#define LAB07_PROFILE 0
+#endif
+#define PROFILE_RATE_HZ 2000
+
 // type definitions for the wallis product functions
 typedef float (*wallis_func_float_t)(size_t);
 typedef double (*waliis_func_double_t)(size_t);
 
+// any kernel as core 1 and the shell run it, float results widened
+typedef double (*wallis_kernel_t)(size_t);
+
+// iterations of the fixed scenarios, the same every boot so the history compares like with like
+#define ITER_MAX 100000
+
+// runs queued by the shell, each a kernel, core count, cache setting and iteration count
+#define JOB_QUEUE_LEN 64
+
+// telemetry scenario number of the shell's runs
+#define SHELL_SCENARIO 0
+
+// pushed by core 1 once its interrupt handlers are installed
+#define CORE1_READY 0xc01e7eadu
+#define CORE1_PARKED 0xc01e0ff0u
+
 // Must declare the main assembly entry point before use.
 void main_asm();
 
-/**
- * @brief computes pi approximation using wallis product formula with single precision floats
- * 
- * pi / 2 = product from i = 1 to n of [(2i / (2i - 1)) * (2i / (2i + 1))]
- * multiply the final product by 2 to get pi approximation
- * 
- * @param n Number of iterations
- */
- float wallis_prod_float(size_t n);
-
- /**
-  * @brief computes pi approximation using wallis product formula with double precision floats
-  * 
-  * calculation is identical to wallis_prod_float except with doubles instead of floats
-  * 
-  * @param n Number of iterations
-  */
- double wallis_prod_double(size_t n);
+// hand-written Thumb-1 kernels in lab07.S, calling the ROM float and double routines directly
+float wallis_asm_float(size_t n);
+double wallis_asm_double(size_t n);
 
+// wallis_prod_float() as a wallis_kernel_t
+static double wallis_float_kernel(size_t n);
 
 /**
  * @brief entry-point for core 1
  * 
- * function pointer is passed in via the FIFO with one incoming int32_t used as a parameter
+ * pushes CORE1_READY once set up, then a wallis_kernel_t is passed in via the FIFO with
+ * one incoming int32_t used as a parameter
  * The function will provide an int32_t return value by pushing it back on the FIFO
  * which indicates the result is ready
+ * A NULL kernel stops its profiler, pushes CORE1_PARKED and waits to be reset
  */
 
  void core1_entry();
@@ -54,8 +77,30 @@ bool get_xip_cache_en();
 /**
  * @brief runs and prints wallis time test results
  * NB: single core only
+ * 
+ * each result is also sent as a telemetry record tagged with the scenario number
  */
- void wallis_time_test_single_core(uint32_t iterations);
+ void wallis_time_test_single_core(uint8_t scenario, uint32_t iterations);
+
+
+/**
+ * @brief times every variant of the wallis kernel template against the original kernels
+ * NB: single core only
+ */
+void wallis_variants_test(uint8_t scenario, uint32_t iterations);
+
+
+/**
+ * @brief telemetry flags describing the current cache and core setup
+ */
+uint8_t bench_flags(bool dual_core);
+
+
+/**
+ * @brief adds a kernel time to the flash history as "s<scenario> <kernel>",
+ * printing how it compares with the last build
+ */
+void history_result(uint8_t scenario, const char *kernel, uint64_t time_us);
 
 
 
@@ -68,20 +113,120 @@ bool get_xip_cache_en();
 bool set_xip_cache_en(bool cache_en);
 
 
-int main() {
-  const int ITER_MAX = 100000;
-  stdio_init_all();
+/**
+ * @brief times the same float kernel from flash with the cache on and off, pinned in the cache,
+ * from the cache used as SRAM and from SRAM
+ *
+ * leaves the cache enabled with nothing pinned
+ */
+void placement_test(uint8_t scenario, uint32_t iterations);
 
-  sleep_ms(5000); // wait a few seconds to connect to the serial output
 
-  uint64_t single_time, double_time, total_time;
-  uint64_t start_time, end_time;
-  volatile double pi_double;
+/**
+ * @brief scenarios 1 to 5, as lab07 has always run them at boot
+ */
+void run_scenarios(void);
+
+
+/**
+ * @brief write the queued history results, which needs core 1 stopped while flash is written
+ */
+void commit_history(void);
+
+
+/**
+ * @brief run one repetition of the job at the head of the shell's queue
+ *
+ * @return false if the queue is empty
+ */
+bool run_next_job(void);
+
+
+// shell commands, see lab07_commands
+void cmd_run(int argc, char *argv[]);
+void cmd_status(int argc, char *argv[]);
+void cmd_clear(int argc, char *argv[]);
+void cmd_kernels(int argc, char *argv[]);
+void cmd_scenarios(int argc, char *argv[]);
+void cmd_history(int argc, char *argv[]);
+void cmd_stack(int argc, char *argv[]);
+void cmd_mem(int argc, char *argv[]);
+
+// lab07_mem.cpp, times the allocation patterns of lib/fixed_mem with malloc and with its arenas
+void mem_bench_print(uint32_t ops);
+
+// lab07_placement.cpp, the float kernel of lib/wallis in flash, pinned in the cache, in XIP SRAM and in SRAM
+float wallis_float_flash(size_t n);
+float wallis_float_pinned(size_t n);
+float wallis_float_xip_sram(size_t n);
+float wallis_float_sram(size_t n);
+
+static const shell_command_t lab07_commands[] = {
+  {"run", "[kernel=<k,...>] [cores=<1|2,...>] [cache=<on|off,...>] [iters=<n,...>] [reps=<n>]  queue every combination",
+   cmd_run},
+  {"status", " show the queue", cmd_status},
+  {"clear", " drop the queued runs", cmd_clear},
+  {"kernels", " list the kernel names", cmd_kernels},
+  {"scenarios", " run the boot scenarios again and commit their history", cmd_scenarios},
+  {"history", " print the benchmark history", cmd_history},
+  {"stack", " print the stack high-water marks", cmd_stack},
+  {"mem", "[ops=<n>]  time lib/fixed_mem against malloc", cmd_mem},
+};
+
+
+int main() {
+  stack_usage_paint(); // before core 1 is running on its stack
+  startup_stdio_init(STARTUP_CONSOLE_TIMEOUT_MS); // waits for the serial output to connect
+  telemetry_init_default();
+  startup_report();
+  bench_log_init();
 
   multicore_launch_core1(core1_entry);
 
+  if (LAB07_PROFILE) {
+    profiler_start(PROFILE_RATE_HZ);
+  }
+  if (TRACE_ENABLED) {
+    trace_init();
+  }
+  // wait for core 1's handlers too, the vectors can't change once they are watched
+  uint32_t ready = multicore_fifo_pop_blocking();
+  hard_assert(ready == CORE1_READY);
+  stack_usage_watch_exceptions();
+
+  run_scenarios();
+
+  stack_usage_print();
+  printf("\n");
+
+  if (LAB07_PROFILE) {
+    // stop sampling core 0 so the dump itself is not profiled, its handler can only be removed unwatched
+    stack_usage_unwatch_exceptions();
+    profiler_stop();
+    profiler_dump();
+  }
+
+  commit_history();
+
+  // then take commands, so other runs need no rebuild
+  shell_init(lab07_commands, count_of(lab07_commands));
+  printf("# lab07 shell, type help\n");
+  printf("# row,job,rep,kernel,cores,core,cache,iters,time_us,pi\n");
+  while (true) {
+    if (!shell_poll() && !run_next_job()) {
+      tight_loop_contents();
+    }
+  }
+}
+
+
 
+// ---- function implementations ---- //
 
+void run_scenarios(void) {
+  uint64_t single_time, double_time, total_time;
+  uint64_t start_time, end_time;
+  volatile double pi_double;
 
   // scenario 1: single core with cache enabled
   printf("--Scenario 1: single core, cache enabled--\n");
@@ -90,7 +235,8 @@ int main() {
   start_time = time_us_64();
 
   printf("Cache status: %s\n", get_xip_cache_en() ? "Enabled" : "Disabled");
-  wallis_time_test_single_core(ITER_MAX);
+  wallis_time_test_single_core(1, ITER_MAX);
+  wallis_variants_test(1, ITER_MAX);
 
   printf("Total time (microseconds) = %llu\n\n", time_us_64() - start_time);
 
@@ -105,7 +251,8 @@ int main() {
   start_time = time_us_64();
 
   printf("Cache status: %s\n", get_xip_cache_en() ? "Enabled" : "Disabled");
-  wallis_time_test_single_core(ITER_MAX);
+  wallis_time_test_single_core(2, ITER_MAX);
+  wallis_variants_test(2, ITER_MAX);
 
   printf("Total time (microseconds) = %llu\n\n", time_us_64() - start_time);
 
@@ -120,7 +267,7 @@ int main() {
 
   printf("Cache status: %s\n", get_xip_cache_en() ? "Enabled" : "Disabled");
 
-  multicore_fifo_push_blocking((uintptr_t)&wallis_prod_float);
+  multicore_fifo_push_blocking((uintptr_t)wallis_float_kernel);
   multicore_fifo_push_blocking(ITER_MAX);
 
   uint64_t core0_start = time_us_64();
@@ -138,6 +285,12 @@ int main() {
   printf("Double precision pi time (microseconds) = %llu\n", double_time);
   printf("Total time (microseonds) = %llu\n\n", total_time);
 
+  // core 1 only hands back its time, so no result for the float kernel
+  telemetry_bench(3, bench_flags(true), ITER_MAX, (uint32_t)single_time, 0.0, "float");
+  telemetry_bench(3, bench_flags(true), ITER_MAX, (uint32_t)double_time, pi_double, "double");
+  history_result(3, "float", single_time);
+  history_result(3, "double", double_time);
+
 
 
 
@@ -151,7 +304,7 @@ int main() {
   start_time = time_us_64();
 
   printf("Cache status: %s\n", get_xip_cache_en() ? "Enabled" : "Disabled");
-  multicore_fifo_push_blocking((uintptr_t)&wallis_prod_float);
+  multicore_fifo_push_blocking((uintptr_t)wallis_float_kernel);
   multicore_fifo_push_blocking(ITER_MAX);
 
   core0_start = time_us_64();
@@ -169,17 +322,43 @@ int main() {
   printf("Double precision pi time (microseconds) = %llu\n", double_time);
   printf("Total time (microseconds) = %llu\n\n", total_time);
 
+  telemetry_bench(4, bench_flags(true), ITER_MAX, (uint32_t)single_time, 0.0, "float");
+  telemetry_bench(4, bench_flags(true), ITER_MAX, (uint32_t)double_time, pi_double, "double");
+  history_result(4, "float", single_time);
+  history_result(4, "double", double_time);
+
+
+
+
+
+  // scenario 5: where the kernel code lives
+  printf("--Scenario 5: single core, kernel placement--\n");
+  placement_test(5, ITER_MAX);
+  printf("\n");
+  telemetry_flush();
+
   // get rid of unused warnings
   (void)pi_double;
-
-  return 0;
 }
 
 
+void commit_history(void) {
+  // core 1 runs from flash, stop it while writing the history and start it again after,
+  // it gives its profiler's alarm and handler back first, which needs the vectors unwatched
+  stack_usage_unwatch_exceptions();
+  multicore_fifo_push_blocking((uintptr_t)NULL);
+  uint32_t parked = multicore_fifo_pop_blocking();
+  hard_assert(parked == CORE1_PARKED);
+  multicore_reset_core1();
+  bench_log_commit();
+  multicore_launch_core1(core1_entry);
+  uint32_t ready = multicore_fifo_pop_blocking();
+  hard_assert(ready == CORE1_READY);
+  stack_usage_watch_exceptions();
+}
 
-// ---- function implementations ---- //
 
-void wallis_time_test_single_core(uint32_t iterations) {
+void wallis_time_test_single_core(uint8_t scenario, uint32_t iterations) {
   // run the single-precision wallis product
   uint64_t start_time = time_us_64();
   volatile float pi_single = wallis_prod_float(iterations);
@@ -195,7 +374,48 @@ void wallis_time_test_single_core(uint32_t iterations) {
   end_time = time_us_64();
   double_time = end_time - start_time;
   printf("Double precision pi time (microseconds) = %llu\n", double_time);
+
+  // run the double-float wallis product
+  volatile double pi_dfloat;
+  uint64_t dfloat_time;
+  start_time = time_us_64();
+  pi_dfloat = wallis_prod_dfloat(iterations);
+  end_time = time_us_64();
+  dfloat_time = end_time - start_time;
+  printf("Double-float precision pi time (microseconds) = %llu\n", dfloat_time);
+
+  // the float and double increment kernels of lib/wallis, written in assembly
+  volatile float pi_asm_float;
+  uint64_t asm_float_time;
+  start_time = time_us_64();
+  pi_asm_float = wallis_asm_float(iterations);
+  end_time = time_us_64();
+  asm_float_time = end_time - start_time;
+  printf("Assembly single precision pi time (microseconds) = %llu\n", asm_float_time);
+
+  volatile double pi_asm_double;
+  uint64_t asm_double_time;
+  start_time = time_us_64();
+  pi_asm_double = wallis_asm_double(iterations);
+  end_time = time_us_64();
+  asm_double_time = end_time - start_time;
+  printf("Assembly double precision pi time (microseconds) = %llu\n", asm_double_time);
+
+  telemetry_bench(scenario, bench_flags(false), iterations, (uint32_t)single_time, pi_single, "float");
+  telemetry_bench(scenario, bench_flags(false), iterations, (uint32_t)double_time, pi_double, "double");
+  telemetry_bench(scenario, bench_flags(false), iterations, (uint32_t)dfloat_time, pi_dfloat, "dfloat");
+  history_result(scenario, "float", single_time);
+  history_result(scenario, "double", double_time);
+  history_result(scenario, "dfloat", dfloat_time);
+  telemetry_bench(scenario, bench_flags(false), iterations, (uint32_t)asm_float_time, pi_asm_float, "asmfloat");
+  telemetry_bench(scenario, bench_flags(false), iterations, (uint32_t)asm_double_time, pi_asm_double, "asmdouble");
+  // "s<n> asmdouble" just fits the history's 12 character names
+  history_result(scenario, "asmfloat", asm_float_time);
+  history_result(scenario, "asmdouble", asm_double_time);
   (void)pi_double;
+  (void)pi_dfloat;
+  (void)pi_asm_float;
+  (void)pi_asm_double;
   (void)pi_single; // warnings
 }
 
@@ -203,32 +423,105 @@ void wallis_time_test_single_core(uint32_t iterations) {
 
 
 
-float wallis_prod_float(size_t n) {
-	float product = 1.0f;
-	for (size_t i = 1; i <= n; i++) {
-		float term = (2.0f * i) / (2.0f * i - 1.0f);
-		product *= term;
-		product *= (2.0f * i) / (2.0f * i + 1.0f);
-	}
-	return product * 2.0f;
+void wallis_variants_test(uint8_t scenario, uint32_t iterations) {
+  static wallis_result_t results[WALLIS_VARIANT_MAX];
+  wallis_benchmark(iterations, results);
+  wallis_print_results(results);
+  for (size_t v = 0; v < wallis_variant_count; v++) {
+    telemetry_bench(scenario, bench_flags(false), iterations, (uint32_t)results[v].time_us, results[v].pi,
+                    results[v].variant->name);
+  }
+}
+
+
+typedef enum {
+  PLACE_FLASH_CACHED,
+  PLACE_FLASH_UNCACHED,
+  PLACE_PINNED,
+  PLACE_XIP_SRAM,
+  PLACE_SRAM,
+} placement_t;
+
+
+static const struct {
+  const char *name;
+  wallis_func_float_t kernel;
+} placements[] = {
+  [PLACE_FLASH_CACHED] = {"flash/cache", wallis_float_flash},
+  [PLACE_FLASH_UNCACHED] = {"flash/nocache", wallis_float_flash},
+  [PLACE_PINNED] = {"flash/pinned", wallis_float_pinned},
+  [PLACE_XIP_SRAM] = {"xip_sram", wallis_float_xip_sram},
+  [PLACE_SRAM] = {"sram", wallis_float_sram},
+};
+
+
+void placement_test(uint8_t scenario, uint32_t iterations) {
+  size_t pinned = 0;
+  printf("%-14s %10s %12s\n", "placement", "time (us)", "cache hits");
+  for (size_t p = 0; p < count_of(placements); p++) {
+    xip_cache_unpin_all();
+    if (p == PLACE_XIP_SRAM) {
+      xip_cache_sram_load();
+    } else if (xip_cache_sram_active()) {
+      xip_cache_sram_release();
+    } else {
+      set_xip_cache_en(p != PLACE_FLASH_UNCACHED);
+    }
+    if (p == PLACE_PINNED) {
+      if (xip_cache_pin_marked()) {
+        pinned = xip_cache_pinned();
+      } else {
+        printf("%-14s pinning failed, the kernel runs from the normal cache\n", placements[p].name);
+      }
+    }
+
+    xip_cache_counters_reset();
+    uint64_t start_time = time_us_64();
+    volatile float pi = placements[p].kernel(iterations);
+    uint64_t time = time_us_64() - start_time;
+    uint32_t hits, accesses;
+    xip_cache_counters(&hits, &accesses);
+
+    if (accesses) {
+      printf("%-14s %10llu %11.1f%%\n", placements[p].name, time, 100.0 * hits / accesses);
+    } else {
+      printf("%-14s %10llu %12s\n", placements[p].name, time, "-");
+    }
+    telemetry_bench(scenario, bench_flags(false), iterations, (uint32_t)time, pi, placements[p].name);
+    history_result(scenario, placements[p].name, time);
+  }
+
+  // the later flash writes flush the cache anyway, but leave it as the other scenarios expect
+  if (xip_cache_sram_active()) {
+    xip_cache_sram_release();
+  }
+  xip_cache_unpin_all();
+  set_xip_cache_en(true);
+  printf("XIP SRAM used: %u bytes, pinned: %u bytes\n", (unsigned)xip_cache_sram_used(), (unsigned)pinned);
+}
+
+
+
+
+
+uint8_t bench_flags(bool dual_core) {
+  return (get_xip_cache_en() ? TLM_BENCH_CACHE_EN : 0) | (dual_core ? TLM_BENCH_DUAL_CORE : 0);
 }
 
 
 
 
-double wallis_prod_double(size_t n) {
-	double product = 1.0;
-	for (size_t i = 1; i <= n; i++) {
-		double term = (2.0 * i) / (2.0 * i - 1.0);
-		product *= term;
-		product *= (2.0 * i) / (2.0 * i + 1.0);
-	}
-	return product * 2.0;
+
+void history_result(uint8_t scenario, const char *kernel, uint64_t time_us) {
+  char name[BENCH_STORE_NAME_LEN + 1];
+  snprintf(name, sizeof(name), "s%u %s", scenario, kernel);
+  bench_log_result(name, (uint32_t)time_us);
 }
 
 
 
 
+
 bool get_xip_cache_en() {
   // the cache enable bit is bit 0 of the XIP_CTRL register
   return (*(volatile uint32_t*)(XIP_CTRL_BASE) & XIP_CACHE_ENABLE_MASK) != 0;
@@ -258,25 +551,272 @@ bool set_xip_cache_en(bool cache_en) {
 
 
 
+static double wallis_float_kernel(size_t n) {
+  return wallis_prod_float(n);
+}
+
+static double wallis_asm_float_kernel(size_t n) {
+  return wallis_asm_float(n);
+}
+
+
+// the kernels the shell runs by name, besides every entry of wallis_variants
+static const struct {
+  const char *name;
+  wallis_kernel_t run;
+} kernels[] = {
+  {"float", wallis_float_kernel},
+  {"double", wallis_prod_double},
+  {"dfloat", wallis_prod_dfloat},
+  {"asmfloat", wallis_asm_float_kernel},
+  {"asmdouble", wallis_asm_double},
+};
+
+
+/**
+ * @brief look up a kernel by name
+ *
+ * @return the kernel, with name set to the table's copy, or NULL if there is none
+ */
+static wallis_kernel_t find_kernel(const char **name) {
+  for (size_t k = 0; k < count_of(kernels); k++) {
+    if (strcmp(*name, kernels[k].name) == 0) {
+      *name = kernels[k].name;
+      return kernels[k].run;
+    }
+  }
+  for (size_t v = 0; v < wallis_variant_count; v++) {
+    if (strcmp(*name, wallis_variants[v].name) == 0) {
+      *name = wallis_variants[v].name;
+      return wallis_variants[v].run;
+    }
+  }
+  return NULL;
+}
+
+
+typedef struct {
+  uint32_t id;
+  const char *kernel_name;
+  wallis_kernel_t kernel;
+  uint8_t cores;
+  bool cache;
+  uint32_t iters;
+  uint32_t reps;
+  uint32_t rep;         // repetitions done
+} job_t;
+
+// ring of queued jobs, the head one is running
+static job_t jobs[JOB_QUEUE_LEN];
+static size_t job_head, job_count;
+static uint32_t next_job_id;
+
+
+bool run_next_job(void) {
+  if (job_count == 0) {
+    return false;
+  }
+  job_t *job = &jobs[job_head];
+  set_xip_cache_en(job->cache);
+
+  // core 1 starts first and hands back its time when done, as in scenarios 3 and 4
+  if (job->cores == 2) {
+    multicore_fifo_push_blocking((uintptr_t)job->kernel);
+    multicore_fifo_push_blocking(job->iters);
+  }
+  uint64_t start_time = time_us_64();
+  double pi = job->kernel(job->iters);
+  uint64_t time = time_us_64() - start_time;
+
+  printf("row,%lu,%lu,%s,%u,0,%s,%lu,%llu,%.11f\n", job->id, job->rep, job->kernel_name, job->cores,
+         job->cache ? "on" : "off", job->iters, time, pi);
+  telemetry_bench(SHELL_SCENARIO, bench_flags(job->cores == 2), job->iters, (uint32_t)time, pi, job->kernel_name);
+  if (job->cores == 2) {
+    uint32_t core1_time = multicore_fifo_pop_blocking();
+    printf("row,%lu,%lu,%s,2,1,%s,%lu,%lu,\n", job->id, job->rep, job->kernel_name, job->cache ? "on" : "off",
+           job->iters, core1_time);
+    telemetry_bench(SHELL_SCENARIO, bench_flags(true), job->iters, core1_time, 0.0, job->kernel_name);
+  }
+
+  if (++job->rep == job->reps) {
+    job_head = (job_head + 1) % JOB_QUEUE_LEN;
+    job_count--;
+    printf("# job %lu done\n", job->id);
+    if (job_count == 0) {
+      printf("# queue empty\n");
+    }
+  }
+  return true;
+}
+
+
+void cmd_run(int argc, char *argv[]) {
+  static const char *const keys[] = {"kernel", "cores", "cache", "iters", "reps", NULL};
+  if (!shell_args_known(argc, argv, keys)) {
+    return;
+  }
+
+  // every parameter is a comma separated list, defaulting to a single float run like scenario 1
+  char *kernel_list[JOB_QUEUE_LEN], *cores_list[2], *cache_list[2], *iters_list[JOB_QUEUE_LEN];
+  char kernel_default[] = "float", cores_default[] = "1", cache_default[] = "on", iters_default[12];
+  snprintf(iters_default, sizeof(iters_default), "%d", ITER_MAX);
+  const char *arg;
+  size_t n_kernel = shell_split((arg = shell_arg(argc, argv, "kernel")) ? (char *)arg : kernel_default, ',',
+                                kernel_list, count_of(kernel_list));
+  size_t n_cores = shell_split((arg = shell_arg(argc, argv, "cores")) ? (char *)arg : cores_default, ',',
+                               cores_list, count_of(cores_list));
+  size_t n_cache = shell_split((arg = shell_arg(argc, argv, "cache")) ? (char *)arg : cache_default, ',',
+                               cache_list, count_of(cache_list));
+  size_t n_iters = shell_split((arg = shell_arg(argc, argv, "iters")) ? (char *)arg : iters_default, ',',
+                               iters_list, count_of(iters_list));
+  uint32_t reps = 1;
+  if ((arg = shell_arg(argc, argv, "reps")) && (!shell_parse_u32(arg, &reps) || reps == 0)) {
+    printf("# error: reps=%s\n", arg);
+    return;
+  }
+
+  // check everything before queueing anything
+  for (size_t k = 0; k < n_kernel; k++) {
+    const char *name = kernel_list[k];
+    if (!find_kernel(&name)) {
+      printf("# error: no kernel %s, see kernels\n", kernel_list[k]);
+      return;
+    }
+  }
+  for (size_t c = 0; c < n_cores; c++) {
+    if (strcmp(cores_list[c], "1") != 0 && strcmp(cores_list[c], "2") != 0) {
+      printf("# error: cores=%s, 1 or 2\n", cores_list[c]);
+      return;
+    }
+  }
+  for (size_t c = 0; c < n_cache; c++) {
+    if (strcmp(cache_list[c], "on") != 0 && strcmp(cache_list[c], "off") != 0) {
+      printf("# error: cache=%s, on or off\n", cache_list[c]);
+      return;
+    }
+  }
+  uint32_t iters[JOB_QUEUE_LEN];
+  for (size_t i = 0; i < n_iters; i++) {
+    if (!shell_parse_u32(iters_list[i], &iters[i])) {
+      printf("# error: iters=%s\n", iters_list[i]);
+      return;
+    }
+  }
+  size_t total = n_kernel * n_cores * n_cache * n_iters;
+  if (total > JOB_QUEUE_LEN - job_count) {
+    printf("# error: %u runs, only room for %u more\n", total, JOB_QUEUE_LEN - job_count);
+    return;
+  }
+
+  uint32_t first = next_job_id;
+  for (size_t k = 0; k < n_kernel; k++) {
+    for (size_t c = 0; c < n_cores; c++) {
+      for (size_t h = 0; h < n_cache; h++) {
+        for (size_t i = 0; i < n_iters; i++) {
+          job_t *job = &jobs[(job_head + job_count++) % JOB_QUEUE_LEN];
+          job->id = next_job_id++;
+          job->kernel_name = kernel_list[k];
+          job->kernel = find_kernel(&job->kernel_name);
+          job->cores = cores_list[c][0] == '2' ? 2 : 1;
+          job->cache = strcmp(cache_list[h], "on") == 0;
+          job->iters = iters[i];
+          job->reps = reps;
+          job->rep = 0;
+        }
+      }
+    }
+  }
+  printf("# queued jobs %lu to %lu, %lu reps each\n", first, next_job_id - 1, reps);
+}
+
+
+void cmd_status(int argc, char *argv[]) {
+  printf("# %u jobs queued\n", job_count);
+  for (size_t j = 0; j < job_count; j++) {
+    const job_t *job = &jobs[(job_head + j) % JOB_QUEUE_LEN];
+    printf("# job %lu kernel=%s cores=%u cache=%s iters=%lu reps=%lu/%lu\n", job->id, job->kernel_name, job->cores,
+           job->cache ? "on" : "off", job->iters, job->rep, job->reps);
+  }
+}
+
+
+void cmd_clear(int argc, char *argv[]) {
+  printf("# dropped %u jobs\n", job_count);
+  job_count = 0;
+}
+
+
+void cmd_kernels(int argc, char *argv[]) {
+  for (size_t k = 0; k < count_of(kernels); k++) {
+    printf("# %s\n", kernels[k].name);
+  }
+  for (size_t v = 0; v < wallis_variant_count; v++) {
+    printf("# %s\n", wallis_variants[v].name);
+  }
+}
+
+
+void cmd_scenarios(int argc, char *argv[]) {
+  run_scenarios();
+  commit_history();
+}
+
+
+void cmd_history(int argc, char *argv[]) {
+  bench_log_dump();
+}
+
+
+void cmd_stack(int argc, char *argv[]) {
+  stack_usage_print();
+}
+
+
+void cmd_mem(int argc, char *argv[]) {
+  static const char *const keys[] = {"ops", NULL};
+  uint32_t ops = 10000;
+  const char *arg;
+  if (!shell_args_known(argc, argv, keys)) {
+    return;
+  }
+  if ((arg = shell_arg(argc, argv, "ops")) && (!shell_parse_u32(arg, &ops) || ops == 0)) {
+    printf("# error: ops=%s\n", arg);
+    return;
+  }
+  mem_bench_print(ops);
+}
+
+
 void core1_entry() {
-  // using wallis float function pointer type
-  // to improve the readibility
-  wallis_func_float_t func_float = wallis_prod_float;
+  // started again after every history commit, the reset before it cleared the NVIC and SysTick
+  if (LAB07_PROFILE) {
+    profiler_start(PROFILE_RATE_HZ);
+  }
+  if (TRACE_ENABLED) {
+    trace_init();
+  }
+  multicore_fifo_push_blocking(CORE1_READY);
+
   while (1) {
-      // get the function pointer from the fifo and the iteration count
-      void* func_ptr = (void*)multicore_fifo_pop_blocking();
+      // get the kernel from the fifo and the iteration count
+      wallis_kernel_t kernel = (wallis_kernel_t)multicore_fifo_pop_blocking();
+      if (kernel == NULL) {
+        // commit_history() resets this core next, so the alarm has to be unclaimed here
+        if (LAB07_PROFILE) {
+          profiler_stop();
+        }
+        multicore_fifo_push_blocking(CORE1_PARKED);
+        while (1) {
+          tight_loop_contents();
+        }
+      }
       int32_t iterations = multicore_fifo_pop_blocking();
       
       // take snapshot of timer
       uint64_t start_time = time_us_64();
       
-      if (func_ptr == (void*)func_float) {
-          volatile float result = wallis_prod_float((size_t)iterations);
-          (void)result; // get rid of unused var warning
-      } else {
-          volatile double result = wallis_prod_double((size_t)iterations);
-          (void)result;
-      }
+      volatile double result = kernel((size_t)iterations);
+      (void)result; // get rid of unused var warning
       
       uint64_t execution_time = time_us_64() - start_time;
       
@@ -0,0 +1,22 @@
+/*****************************************************************//**
+ * \file   lab07_mem.cpp
+ * \brief  lab07's "mem" command, lib/fixed_mem against newlib's malloc
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include <cstdio>
+#include "pico/stdlib.h"
+#include "fixed_mem_bench.hpp"
+
+extern "C" void mem_bench_print(uint32_t ops) {
+    fixed_mem::bench_result results[fixed_mem::BENCH_PATTERNS];
+    fixed_mem::benchmark(time_us_32, ops, results);
+
+    printf("# mem,pattern,ops,malloc_us,fixed_us,high_water,capacity,malloc_failures,fixed_failures\n");
+    for (const fixed_mem::bench_result& r : results) {
+        printf("mem,%s,%lu,%lu,%lu,%u,%u,%lu,%lu\n", r.pattern, r.ops, r.malloc_ticks, r.fixed_ticks,
+               r.fixed.high_water, r.fixed.capacity, r.malloc_failures, r.fixed.failures);
+    }
+}
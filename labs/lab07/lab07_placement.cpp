@@ -0,0 +1,31 @@
+/*****************************************************************//**
+ * \file   lab07_placement.cpp
+ * \brief  the float kernel of lib/wallis once per memory placement
+ *
+ * Each wrapper instantiates the same wallis_prod() template, which is
+ * always inlined, so every copy holds the whole loop in its own
+ * section for lab07's placement scenario.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include "pico/stdlib.h"
+#include "xip_cache.h"
+#include "wallis.hpp"
+
+extern "C" float __attribute__((noinline)) wallis_float_flash(size_t n) {
+    return wallis_prod<float, 1, wallis_fusion::separate>(n);
+}
+
+extern "C" float XIP_PIN_FUNC(wallis_float_pinned)(size_t n) {
+    return wallis_prod<float, 1, wallis_fusion::separate>(n);
+}
+
+extern "C" float XIP_SRAM_FUNC(wallis_float_xip_sram)(size_t n) {
+    return wallis_prod<float, 1, wallis_fusion::separate>(n);
+}
+
+extern "C" float __not_in_flash_func(wallis_float_sram)(size_t n) {
+    return wallis_prod<float, 1, wallis_fusion::separate>(n);
+}
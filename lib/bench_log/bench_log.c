@@ -0,0 +1,160 @@
+/*****************************************************************//**
+ * \file   bench_log.c
+ * \brief  benchmark history kept in flash, with regression checks
+ *
+ * The flash backend reads through XIP and writes with the SDK flash
+ * functions, which flush the XIP cache when they are done. A no_flash
+ * build has no image in flash to hash and nothing has set the flash
+ * up, so there bench_log_init() leaves the log off and the rest does
+ * nothing.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "bench_log.h"
+#include "pico/stdlib.h"
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+#include "hardware/regs/addressmap.h"
+
+static_assert(FLASH_SECTOR_SIZE == BENCH_STORE_SECTOR_SIZE, "store sectors are flash sectors");
+static_assert(FLASH_PAGE_SIZE == BENCH_STORE_PAGE_SIZE, "store pages are flash pages");
+
+// flash offset of the history
+#define REGION_OFFSET (PICO_FLASH_SIZE_BYTES - BENCH_LOG_SECTORS * FLASH_SECTOR_SIZE)
+
+typedef struct {
+    char scenario[BENCH_STORE_NAME_LEN + 1];
+    uint32_t value;
+} pending_t;
+
+static bench_store_t store;
+static bool enabled;
+static uint32_t build_id;
+static pending_t pending[BENCH_LOG_PENDING];
+static uint pending_count;
+
+
+#if !PICO_NO_FLASH
+// end of the program image, from the SDK linker script
+extern char __flash_binary_end;
+
+
+static bool flash_read(void *ctx, uint32_t offset, void *buf, uint32_t len) {
+    (void)ctx;
+    memcpy(buf, (const void *)(XIP_BASE + REGION_OFFSET + offset), len);
+    return true;
+}
+
+
+static bool flash_erase(void *ctx, uint32_t offset) {
+    (void)ctx;
+    uint32_t save = save_and_disable_interrupts();
+    flash_range_erase(REGION_OFFSET + offset, FLASH_SECTOR_SIZE);
+    restore_interrupts(save);
+    return true;
+}
+
+
+static bool flash_program(void *ctx, uint32_t offset, const void *page) {
+    (void)ctx;
+    uint32_t save = save_and_disable_interrupts();
+    flash_range_program(REGION_OFFSET + offset, page, FLASH_PAGE_SIZE);
+    restore_interrupts(save);
+    return true;
+}
+
+
+static const bench_store_backend_t flash_backend = {
+    .read = flash_read,
+    .erase = flash_erase,
+    .program = flash_program,
+    .ctx = NULL,
+    .sectors = BENCH_LOG_SECTORS,
+};
+#endif
+
+
+bool bench_log_init(void) {
+#if PICO_NO_FLASH
+    printf("history: no_flash build, not logging\n");
+    return false;
+#else
+    uintptr_t image_end = (uintptr_t)&__flash_binary_end;
+    if (image_end > XIP_BASE + REGION_OFFSET) {
+        printf("history: program overlaps the reserved flash, not logging\n");
+        return false;
+    }
+    build_id = bench_store_crc32((const void *)XIP_BASE, image_end - XIP_BASE);
+    enabled = bench_store_mount(&store, &flash_backend);
+    return enabled;
+#endif
+}
+
+
+bool bench_log_result(const char *scenario, uint32_t value) {
+    if (!enabled) {
+        return false;
+    }
+
+    bool regression = false;
+    bench_record_t base;
+    printf("history %s: %lu us", scenario, value);
+    if (bench_store_baseline(&store, build_id, scenario, &base)) {
+        int32_t change = bench_store_change_permille(base.value, value);
+        uint32_t mag = change < 0 ? -change : change;
+        regression = change > BENCH_LOG_THRESHOLD_PERMILLE;
+        printf(", baseline %lu us (build %08lx) %c%lu.%lu%%%s", base.value, base.build_id,
+               change < 0 ? '-' : '+', mag / 10, mag % 10, regression ? " REGRESSION" : "");
+    } else {
+        printf(", no baseline");
+    }
+    printf("\n");
+
+    if (pending_count < BENCH_LOG_PENDING) {
+        pending_t *p = &pending[pending_count++];
+        strncpy(p->scenario, scenario, BENCH_STORE_NAME_LEN);
+        p->scenario[BENCH_STORE_NAME_LEN] = '\0';
+        p->value = value;
+    }
+    return regression;
+}
+
+
+uint bench_log_commit(void) {
+    uint written = 0;
+    for (uint i = 0; enabled && i < pending_count; i++) {
+        if (bench_store_append(&store, build_id, pending[i].scenario, pending[i].value)) {
+            written++;
+        }
+    }
+    pending_count = 0;
+    return written;
+}
+
+
+static void print_record(const bench_record_t *rec, void *arg) {
+    (void)arg;
+    printf("%8lu  %08lx  %-12.12s  %10lu\n", rec->seq, rec->build_id, rec->scenario, rec->value);
+}
+
+
+void bench_log_dump(void) {
+    if (!enabled) {
+        return;
+    }
+    printf("     seq  build     scenario           value\n");
+    bench_store_foreach(&store, print_record, NULL);
+    if (store.corrupt) {
+        printf("%lu corrupt records skipped\n", store.corrupt);
+    }
+}
+
+
+uint32_t bench_log_build_id(void) {
+    return build_id;
+}
@@ -0,0 +1,199 @@
+/*****************************************************************//**
+ * \file   bench_store.c
+ * \brief  log-structured store of benchmark results in NOR flash
+ *
+ * Nothing is kept in RAM but the write position: the records are read
+ * back from the flash whenever they are needed, which is a handful of
+ * times per benchmark run.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include <string.h>
+#include <assert.h>
+#include "bench_store.h"
+
+static_assert(sizeof(bench_record_t) == 32, "records must tile a page");
+static_assert(BENCH_STORE_PAGE_SIZE % sizeof(bench_record_t) == 0, "records must tile a page");
+
+#define CRC_LEN offsetof(bench_record_t, crc)
+
+
+uint32_t bench_store_crc32(const void *data, size_t len) {
+    const uint8_t *p = data;
+    uint32_t crc = 0xffffffffu;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= p[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xedb88320u : crc >> 1;
+        }
+    }
+    return ~crc;
+}
+
+
+static uint32_t total_slots(const bench_store_t *store) {
+    return store->backend->sectors * BENCH_STORE_RECORDS_PER_SECTOR;
+}
+
+
+static bool read_slot(const bench_store_t *store, uint32_t slot, bench_record_t *rec) {
+    const bench_store_backend_t *b = store->backend;
+    return b->read(b->ctx, slot * sizeof(bench_record_t), rec, sizeof(*rec));
+}
+
+
+static bool is_blank(const bench_record_t *rec) {
+    const uint8_t *p = (const uint8_t *)rec;
+    for (size_t i = 0; i < sizeof(*rec); i++) {
+        if (p[i] != 0xff) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+static bool is_valid(const bench_record_t *rec) {
+    return rec->magic == BENCH_STORE_MAGIC && rec->crc == bench_store_crc32(rec, CRC_LEN);
+}
+
+
+static bool same_scenario(const bench_record_t *rec, const char *scenario) {
+    return strncmp(rec->scenario, scenario, BENCH_STORE_NAME_LEN) == 0;
+}
+
+
+bool bench_store_mount(bench_store_t *store, const bench_store_backend_t *backend) {
+    store->backend = backend;
+    store->next = 0;
+    store->seq = 0;
+    store->corrupt = 0;
+
+    bool found = false;
+    for (uint32_t slot = 0; slot < total_slots(store); slot++) {
+        bench_record_t rec;
+        if (!read_slot(store, slot, &rec)) {
+            return false;
+        }
+        if (is_blank(&rec)) {
+            continue;
+        }
+        if (!is_valid(&rec)) {
+            store->corrupt++;
+            continue;
+        }
+        // newest so far, the sequence number may have wrapped
+        if (!found || (int32_t)(rec.seq - store->seq) >= 0) {
+            found = true;
+            store->seq = rec.seq + 1;
+            store->next = (slot + 1) % total_slots(store);
+        }
+    }
+    return true;
+}
+
+
+bool bench_store_append(bench_store_t *store, uint32_t build_id, const char *scenario, uint32_t value) {
+    const bench_store_backend_t *b = store->backend;
+
+    bench_record_t rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.magic = BENCH_STORE_MAGIC;
+    rec.seq = store->seq;
+    rec.build_id = build_id;
+    // not NUL terminated when the name fills the field, the rest is already zero
+    memcpy(rec.scenario, scenario, strnlen(scenario, BENCH_STORE_NAME_LEN));
+    rec.value = value;
+    rec.crc = bench_store_crc32(&rec, CRC_LEN);
+
+    // a torn record in the way is stepped over, at most once round the ring
+    for (uint32_t tries = 0; tries < total_slots(store); tries++) {
+        uint32_t slot = store->next;
+        uint32_t offset = slot * sizeof(bench_record_t);
+        store->next = (slot + 1) % total_slots(store);
+
+        if (slot % BENCH_STORE_RECORDS_PER_SECTOR == 0) {
+            // first slot of a sector: it holds the oldest records, reclaim it
+            if (!b->erase(b->ctx, offset)) {
+                return false;
+            }
+        } else {
+            bench_record_t old;
+            if (!read_slot(store, slot, &old)) {
+                return false;
+            }
+            if (!is_blank(&old)) {
+                continue;
+            }
+        }
+
+        // the rest of the page stays 0xff, which programming leaves as it is
+        uint8_t page[BENCH_STORE_PAGE_SIZE];
+        uint32_t page_offset = offset & ~(BENCH_STORE_PAGE_SIZE - 1);
+        memset(page, 0xff, sizeof(page));
+        memcpy(page + (offset - page_offset), &rec, sizeof(rec));
+        if (!b->program(b->ctx, page_offset, page)) {
+            return false;
+        }
+
+        bench_record_t check;
+        if (!read_slot(store, slot, &check) || memcmp(&check, &rec, sizeof(rec)) != 0) {
+            return false;
+        }
+        store->seq++;
+        return true;
+    }
+    return false;
+}
+
+
+void bench_store_foreach(const bench_store_t *store, void (*fn)(const bench_record_t *rec, void *arg), void *arg) {
+    // the sector after the one written last holds the oldest records
+    uint32_t sectors = store->backend->sectors;
+    uint32_t last = (store->next + total_slots(store) - 1) % total_slots(store);
+    uint32_t current = last / BENCH_STORE_RECORDS_PER_SECTOR;
+    for (uint32_t i = 1; i <= sectors; i++) {
+        uint32_t first = ((current + i) % sectors) * BENCH_STORE_RECORDS_PER_SECTOR;
+        for (uint32_t slot = first; slot < first + BENCH_STORE_RECORDS_PER_SECTOR; slot++) {
+            bench_record_t rec;
+            if (read_slot(store, slot, &rec) && is_valid(&rec)) {
+                fn(&rec, arg);
+            }
+        }
+    }
+}
+
+
+typedef struct {
+    uint32_t build_id;
+    const char *scenario;
+    bench_record_t *baseline;
+    bool found;
+} baseline_search_t;
+
+
+static void find_baseline(const bench_record_t *rec, void *arg) {
+    baseline_search_t *search = arg;
+    if (rec->build_id != search->build_id && same_scenario(rec, search->scenario)) {
+        // oldest first, so the last match is the newest
+        *search->baseline = *rec;
+        search->found = true;
+    }
+}
+
+
+bool bench_store_baseline(const bench_store_t *store, uint32_t build_id, const char *scenario, bench_record_t *baseline) {
+    baseline_search_t search = {build_id, scenario, baseline, false};
+    bench_store_foreach(store, find_baseline, &search);
+    return search.found;
+}
+
+
+int32_t bench_store_change_permille(uint32_t baseline, uint32_t value) {
+    if (baseline == 0) {
+        return 0;
+    }
+    return (int32_t)(((int64_t)value - baseline) * 1000 / baseline);
+}
@@ -0,0 +1,100 @@
+/*****************************************************************//**
+ * \file   bench_log.h
+ * \brief  benchmark history kept in flash, with regression checks
+ *
+ * Results are stored by bench_store.h in the last BENCH_LOG_SECTORS
+ * sectors of flash, keyed by scenario and by a build ID (the CRC-32
+ * of the program image, so any change to the firmware is a new
+ * build). Each new result is compared against the newest one of the
+ * same scenario from a different build, and flagged as a regression
+ * if it is more than BENCH_LOG_THRESHOLD_PERMILLE slower.
+ *
+ * Writing to flash stops XIP, so the results are only queued by
+ * bench_log_result() and written by bench_log_commit(), which has to
+ * be called with the other core stopped (or running from RAM).
+ *
+ * The history survives reflashing as long as the program stays clear
+ * of the reserved sectors. Read it on the host with
+ *
+ *   picotool save -r 0x101f8000 0x10200000 history.bin
+ *   bench_history dump history.bin
+ *
+ * (the range for a 2 MB flash and 8 sectors), see tools/host/bench_history.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#ifndef BENCH_LOG_H
+#define BENCH_LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/types.h"
+#include "bench_store.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// sectors at the end of flash given to the history
+#ifndef BENCH_LOG_SECTORS
+#define BENCH_LOG_SECTORS 8
+#endif
+
+// slowdown against the baseline that counts as a regression, in tenths of a percent
+#ifndef BENCH_LOG_THRESHOLD_PERMILLE
+#define BENCH_LOG_THRESHOLD_PERMILLE 50
+#endif
+
+// results queued between commits
+#define BENCH_LOG_PENDING 16
+
+
+/**
+ * @brief hash the program image and find the end of the history
+ *
+ * @return false if the program overlaps the reserved sectors or is a no_flash build,
+ *         the log then stays off
+ */
+bool bench_log_init(void);
+
+
+/**
+ * @brief compare a result with its baseline, print the comparison and queue it for bench_log_commit()
+ *
+ *   history s1 float: 1650122 us, baseline 1649870 us (build 5e1c03a7) +0.0%
+ *
+ * @param scenario name, up to BENCH_STORE_NAME_LEN characters
+ * @param value result, smaller is better
+ * @return true if it is a regression
+ */
+bool bench_log_result(const char *scenario, uint32_t value);
+
+
+/**
+ * @brief write the queued results to flash
+ *
+ * disables interrupts for each sector erase and page program
+ *
+ * @return number of results written
+ */
+uint bench_log_commit(void);
+
+
+/**
+ * @brief print every stored result, oldest first
+ */
+void bench_log_dump(void);
+
+
+/**
+ * @brief build ID of the running firmware
+ */
+uint32_t bench_log_build_id(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BENCH_LOG_H
@@ -0,0 +1,129 @@
+/*****************************************************************//**
+ * \file   bench_store.h
+ * \brief  log-structured store of benchmark results in NOR flash
+ *
+ * Shared by the firmware and the host tool, so nothing in here
+ * depends on the Pico SDK; the flash itself is reached through a
+ * bench_store_backend_t (the Pico flash in bench_log.c, a simulated
+ * NOR array in tools/host/bench_history).
+ *
+ * The store is a ring of erase sectors filled with fixed size records
+ * in order. Appending never rewrites a record: when the write position
+ * reaches the end of a sector the next sector, holding the oldest
+ * records, is erased and reused, so every sector is erased once per
+ * trip round the ring. A record is programmed in one go and carries a
+ * CRC-32, so one torn by a power cut fails the check and is skipped.
+ *
+ *   offset  size  field
+ *   0       4     BENCH_STORE_MAGIC
+ *   4       4     sequence number, one more than the record before
+ *   8       4     build ID of the firmware that wrote it
+ *   12      12    scenario name, zero padded
+ *   24      4     result, smaller is better (a time in us, say)
+ *   28      4     CRC-32 of bytes 0 to 27
+ *
+ * Fields are little endian, as on both ends.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#ifndef BENCH_STORE_H
+#define BENCH_STORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BENCH_STORE_MAGIC       0x4c484342u     // "BCHL"
+#define BENCH_STORE_SECTOR_SIZE 4096u
+#define BENCH_STORE_PAGE_SIZE   256u            // programming granularity
+#define BENCH_STORE_NAME_LEN    12
+
+
+typedef struct {
+    uint32_t magic;
+    uint32_t seq;
+    uint32_t build_id;
+    char scenario[BENCH_STORE_NAME_LEN];
+    uint32_t value;
+    uint32_t crc;
+} bench_record_t;
+
+#define BENCH_STORE_RECORDS_PER_SECTOR (BENCH_STORE_SECTOR_SIZE / sizeof(bench_record_t))
+
+
+/**
+ * @brief access to the flash holding the store, offsets are from its start
+ *
+ * erase() sets a whole sector to 0xff, program() writes whole pages
+ * and can only clear bits, as NOR flash does
+ */
+typedef struct {
+    bool (*read)(void *ctx, uint32_t offset, void *buf, uint32_t len);
+    bool (*erase)(void *ctx, uint32_t offset);
+    bool (*program)(void *ctx, uint32_t offset, const void *page);
+    void *ctx;
+    uint32_t sectors;           // at least 2
+} bench_store_backend_t;
+
+
+typedef struct {
+    const bench_store_backend_t *backend;
+    uint32_t next;              // slot the next record goes to
+    uint32_t seq;               // sequence number of the next record
+    uint32_t corrupt;           // slots found neither blank nor valid by the mount
+} bench_store_t;
+
+
+/**
+ * @brief CRC-32 (IEEE 802.3, reflected, poly 0xedb88320)
+ */
+uint32_t bench_store_crc32(const void *data, size_t len);
+
+
+/**
+ * @brief scan the flash and find where the next record goes
+ *
+ * @return false if the backend failed
+ */
+bool bench_store_mount(bench_store_t *store, const bench_store_backend_t *backend);
+
+
+/**
+ * @brief append one result, erasing the oldest sector when the ring wraps
+ *
+ * @param scenario name, truncated to BENCH_STORE_NAME_LEN
+ * @return false if the backend failed
+ */
+bool bench_store_append(bench_store_t *store, uint32_t build_id, const char *scenario, uint32_t value);
+
+
+/**
+ * @brief call fn for every valid record, oldest first
+ */
+void bench_store_foreach(const bench_store_t *store, void (*fn)(const bench_record_t *rec, void *arg), void *arg);
+
+
+/**
+ * @brief the newest result for a scenario written by a build other than build_id
+ *
+ * @return false if there is none
+ */
+bool bench_store_baseline(const bench_store_t *store, uint32_t build_id, const char *scenario, bench_record_t *baseline);
+
+
+/**
+ * @brief change from a baseline in tenths of a percent, positive if value is slower
+ */
+int32_t bench_store_change_permille(uint32_t baseline, uint32_t value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BENCH_STORE_H
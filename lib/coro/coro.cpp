@@ -0,0 +1,256 @@
+/*****************************************************************//**
+ * \file   coro.cpp
+ * \brief  cooperative C++20 coroutine scheduler
+ *
+ * Timers are only touched from run(), so they need no locking. The
+ * ready queue is also fed from the GPIO and FIFO interrupts and is
+ * updated with interrupts disabled. The alarm callback does nothing:
+ * taking the interrupt is enough to wake run() from idle_wait().
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include "coro.hpp"
+#include "idle.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+
+static_assert(CORO_MAX_FRAMES <= 32, "the frame pool is tracked in one 32 bit mask");
+
+namespace coro {
+
+namespace {
+
+alignas(8) uint8_t frames[CORO_MAX_FRAMES][CORO_FRAME_SIZE];
+uint32_t frames_used;
+frame_stats stats;
+
+scheduler schedulers[NUM_CORES];
+
+// tasks can be started from either core
+spin_lock_t* pool_lock() {
+    return spin_lock_instance(PICO_SPINLOCK_ID_OS1);
+}
+
+uint sio_irq() {
+    return SIO_IRQ_PROC0 + get_core_num();
+}
+
+} // namespace
+
+
+void* task::promise_type::operator new(size_t size) noexcept {
+    uint32_t save = spin_lock_blocking(pool_lock());
+    void* frame = nullptr;
+    if (size > stats.largest) {
+        stats.largest = size;
+    }
+    if (size <= CORO_FRAME_SIZE) {
+        for (uint i = 0; i < CORO_MAX_FRAMES; i++) {
+            if (!(frames_used & (1u << i))) {
+                frames_used |= 1u << i;
+                stats.in_use++;
+                frame = frames[i];
+                break;
+            }
+        }
+    }
+    if (!frame) {
+        stats.failed++;
+    }
+    spin_unlock(pool_lock(), save);
+    return frame;
+}
+
+
+void task::promise_type::operator delete(void* frame, size_t size) noexcept {
+    (void)size;
+    uint i = (static_cast<uint8_t*>(frame) - &frames[0][0]) / CORO_FRAME_SIZE;
+    uint32_t save = spin_lock_blocking(pool_lock());
+    frames_used &= ~(1u << i);
+    stats.in_use--;
+    spin_unlock(pool_lock(), save);
+}
+
+
+frame_stats get_frame_stats() {
+    uint32_t save = spin_lock_blocking(pool_lock());
+    frame_stats s = stats;
+    spin_unlock(pool_lock(), save);
+    return s;
+}
+
+
+scheduler& scheduler::current() {
+    return schedulers[get_core_num()];
+}
+
+
+bool scheduler::spawn(task t) {
+    task_node* n = t.release();
+    if (!n) {
+        return false;
+    }
+    live_++;
+    make_ready(n);
+    return true;
+}
+
+
+void scheduler::make_ready(task_node* n) {
+    uint32_t save = save_and_disable_interrupts();
+    n->next = nullptr;
+    if (ready_tail_) {
+        ready_tail_->next = n;
+    } else {
+        ready_head_ = n;
+    }
+    ready_tail_ = n;
+    restore_interrupts(save);
+}
+
+
+task_node* scheduler::pop_ready() {
+    uint32_t save = save_and_disable_interrupts();
+    task_node* n = ready_head_;
+    if (n) {
+        ready_head_ = n->next;
+        if (!ready_head_) {
+            ready_tail_ = nullptr;
+        }
+    }
+    restore_interrupts(save);
+    return n;
+}
+
+
+void scheduler::add_timer(task_node* n) {
+    task_node** p = &timers_;
+    while (*p && absolute_time_diff_us((*p)->wake, n->wake) >= 0) {
+        p = &(*p)->next;
+    }
+    n->next = *p;
+    *p = n;
+}
+
+
+void scheduler::wake_timers() {
+    while (timers_ && time_reached(timers_->wake)) {
+        task_node* n = timers_;
+        timers_ = n->next;
+        make_ready(n);
+    }
+}
+
+
+void scheduler::run() {
+    if (alarm_ < 0) {
+        // the alarm interrupt is enabled on the core that sets the callback
+        alarm_ = hardware_alarm_claim_unused(true);
+        hardware_alarm_set_callback(alarm_, alarm_callback);
+    }
+
+    while (live_) {
+        wake_timers();
+
+        task_node* n = pop_ready();
+        if (n) {
+            switches_++;
+            n->handle.resume();
+            if (n->handle.done()) {
+                n->handle.destroy();
+                live_--;
+            }
+            continue;
+        }
+
+        // nothing to run, sleep until the earliest deadline or an event
+        if (timers_ && hardware_alarm_set_target(alarm_, timers_->wake)) {
+            continue; // deadline already passed
+        }
+        // an interrupt between the checks above and here still wakes idle_wait()
+        idle_wait();
+    }
+    hardware_alarm_cancel(alarm_);
+}
+
+
+void scheduler::alarm_callback(uint alarm_num) {
+    (void)alarm_num;
+}
+
+
+void scheduler::wait_gpio(task_node* n, uint pin, uint32_t events) {
+    hard_assert(gpio_waiters_[pin] == nullptr);
+
+    if (!gpio_installed_) {
+        irq_add_shared_handler(IO_IRQ_BANK0, gpio_isr, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(IO_IRQ_BANK0, true);
+        gpio_installed_ = true;
+    }
+
+    gpio_pins_ |= 1u << pin;
+    gpio_waiters_[pin] = n;
+
+    // wait for the next edge, not one left over from before
+    gpio_acknowledge_irq(pin, events);
+    gpio_set_irq_enabled(pin, events, true);
+}
+
+
+void scheduler::gpio_isr() {
+    scheduler& s = current();
+    for (uint pin = 0; pin < NUM_BANK0_GPIOS; pin++) {
+        if (!(s.gpio_pins_ & (1u << pin))) {
+            continue;
+        }
+        uint32_t events = gpio_get_irq_event_mask(pin) & (GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL);
+        if (!events || !s.gpio_waiters_[pin]) {
+            continue;
+        }
+        // one-shot, the next co_await re-enables the pin
+        gpio_acknowledge_irq(pin, events);
+        gpio_set_irq_enabled(pin, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, false);
+
+        task_node* n = s.gpio_waiters_[pin];
+        s.gpio_waiters_[pin] = nullptr;
+        n->value = events;
+        s.make_ready(n);
+    }
+}
+
+
+void scheduler::wait_fifo(task_node* n) {
+    hard_assert(fifo_waiter_ == nullptr);
+
+    if (!fifo_installed_) {
+        irq_set_exclusive_handler(sio_irq(), fifo_isr);
+        fifo_installed_ = true;
+    }
+    fifo_waiter_ = n;
+
+    // the interrupt is level triggered on valid data, so a word that already arrived fires at once
+    irq_set_enabled(sio_irq(), true);
+}
+
+
+void scheduler::fifo_isr() {
+    scheduler& s = current();
+    multicore_fifo_clear_irq();
+
+    if (s.fifo_waiter_ && multicore_fifo_rvalid()) {
+        task_node* n = s.fifo_waiter_;
+        s.fifo_waiter_ = nullptr;
+        n->value = multicore_fifo_pop_blocking();
+        s.make_ready(n);
+    }
+    if (!s.fifo_waiter_) {
+        // leave further words in the FIFO for the next co_await
+        irq_set_enabled(sio_irq(), false);
+    }
+}
+
+} // namespace coro
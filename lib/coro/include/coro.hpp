@@ -0,0 +1,268 @@
+/*****************************************************************//**
+ * \file   coro.hpp
+ * \brief  cooperative C++20 coroutine scheduler
+ *
+ * A coro::task is a stackless coroutine: its locals live in a small
+ * frame taken from a static pool rather than on a stack of its own,
+ * so many periodic activities can share one core for a few dozen bytes
+ * each. Tasks give up the core only at co_await, on one of:
+ *
+ *   coro::delay_ms / delay_us / delay_until   resume at a time
+ *   coro::gpio_edge                           resume on a GPIO edge
+ *   coro::fifo_pop                            resume with the next inter-core FIFO word
+ *   coro::yield                               let the other ready tasks run
+ *
+ * Each core has its own scheduler. scheduler::run() is tickless: with
+ * nothing ready it programs one hardware alarm for the earliest
+ * deadline and sleeps in idle_wait() (lib/idle), so an idle core takes
+ * no interrupts between events and its idle time is accounted.
+ *
+ * The FIFO awaitable owns the calling core's SIO FIFO interrupt, so it
+ * can't be combined with multicore_lockout on that core. GPIO edges
+ * are delivered by a shared IO_IRQ_BANK0 handler on the core that
+ * waits for them.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#ifndef CORO_HPP
+#define CORO_HPP
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+
+// frames in the static pool, at most 32
+#ifndef CORO_MAX_FRAMES
+#define CORO_MAX_FRAMES 8
+#endif
+
+// bytes per frame, a coroutine with a larger frame fails to start
+#ifndef CORO_FRAME_SIZE
+#define CORO_FRAME_SIZE 128
+#endif
+
+namespace coro {
+
+/**
+ * @brief scheduler bookkeeping for one task, part of its promise
+ */
+struct task_node {
+    std::coroutine_handle<> handle;
+    task_node* next = nullptr;      // ready queue or timer list
+    absolute_time_t wake;           // deadline while on the timer list
+    uint32_t value = 0;             // handed over by the event that resumed the task
+};
+
+
+/**
+ * @brief return type of a coroutine the scheduler can run
+ *
+ * owns the coroutine until it is handed to scheduler::spawn()
+ */
+class task {
+public:
+    struct promise_type : task_node {
+        task get_return_object() noexcept {
+            handle = std::coroutine_handle<promise_type>::from_promise(*this);
+            return task(this);
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { panic("coro: unhandled exception"); }
+
+        // frames come from the static pool, a task that doesn't fit comes back empty
+        static void* operator new(size_t size) noexcept;
+        static void operator delete(void* frame, size_t size) noexcept;
+        static task get_return_object_on_allocation_failure() noexcept { return task(nullptr); }
+    };
+
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    task(task&& other) noexcept : node_(std::exchange(other.node_, nullptr)) {}
+    task(const task&) = delete;
+    task& operator=(const task&) = delete;
+    task& operator=(task&&) = delete;
+    ~task() {
+        if (node_) {
+            node_->handle.destroy();
+        }
+    }
+
+    /**
+     * @brief false if the frame pool had no room for the coroutine
+     */
+    explicit operator bool() const { return node_ != nullptr; }
+
+    task_node* release() { return std::exchange(node_, nullptr); }
+
+private:
+    explicit task(task_node* node) : node_(node) {}
+
+    task_node* node_;
+};
+
+
+/**
+ * @brief runs the tasks of one core
+ */
+class scheduler {
+public:
+    /**
+     * @brief the calling core's scheduler
+     */
+    static scheduler& current();
+
+    /**
+     * @brief queue a task to run on this scheduler
+     *
+     * @return false if the task is empty because its frame didn't fit in the pool
+     */
+    bool spawn(task t);
+
+    /**
+     * @brief run tasks until all of them have finished, must be called on the scheduler's core
+     */
+    void run();
+
+    /**
+     * @brief tasks resumed so far
+     */
+    uint32_t switches() const { return switches_; }
+
+    /**
+     * @brief tasks spawned and not yet finished
+     */
+    uint32_t live() const { return live_; }
+
+    // used by the awaitables
+    void make_ready(task_node* n);
+    void add_timer(task_node* n);
+    void wait_gpio(task_node* n, uint pin, uint32_t events);
+    void wait_fifo(task_node* n);
+
+private:
+    task_node* pop_ready();
+    void wake_timers();
+
+    static void alarm_callback(uint alarm_num);
+    static void gpio_isr();
+    static void fifo_isr();
+
+    task_node* ready_head_ = nullptr;
+    task_node* ready_tail_ = nullptr;
+    task_node* timers_ = nullptr;           // sorted by deadline
+    task_node* gpio_waiters_[NUM_BANK0_GPIOS] = {};
+    task_node* fifo_waiter_ = nullptr;
+    uint32_t gpio_pins_ = 0;                // pins a task has waited on
+    bool gpio_installed_ = false;
+    bool fifo_installed_ = false;
+    int alarm_ = -1;
+    uint32_t switches_ = 0;
+    uint32_t live_ = 0;
+};
+
+
+/**
+ * @brief frame pool usage, to size CORO_MAX_FRAMES and CORO_FRAME_SIZE
+ */
+struct frame_stats {
+    uint32_t in_use;
+    uint32_t largest;   // largest frame requested so far, in bytes
+    uint32_t failed;    // coroutines that didn't fit
+};
+
+frame_stats get_frame_stats();
+
+
+/**
+ * @brief resume at an absolute time
+ */
+class delay_until {
+public:
+    explicit delay_until(absolute_time_t t) : t_(t) {}
+
+    bool await_ready() const noexcept { return time_reached(t_); }
+    void await_suspend(task::handle_type h) const noexcept {
+        h.promise().wake = t_;
+        scheduler::current().add_timer(&h.promise());
+    }
+    void await_resume() const noexcept {}
+
+private:
+    absolute_time_t t_;
+};
+
+inline delay_until delay_us(uint64_t us) {
+    return delay_until(make_timeout_time_us(us));
+}
+
+inline delay_until delay_ms(uint32_t ms) {
+    return delay_until(make_timeout_time_ms(ms));
+}
+
+
+/**
+ * @brief resume on the next edge of a GPIO
+ *
+ * co_await gives the GPIO_IRQ_EDGE_* events that fired
+ */
+class gpio_edge {
+public:
+    gpio_edge(uint pin, uint32_t events) : pin_(pin), events_(events) {}
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(task::handle_type h) noexcept {
+        node_ = &h.promise();
+        scheduler::current().wait_gpio(node_, pin_, events_);
+    }
+    uint32_t await_resume() const noexcept { return node_->value; }
+
+private:
+    uint pin_;
+    uint32_t events_;
+    task_node* node_ = nullptr;
+};
+
+
+/**
+ * @brief resume with the next word from the other core's FIFO
+ */
+class fifo_pop {
+public:
+    bool await_ready() noexcept {
+        if (multicore_fifo_rvalid()) {
+            value_ = multicore_fifo_pop_blocking();
+            return true;
+        }
+        return false;
+    }
+    void await_suspend(task::handle_type h) noexcept {
+        node_ = &h.promise();
+        scheduler::current().wait_fifo(node_);
+    }
+    uint32_t await_resume() const noexcept { return node_ ? node_->value : value_; }
+
+private:
+    uint32_t value_ = 0;
+    task_node* node_ = nullptr;
+};
+
+
+/**
+ * @brief go to the back of the ready queue
+ */
+struct yield {
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(task::handle_type h) const noexcept { scheduler::current().make_ready(&h.promise()); }
+    void await_resume() const noexcept {}
+};
+
+} // namespace coro
+
+#endif // CORO_HPP
@@ -0,0 +1,61 @@
+/*****************************************************************//**
+ * \file   cycle_counter.h
+ * \brief  processor cycle counting using the SysTick timer
+ *
+ * The Cortex-M0+ has no DWT cycle counter, so SysTick is run from
+ * the processor clock with the full 24 bit reload value and read as
+ * a free running down-counter. It wraps every 2^24 cycles (~134 ms
+ * at 125 MHz), so only intervals shorter than that can be measured.
+ *
+ * Each core has its own SysTick, so cycle_counter_init() has to be
+ * called on every core that takes measurements. The helpers are forced
+ * inline so they stay in RAM code at -O0 too, e.g. while XIP is off.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#ifndef CYCLE_COUNTER_H
+#define CYCLE_COUNTER_H
+
+#include <stdint.h>
+#include "hardware/structs/systick.h"
+#include "hardware/regs/m0plus.h"
+
+// mask for the 24 bit SysTick counter
+#define CYCLE_COUNTER_MASK M0PLUS_SYST_RVR_RELOAD_BITS
+
+
+/**
+ * @brief start SysTick free running from the processor clock on the calling core
+ */
+__force_inline static void cycle_counter_init(void) {
+    systick_hw->csr = 0;
+    systick_hw->rvr = CYCLE_COUNTER_MASK;
+    systick_hw->cvr = 0; // any write clears the counter
+    systick_hw->csr = M0PLUS_SYST_CSR_CLKSOURCE_BITS | M0PLUS_SYST_CSR_ENABLE_BITS;
+}
+
+
+/**
+ * @brief take a snapshot of the counter
+ *
+ * @return uint32_t the raw (down-counting) SysTick value
+ */
+__force_inline static uint32_t cycle_counter_read(void) {
+    return systick_hw->cvr;
+}
+
+
+/**
+ * @brief number of cycles between two snapshots
+ *
+ * @param start snapshot taken first
+ * @param end snapshot taken second
+ * @return uint32_t elapsed cycles, modulo 2^24
+ */
+__force_inline static uint32_t cycle_counter_elapsed(uint32_t start, uint32_t end) {
+    return (start - end) & CYCLE_COUNTER_MASK;
+}
+
+#endif // CYCLE_COUNTER_H
@@ -0,0 +1,91 @@
+/*****************************************************************//**
+ * \file   deferred.c
+ * \brief  deferred work (bottom halves) run from PendSV
+ *
+ * Handlers at different priorities can preempt each other in the
+ * middle of queueing, so the queues are only touched with interrupts
+ * disabled; that is a handful of instructions for each push and pop.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include <assert.h>
+#include "deferred.h"
+#include "pico/stdlib.h"
+#include "hardware/exception.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "hardware/structs/scb.h"
+
+#define QUEUE_MASK (DEFERRED_QUEUE_SIZE - 1)
+
+static_assert((DEFERRED_QUEUE_SIZE & QUEUE_MASK) == 0, "DEFERRED_QUEUE_SIZE must be a power of two");
+
+typedef struct {
+    deferred_fn_t fn;
+    uint32_t arg;
+} deferred_item_t;
+
+typedef struct {
+    deferred_item_t items[DEFERRED_LEVELS][DEFERRED_QUEUE_SIZE];
+    uint32_t head[DEFERRED_LEVELS];     // free running counts
+    uint32_t tail[DEFERRED_LEVELS];
+    uint32_t dropped;
+} deferred_core_t;
+
+static deferred_core_t cores[NUM_CORES];
+
+
+/**
+ * @brief run queued items until every queue of this core is empty
+ */
+static void deferred_pendsv(void) {
+    deferred_core_t *c = &cores[get_core_num()];
+    while (true) {
+        deferred_item_t item;
+        uint32_t save = save_and_disable_interrupts();
+        uint level = 0;
+        while (level < DEFERRED_LEVELS && c->head[level] == c->tail[level]) {
+            level++;
+        }
+        if (level == DEFERRED_LEVELS) {
+            restore_interrupts(save);
+            return;
+        }
+        item = c->items[level][c->tail[level]++ & QUEUE_MASK];
+        restore_interrupts(save);
+
+        item.fn(item.arg);
+    }
+}
+
+
+void deferred_init(void) {
+    // the vector table is shared, the priority registers are per core
+    exception_set_exclusive_handler(PENDSV_EXCEPTION, deferred_pendsv);
+    exception_set_priority(PENDSV_EXCEPTION, PICO_LOWEST_IRQ_PRIORITY);
+}
+
+
+bool deferred_queue(uint level, deferred_fn_t fn, uint32_t arg) {
+    hard_assert(level < DEFERRED_LEVELS);
+    deferred_core_t *c = &cores[get_core_num()];
+    uint32_t save = save_and_disable_interrupts();
+    if (c->head[level] - c->tail[level] == DEFERRED_QUEUE_SIZE) {
+        c->dropped++;
+        restore_interrupts(save);
+        return false;
+    }
+    c->items[level][c->head[level]++ & QUEUE_MASK] = (deferred_item_t){fn, arg};
+    restore_interrupts(save);
+
+    // taken once no other handler is active
+    scb_hw->icsr = M0PLUS_ICSR_PENDSVSET_BITS;
+    return true;
+}
+
+
+uint32_t deferred_dropped(void) {
+    return cores[get_core_num()].dropped;
+}
@@ -0,0 +1,74 @@
+/*****************************************************************//**
+ * \file   deferred.h
+ * \brief  deferred work (bottom halves) run from PendSV
+ *
+ * Interrupt handlers do the time critical part of their work and hand
+ * the rest (printing, telemetry, anything slow) to deferred_queue().
+ * Queued items run from the PendSV exception, which is set to the
+ * lowest priority, so every interrupt can preempt them and a slow
+ * item never delays an interrupt.
+ *
+ * Each core has its own queues, one per level. Items run in level
+ * order, level 0 first, and in queueing order within a level. They
+ * don't preempt each other: an item queued at level 0 while a level 3
+ * item is running runs as soon as that item returns.
+ *
+ * Interrupt priorities on the Cortex-M0+ are the top two bits of a
+ * byte, so the distinct levels are 0x00 (highest), 0x40, 0x80 (the
+ * SDK default) and 0xc0 (PendSV here).
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#ifndef DEFERRED_H
+#define DEFERRED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// number of levels, 0 runs first
+#define DEFERRED_LEVELS 4
+
+// items per level per core, must be a power of two
+#ifndef DEFERRED_QUEUE_SIZE
+#define DEFERRED_QUEUE_SIZE 16
+#endif
+
+typedef void (*deferred_fn_t)(uint32_t arg);
+
+
+/**
+ * @brief install the PendSV handler and give PendSV the lowest priority on the calling core
+ *
+ * call once on each core that queues work
+ */
+void deferred_init(void);
+
+
+/**
+ * @brief queue fn(arg) to run from PendSV on the calling core, safe from any interrupt handler
+ *
+ * @param level 0 to DEFERRED_LEVELS - 1, lower levels run first
+ * @param fn function to run
+ * @param arg passed to fn
+ * @return false if the level's queue was full and the item was dropped
+ */
+bool deferred_queue(uint level, deferred_fn_t fn, uint32_t arg);
+
+
+/**
+ * @brief items dropped on the calling core because their queue was full
+ */
+uint32_t deferred_dropped(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DEFERRED_H
@@ -0,0 +1,155 @@
+/*****************************************************************//**
+ * \file   dfloat.hpp
+ * \brief  double-float (float-float) arithmetic type
+ *
+ * A dfloat holds an unevaluated sum hi + lo of two single precision
+ * floats, giving roughly 44 bits of significand. Every operation is
+ * built from error-free transformations (TwoSum / TwoProd) over plain
+ * float arithmetic, so on the RP2040 it runs entirely on the
+ * ROM-accelerated single precision routines pulled in by pico_float.
+ *
+ * The Cortex-M0+ has no FMA, so TwoProd uses Dekker's splitting.
+ * None of this survives -ffast-math (the compiler would fold the
+ * error terms away), so don't build users of this header with it.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#ifndef DFLOAT_HPP
+#define DFLOAT_HPP
+
+#include <cstdint>
+#include <type_traits>
+
+
+namespace dfloat_detail {
+
+// 2^12 + 1, splits a 24 bit float significand into two 12 bit halves
+constexpr float SPLITTER = 4097.0f;
+
+/**
+ * @brief error-free sum, s + err == a + b exactly (Knuth)
+ */
+constexpr void two_sum(float a, float b, float& s, float& err) {
+    s = a + b;
+    float bb = s - a;
+    err = (a - (s - bb)) + (b - bb);
+}
+
+/**
+ * @brief error-free sum, requires |a| >= |b| (Dekker)
+ */
+constexpr void quick_two_sum(float a, float b, float& s, float& err) {
+    s = a + b;
+    err = b - (s - a);
+}
+
+/**
+ * @brief splits a into hi + lo, each fitting in half a significand
+ */
+constexpr void split(float a, float& hi, float& lo) {
+    float t = SPLITTER * a;
+    hi = t - (t - a);
+    lo = a - hi;
+}
+
+/**
+ * @brief error-free product, p + err == a * b exactly (Dekker)
+ */
+constexpr void two_prod(float a, float b, float& p, float& err) {
+    float a_hi = 0.0f, a_lo = 0.0f, b_hi = 0.0f, b_lo = 0.0f;
+    p = a * b;
+    split(a, a_hi, a_lo);
+    split(b, b_hi, b_lo);
+    err = ((a_hi * b_hi - p) + a_hi * b_lo + a_lo * b_hi) + a_lo * b_lo;
+}
+
+} // namespace dfloat_detail
+
+
+/**
+ * @brief double-float number, value is hi + lo with |lo| <= ulp(hi) / 2
+ */
+struct dfloat {
+    float hi;
+    float lo;
+
+    constexpr dfloat() : hi(0.0f), lo(0.0f) {}
+    constexpr dfloat(float h) : hi(h), lo(0.0f) {}
+    constexpr dfloat(float h, float l) : hi(h), lo(l) {}
+
+    /**
+     * @brief exact conversion from an integer of up to 48 bits
+     *
+     * the part that doesn't fit in hi is carried in lo, so loop
+     * counters beyond 2^24 still convert without rounding
+     */
+    template <typename I, typename = std::enable_if_t<std::is_integral_v<I>>>
+    constexpr dfloat(I v) : hi(0.0f), lo(0.0f) {
+        int64_t x = static_cast<int64_t>(v);
+        hi = static_cast<float>(x);
+        lo = static_cast<float>(x - static_cast<int64_t>(hi));
+    }
+
+    explicit constexpr operator float() const { return hi + lo; }
+    explicit constexpr operator double() const {
+        return static_cast<double>(hi) + static_cast<double>(lo);
+    }
+
+    constexpr dfloat& operator+=(const dfloat& b);
+    constexpr dfloat& operator-=(const dfloat& b);
+    constexpr dfloat& operator*=(const dfloat& b);
+    constexpr dfloat& operator/=(const dfloat& b);
+};
+
+
+constexpr dfloat operator-(const dfloat& a) {
+    return dfloat(-a.hi, -a.lo);
+}
+
+constexpr dfloat operator+(const dfloat& a, const dfloat& b) {
+    float s = 0.0f, e = 0.0f, t = 0.0f, f = 0.0f;
+    dfloat_detail::two_sum(a.hi, b.hi, s, e);
+    dfloat_detail::two_sum(a.lo, b.lo, t, f);
+    e += t;
+    dfloat_detail::quick_two_sum(s, e, s, e);
+    e += f;
+    dfloat_detail::quick_two_sum(s, e, s, e);
+    return dfloat(s, e);
+}
+
+constexpr dfloat operator-(const dfloat& a, const dfloat& b) {
+    return a + (-b);
+}
+
+constexpr dfloat operator*(const dfloat& a, const dfloat& b) {
+    float p = 0.0f, e = 0.0f;
+    dfloat_detail::two_prod(a.hi, b.hi, p, e);
+    e += a.hi * b.lo + a.lo * b.hi;
+    dfloat_detail::quick_two_sum(p, e, p, e);
+    return dfloat(p, e);
+}
+
+/**
+ * @brief long division, three single precision quotient digits
+ *
+ * each step divides the running remainder by b.hi only; the
+ * remainder itself is formed exactly with the full divisor
+ */
+constexpr dfloat operator/(const dfloat& a, const dfloat& b) {
+    float q1 = a.hi / b.hi;
+    dfloat r = a - b * dfloat(q1);
+    float q2 = r.hi / b.hi;
+    r -= b * dfloat(q2);
+    float q3 = r.hi / b.hi;
+    dfloat_detail::quick_two_sum(q1, q2, q1, q2);
+    return dfloat(q1, q2) + dfloat(q3);
+}
+
+constexpr dfloat& dfloat::operator+=(const dfloat& b) { return *this = *this + b; }
+constexpr dfloat& dfloat::operator-=(const dfloat& b) { return *this = *this - b; }
+constexpr dfloat& dfloat::operator*=(const dfloat& b) { return *this = *this * b; }
+constexpr dfloat& dfloat::operator/=(const dfloat& b) { return *this = *this / b; }
+
+#endif // DFLOAT_HPP
@@ -0,0 +1,629 @@
+/*****************************************************************//**
+ * \file   fixed_mem.hpp
+ * \brief  fixed-capacity containers and arenas, no heap
+ *
+ * Everything here lives in storage sized at compile time, either
+ * inside the object or in a buffer handed over, so a subsystem's
+ * memory shows up in .bss and the link map rather than in newlib's
+ * heap, and can't fragment:
+ *
+ *   fixed_mem::static_vector<T, N>     vector of at most N elements
+ *   fixed_mem::ring<T, N>              FIFO of at most N elements
+ *   fixed_mem::intrusive_list<T, &T::link>  doubly linked list through a member
+ *   fixed_mem::min_heap<T, N, Less>    priority queue, smallest first
+ *   fixed_mem::bump_arena              allocate by moving a pointer, free by rewinding it
+ *   fixed_mem::pool<T, N>              free list of N blocks of one type
+ *   fixed_mem::per_core<T>             one T per core
+ *
+ * Nothing throws or allocates: a container that is full refuses the
+ * element (push returns false, emplace nullptr) and an arena that is
+ * out of room returns nullptr and counts the failure. The arenas keep
+ * their high-water mark, so their sizes can be set from a real run.
+ *
+ * None of it is thread or interrupt safe. Give each core its own
+ * arena with per_core and don't share a container with a handler
+ * without masking it.
+ *
+ * C++17 and no SDK calls outside per_core::local(), so it builds on
+ * the host too, see tools/host/fixed_mem_bench.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#ifndef FIXED_MEM_HPP
+#define FIXED_MEM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if PICO_ON_DEVICE
+#include "pico/platform.h"
+#endif
+
+namespace fixed_mem {
+
+/**
+ * @brief usage of an arena, in bytes or blocks
+ */
+struct arena_stats {
+    size_t capacity;
+    size_t used;
+    size_t high_water;
+    uint32_t failures;      // allocations refused for lack of room
+};
+
+
+/**
+ * @brief uninitialised room for N objects of type T
+ */
+template <typename T, size_t N>
+class slots {
+public:
+    T* get(size_t i) { return std::launder(reinterpret_cast<T*>(bytes_ + i * sizeof(T))); }
+    const T* get(size_t i) const { return std::launder(reinterpret_cast<const T*>(bytes_ + i * sizeof(T))); }
+    void* raw(size_t i) { return bytes_ + i * sizeof(T); }
+
+private:
+    alignas(T) unsigned char bytes_[N * sizeof(T)];
+};
+
+
+/**
+ * @brief vector with the elements stored inline, at most N of them
+ */
+template <typename T, size_t N>
+class static_vector {
+public:
+    static_vector() = default;
+    static_vector(const static_vector&) = delete;
+    static_vector& operator=(const static_vector&) = delete;
+    ~static_vector() { clear(); }
+
+    /**
+     * @return the new element, or nullptr if the vector is full
+     */
+    template <typename... Args>
+    T* emplace_back(Args&&... args) {
+        if (size_ == N) {
+            return nullptr;
+        }
+        return new (slots_.raw(size_++)) T(std::forward<Args>(args)...);
+    }
+
+    bool push_back(const T& value) { return emplace_back(value) != nullptr; }
+    bool push_back(T&& value) { return emplace_back(std::move(value)) != nullptr; }
+
+    void pop_back() { slots_.get(--size_)->~T(); }
+
+    /**
+     * @brief remove element i, keeping the order of the rest
+     */
+    void erase(size_t i) {
+        for (; i + 1 < size_; i++) {
+            *slots_.get(i) = std::move(*slots_.get(i + 1));
+        }
+        pop_back();
+    }
+
+    /**
+     * @brief remove element i by moving the last element into its place
+     */
+    void swap_erase(size_t i) {
+        if (i + 1 < size_) {
+            *slots_.get(i) = std::move(*slots_.get(size_ - 1));
+        }
+        pop_back();
+    }
+
+    void clear() {
+        while (size_) {
+            pop_back();
+        }
+    }
+
+    T& operator[](size_t i) { return *slots_.get(i); }
+    const T& operator[](size_t i) const { return *slots_.get(i); }
+    T& back() { return *slots_.get(size_ - 1); }
+    T* begin() { return slots_.get(0); }
+    T* end() { return slots_.get(0) + size_; }
+    const T* begin() const { return slots_.get(0); }
+    const T* end() const { return slots_.get(0) + size_; }
+
+    size_t size() const { return size_; }
+    static constexpr size_t capacity() { return N; }
+    bool empty() const { return size_ == 0; }
+    bool full() const { return size_ == N; }
+
+private:
+    slots<T, N> slots_;
+    size_t size_ = 0;
+};
+
+
+/**
+ * @brief FIFO of at most N elements, e.g. a queue of jobs or frames
+ *
+ * a power of two N keeps the index wrap to a mask
+ */
+template <typename T, size_t N>
+class ring {
+public:
+    ring() = default;
+    ring(const ring&) = delete;
+    ring& operator=(const ring&) = delete;
+    ~ring() { clear(); }
+
+    /**
+     * @return the new element at the back, or nullptr if the ring is full
+     */
+    template <typename... Args>
+    T* emplace(Args&&... args) {
+        if (count_ == N) {
+            return nullptr;
+        }
+        T* slot = new (slots_.raw((head_ + count_) % N)) T(std::forward<Args>(args)...);
+        count_++;
+        return slot;
+    }
+
+    bool push(const T& value) { return emplace(value) != nullptr; }
+
+    /**
+     * @brief push, dropping the oldest element if the ring is full
+     *
+     * @return true if an element was dropped
+     */
+    bool push_overwrite(const T& value) {
+        bool dropped = count_ == N;
+        if (dropped) {
+            pop();
+        }
+        emplace(value);
+        return dropped;
+    }
+
+    /**
+     * @brief move the oldest element into value
+     *
+     * @return false if the ring is empty
+     */
+    bool pop(T& value) {
+        if (count_ == 0) {
+            return false;
+        }
+        value = std::move(front());
+        pop();
+        return true;
+    }
+
+    void pop() {
+        slots_.get(head_)->~T();
+        head_ = (head_ + 1) % N;
+        count_--;
+    }
+
+    void clear() {
+        while (count_) {
+            pop();
+        }
+    }
+
+    T& front() { return *slots_.get(head_); }
+    T& back() { return *slots_.get((head_ + count_ - 1) % N); }
+    // i-th oldest
+    T& operator[](size_t i) { return *slots_.get((head_ + i) % N); }
+
+    size_t size() const { return count_; }
+    static constexpr size_t capacity() { return N; }
+    bool empty() const { return count_ == 0; }
+    bool full() const { return count_ == N; }
+
+private:
+    slots<T, N> slots_;
+    size_t head_ = 0;
+    size_t count_ = 0;
+};
+
+
+/**
+ * @brief links of an element of an intrusive_list, a member of the element
+ */
+struct list_link {
+    list_link* prev = nullptr;
+    list_link* next = nullptr;
+
+    bool linked() const { return next != nullptr; }
+};
+
+
+/**
+ * @brief doubly linked list of elements that hold their own links
+ *
+ * the list never owns or copies the elements, so one element can be on
+ * as many lists as it has links, and moving it between lists costs no
+ * memory, e.g. a timer moving from the pending list to the expired one
+ */
+template <typename T, list_link T::*Link>
+class intrusive_list {
+public:
+    intrusive_list() { head_.prev = head_.next = &head_; }
+    intrusive_list(const intrusive_list&) = delete;
+    intrusive_list& operator=(const intrusive_list&) = delete;
+
+    class iterator {
+    public:
+        explicit iterator(list_link* l) : l_(l) {}
+        T& operator*() const { return *from_link(l_); }
+        T* operator->() const { return from_link(l_); }
+        iterator& operator++() { l_ = l_->next; return *this; }
+        bool operator!=(const iterator& o) const { return l_ != o.l_; }
+        bool operator==(const iterator& o) const { return l_ == o.l_; }
+        list_link* link() const { return l_; }
+
+    private:
+        list_link* l_;
+    };
+
+    void push_front(T& e) { insert_after(&head_, &(e.*Link)); }
+    void push_back(T& e) { insert_after(head_.prev, &(e.*Link)); }
+
+    /**
+     * @brief put e in front of pos, e.g. to keep the list sorted
+     */
+    void insert(iterator pos, T& e) { insert_after(pos.link()->prev, &(e.*Link)); }
+
+    /**
+     * @brief take e off the list, it has to be on this one
+     */
+    static void remove(T& e) {
+        list_link* l = &(e.*Link);
+        l->prev->next = l->next;
+        l->next->prev = l->prev;
+        l->prev = l->next = nullptr;
+    }
+
+    /**
+     * @return the first element, taken off the list, or nullptr if it is empty
+     */
+    T* pop_front() {
+        if (empty()) {
+            return nullptr;
+        }
+        T* e = from_link(head_.next);
+        remove(*e);
+        return e;
+    }
+
+    T& front() { return *from_link(head_.next); }
+    T& back() { return *from_link(head_.prev); }
+    iterator begin() { return iterator(head_.next); }
+    iterator end() { return iterator(&head_); }
+    bool empty() const { return head_.next == &head_; }
+
+    size_t size() const {
+        size_t n = 0;
+        for (const list_link* l = head_.next; l != &head_; l = l->next) {
+            n++;
+        }
+        return n;
+    }
+
+private:
+    static T* from_link(list_link* l) {
+        // offset of the link member, as offsetof would give for a standard layout T
+        alignas(T) static unsigned char probe[sizeof(T)];
+        T* t = reinterpret_cast<T*>(probe);
+        auto offset = reinterpret_cast<unsigned char*>(&(t->*Link)) - probe;
+        return reinterpret_cast<T*>(reinterpret_cast<unsigned char*>(l) - offset);
+    }
+
+    static void insert_after(list_link* pos, list_link* l) {
+        l->prev = pos;
+        l->next = pos->next;
+        pos->next->prev = l;
+        pos->next = l;
+    }
+
+    list_link head_;
+};
+
+
+/**
+ * @brief priority queue of at most N elements, top() is the smallest by Less
+ *
+ * e.g. a timer heap ordered by deadline
+ */
+template <typename T, size_t N, typename Less = std::less<T>>
+class min_heap {
+public:
+    explicit min_heap(Less less = Less()) : less_(less) {}
+
+    /**
+     * @return false if the heap is full
+     */
+    bool push(const T& value) {
+        if (!items_.push_back(value)) {
+            return false;
+        }
+        sift_up(items_.size() - 1);
+        return true;
+    }
+
+    const T& top() const { return items_[0]; }
+
+    void pop() {
+        items_.swap_erase(0);
+        sift_down(0);
+    }
+
+    /**
+     * @brief remove the first element matching pred, e.g. a cancelled timer
+     *
+     * @return false if none does
+     */
+    template <typename Pred>
+    bool remove_if(Pred pred) {
+        for (size_t i = 0; i < items_.size(); i++) {
+            if (pred(items_[i])) {
+                items_.swap_erase(i);
+                if (i < items_.size()) {
+                    sift_down(i);
+                    sift_up(i);
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void clear() { items_.clear(); }
+    size_t size() const { return items_.size(); }
+    static constexpr size_t capacity() { return N; }
+    bool empty() const { return items_.empty(); }
+    bool full() const { return items_.full(); }
+
+private:
+    void sift_up(size_t i) {
+        while (i > 0) {
+            size_t parent = (i - 1) / 2;
+            if (!less_(items_[i], items_[parent])) {
+                break;
+            }
+            std::swap(items_[i], items_[parent]);
+            i = parent;
+        }
+    }
+
+    void sift_down(size_t i) {
+        size_t n = items_.size();
+        while (true) {
+            size_t smallest = i;
+            size_t l = 2 * i + 1, r = l + 1;
+            if (l < n && less_(items_[l], items_[smallest])) {
+                smallest = l;
+            }
+            if (r < n && less_(items_[r], items_[smallest])) {
+                smallest = r;
+            }
+            if (smallest == i) {
+                break;
+            }
+            std::swap(items_[i], items_[smallest]);
+            i = smallest;
+        }
+    }
+
+    static_vector<T, N> items_;
+    Less less_;
+};
+
+
+/**
+ * @brief allocator that only moves a pointer through a buffer
+ *
+ * memory is given back all at once by reset(), or down to a mark(),
+ * which suits temporaries with nested lifetimes such as the
+ * intermediate values of a bignum calculation. No destructors are run.
+ */
+class bump_arena {
+public:
+    bump_arena(void* buffer, size_t size)
+        : base_(static_cast<unsigned char*>(buffer)), size_(size) {}
+    bump_arena(const bump_arena&) = delete;
+    bump_arena& operator=(const bump_arena&) = delete;
+
+    /**
+     * @return size bytes aligned to align, a power of two, or nullptr if they don't fit
+     */
+    void* allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+        uintptr_t base = reinterpret_cast<uintptr_t>(base_);
+        uintptr_t start = (base + used_ + align - 1) & ~(uintptr_t)(align - 1);
+        if (start - base > size_ || size > size_ - (start - base)) {
+            failures_++;
+            return nullptr;
+        }
+        used_ = start - base + size;
+        if (used_ > high_water_) {
+            high_water_ = used_;
+        }
+        return reinterpret_cast<void*>(start);
+    }
+
+    /**
+     * @return a new T, or nullptr if it doesn't fit
+     */
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        void* p = allocate(sizeof(T), alignof(T));
+        return p ? new (p) T(std::forward<Args>(args)...) : nullptr;
+    }
+
+    /**
+     * @return an array of n default-initialised T, or nullptr if it doesn't fit
+     */
+    template <typename T>
+    T* create_array(size_t n) {
+        static_assert(std::is_trivially_destructible_v<T>, "the arena never runs destructors");
+        if (n > size_ / sizeof(T)) {
+            failures_++;
+            return nullptr;
+        }
+        void* p = allocate(n * sizeof(T), alignof(T));
+        return p ? new (p) T[n] : nullptr;
+    }
+
+    using marker = size_t;
+
+    marker mark() const { return used_; }
+    // free everything allocated since m
+    void release(marker m) { used_ = m; }
+    void reset() { used_ = 0; }
+
+    arena_stats stats() const { return {size_, used_, high_water_, failures_}; }
+
+private:
+    unsigned char* base_;
+    size_t size_;
+    size_t used_ = 0;
+    size_t high_water_ = 0;
+    uint32_t failures_ = 0;
+};
+
+
+/**
+ * @brief bump_arena with its own N byte buffer
+ */
+template <size_t N>
+class static_bump_arena : public bump_arena {
+public:
+    static_bump_arena() : bump_arena(buffer_, N) {}
+
+private:
+    alignas(std::max_align_t) unsigned char buffer_[N];
+};
+
+
+/**
+ * @brief rewinds an arena to where it was when the scope began
+ */
+class arena_scope {
+public:
+    explicit arena_scope(bump_arena& arena) : arena_(arena), mark_(arena.mark()) {}
+    arena_scope(const arena_scope&) = delete;
+    arena_scope& operator=(const arena_scope&) = delete;
+    ~arena_scope() { arena_.release(mark_); }
+
+private:
+    bump_arena& arena_;
+    bump_arena::marker mark_;
+};
+
+
+/**
+ * @brief N blocks for objects of type T, handed out and taken back in any order
+ *
+ * a free block holds the index of the next free one, so the pool
+ * costs nothing beyond the blocks and allocation is O(1)
+ */
+template <typename T, size_t N>
+class pool {
+public:
+    pool() {
+        for (size_t i = 0; i < N; i++) {
+            next_free(i) = i + 1;
+        }
+    }
+    pool(const pool&) = delete;
+    pool& operator=(const pool&) = delete;
+
+    /**
+     * @return an unconstructed block, or nullptr if all N are in use
+     */
+    void* allocate() {
+        if (free_ == N) {
+            failures_++;
+            return nullptr;
+        }
+        size_t i = free_;
+        free_ = next_free(i);
+        if (++used_ > high_water_) {
+            high_water_ = used_;
+        }
+        return blocks_.raw(i);
+    }
+
+    void deallocate(void* p) {
+        size_t i = (static_cast<unsigned char*>(p) - static_cast<unsigned char*>(blocks_.raw(0))) / sizeof(block);
+        next_free(i) = free_;
+        free_ = i;
+        used_--;
+    }
+
+    template <typename... Args>
+    T* create(Args&&... args) {
+        void* p = allocate();
+        return p ? new (p) T(std::forward<Args>(args)...) : nullptr;
+    }
+
+    void destroy(T* e) {
+        e->~T();
+        deallocate(e);
+    }
+
+    // whether p is one of this pool's blocks
+    bool owns(const void* p) const {
+        auto a = reinterpret_cast<uintptr_t>(p), b = reinterpret_cast<uintptr_t>(blocks_.get(0));
+        return a >= b && a < b + N * sizeof(block);
+    }
+
+    arena_stats stats() const { return {N, used_, high_water_, failures_}; }
+
+private:
+    union block {
+        alignas(T) unsigned char object[sizeof(T)];
+        size_t next;
+    };
+
+    size_t& next_free(size_t i) { return *reinterpret_cast<size_t*>(blocks_.raw(i)); }
+
+    slots<block, N> blocks_;
+    size_t free_ = 0;
+    size_t used_ = 0;
+    size_t high_water_ = 0;
+    uint32_t failures_ = 0;
+};
+
+
+/**
+ * @brief one T for each core, so each core allocates from its own arena without locking
+ */
+template <typename T, size_t Cores = 2>
+class per_core {
+public:
+    T& operator[](size_t core) { return items_[core]; }
+
+    /**
+     * @brief the calling core's T, always the first one on the host
+     */
+    T& local() {
+#if PICO_ON_DEVICE
+        return items_[get_core_num()];
+#else
+        return items_[0];
+#endif
+    }
+
+    static constexpr size_t cores() { return Cores; }
+
+private:
+    T items_[Cores];
+};
+
+} // namespace fixed_mem
+
+#endif // FIXED_MEM_HPP
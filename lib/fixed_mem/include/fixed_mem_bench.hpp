@@ -0,0 +1,235 @@
+/*****************************************************************//**
+ * \file   fixed_mem_bench.hpp
+ * \brief  fixed_mem arenas against malloc on the firmware's allocation patterns
+ *
+ * Each pattern is run once with malloc/free and once with the arena
+ * that fits it, doing the same work on the memory:
+ *
+ *   jobs     32 byte records queued 8 deep, freed oldest first     pool
+ *   frames   16 to 128 byte frames queued 16 deep, freed in order  pool of the largest
+ *   timers   24 byte nodes, 16 pending, a random one cancelled     pool
+ *   temps    8 to 64 word temporaries 4 deep, freed last first     bump_arena
+ *
+ * which are the job queue, telemetry frame ring, timer heap and
+ * bignum scratch of the firmware. The clock is passed in, e.g.
+ * time_us_32 on the Pico (newlib's malloc) or a nanosecond clock on
+ * the host (the C library's), see tools/host/fixed_mem_bench.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#ifndef FIXED_MEM_BENCH_HPP
+#define FIXED_MEM_BENCH_HPP
+
+#include <cstdint>
+#include <cstdlib>
+#include "fixed_mem.hpp"
+
+namespace fixed_mem {
+
+constexpr size_t BENCH_PATTERNS = 4;
+
+/**
+ * @brief one pattern, the times are in ticks of the clock passed to benchmark()
+ */
+struct bench_result {
+    const char* pattern;
+    uint32_t ops;
+    uint32_t malloc_ticks;
+    uint32_t fixed_ticks;
+    arena_stats fixed;          // the arena's usage over the run
+    uint32_t malloc_failures;   // malloc returning NULL
+};
+
+
+namespace bench_detail {
+
+// the checksum of everything written, so neither side's work can be optimised away
+inline volatile uint32_t sink;
+
+// xorshift, the same sequence for both runs of a pattern
+struct rng {
+    uint32_t s = 0x2545f491;
+    uint32_t next() {
+        s ^= s << 13;
+        s ^= s >> 17;
+        s ^= s << 5;
+        return s;
+    }
+};
+
+struct malloc_alloc {
+    uint32_t failures = 0;
+    void* get(size_t size) {
+        void* p = std::malloc(size);
+        failures += p == nullptr;
+        return p;
+    }
+    void put(void* p, size_t) { std::free(p); }
+};
+
+template <size_t Size, size_t N>
+struct pool_alloc {
+    struct block {
+        alignas(std::max_align_t) unsigned char bytes[Size];
+    };
+    pool<block, N> blocks;
+    void* get(size_t) { return blocks.allocate(); }
+    void put(void* p, size_t) { blocks.deallocate(p); }
+    arena_stats stats() const { return blocks.stats(); }
+};
+
+// frees have to come last first
+template <size_t Size, size_t Depth>
+struct stack_alloc {
+    static_bump_arena<Size> arena;
+    bump_arena::marker marks[Depth];
+    size_t depth = 0;
+    void* get(size_t size) {
+        marks[depth++] = arena.mark();
+        return arena.allocate(size, alignof(uint32_t));
+    }
+    void put(void*, size_t) { arena.release(marks[--depth]); }
+    arena_stats stats() const { return arena.stats(); }
+};
+
+inline uint32_t touch(void* p, size_t size, uint32_t value) {
+    if (!p) {
+        return 0;
+    }
+    auto* w = static_cast<uint32_t*>(p);
+    w[0] = value;
+    w[size / sizeof(uint32_t) - 1] = value;
+    return w[0];
+}
+
+// a FIFO of Depth allocations of size(rng) bytes
+template <size_t Depth, typename Alloc, typename Size>
+void fifo(Alloc& alloc, uint32_t ops, Size size) {
+    struct entry {
+        void* p;
+        size_t size;
+    };
+    ring<entry, Depth> live;
+    rng r;
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < ops; i++) {
+        if (live.full()) {
+            entry e;
+            live.pop(e);
+            alloc.put(e.p, e.size);
+        }
+        size_t n = size(r);
+        void* p = alloc.get(n);
+        sum += touch(p, n, i);
+        if (p) {
+            live.push({p, n});
+        }
+    }
+    entry e;
+    while (live.pop(e)) {
+        alloc.put(e.p, e.size);
+    }
+    sink = sum;
+}
+
+// pending allocations of Size bytes, each op cancels a random one and adds another
+template <size_t Pending, size_t Size, typename Alloc>
+void random_free(Alloc& alloc, uint32_t ops) {
+    static_vector<void*, Pending> live;
+    rng r;
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < ops; i++) {
+        if (live.full()) {
+            size_t k = r.next() % Pending;
+            alloc.put(live[k], Size);
+            live.swap_erase(k);
+        }
+        void* p = alloc.get(Size);
+        sum += touch(p, Size, i);
+        if (p) {
+            live.push_back(p);
+        }
+    }
+    for (void* p : live) {
+        alloc.put(p, Size);
+    }
+    sink = sum;
+}
+
+// Depth nested temporaries of 8 to 64 words, freed last first
+template <size_t Depth, typename Alloc>
+void nested(Alloc& alloc, uint32_t ops) {
+    void* p[Depth];
+    size_t n[Depth];
+    rng r;
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < ops; i++) {
+        for (size_t d = 0; d < Depth; d++) {
+            n[d] = (8 + r.next() % 57) * sizeof(uint32_t);
+            p[d] = alloc.get(n[d]);
+            sum += touch(p[d], n[d], i);
+        }
+        for (size_t d = Depth; d-- > 0;) {
+            alloc.put(p[d], n[d]);
+        }
+    }
+    sink = sum;
+}
+
+template <typename Clock, typename Fixed, typename Run>
+bench_result compare(const char* pattern, Clock now, uint32_t ops, Fixed& fixed, Run run) {
+    bench_result result{pattern, ops, 0, 0, {}, 0};
+    malloc_alloc heap;
+    uint32_t start = now();
+    run(heap);
+    result.malloc_ticks = now() - start;
+    result.malloc_failures = heap.failures;
+
+    start = now();
+    run(fixed);
+    result.fixed_ticks = now() - start;
+    result.fixed = fixed.stats();
+    return result;
+}
+
+} // namespace bench_detail
+
+
+/**
+ * @brief run every pattern for ops operations
+ *
+ * the arenas are static, about 4 KB in all, so this can run on a small stack
+ *
+ * @param now returns a uint32_t tick count, which may wrap
+ * @param results BENCH_PATTERNS of them
+ */
+template <typename Clock>
+void benchmark(Clock now, uint32_t ops, bench_result* results) {
+    using namespace bench_detail;
+
+    static pool_alloc<32, 8> jobs;
+    results[0] = compare("jobs", now, ops, jobs, [&](auto& a) {
+        fifo<8>(a, ops, [](rng&) { return size_t(32); });
+    });
+
+    static pool_alloc<128, 16> frames;
+    results[1] = compare("frames", now, ops, frames, [&](auto& a) {
+        fifo<16>(a, ops, [](rng& r) { return size_t(16 + (r.next() % 8) * 16); });
+    });
+
+    static pool_alloc<24, 16> timers;
+    results[2] = compare("timers", now, ops, timers, [&](auto& a) {
+        random_free<16, 24>(a, ops);
+    });
+
+    static stack_alloc<1024, 4> temps;
+    results[3] = compare("temps", now, ops, temps, [&](auto& a) {
+        nested<4>(a, ops);
+    });
+}
+
+} // namespace fixed_mem
+
+#endif // FIXED_MEM_BENCH_HPP
@@ -0,0 +1,232 @@
+/*****************************************************************//**
+ * \file   idle.c
+ * \brief  low-power idle with wake source and residency accounting
+ *
+ * The wake source is read from the NVIC pending register (and the
+ * SysTick/PendSV pending bits in ICSR) while interrupts are still
+ * masked after the sleep instruction, before any handler has had the
+ * chance to clear it.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include <stdio.h>
+#include "idle.h"
+#include "pico/runtime_init.h"
+#include "hardware/clocks.h"
+#include "hardware/pll.h"
+#include "hardware/sync.h"
+#include "hardware/xosc.h"
+#include "hardware/structs/rosc.h"
+#include "hardware/structs/scb.h"
+#include "hardware/regs/addressmap.h"
+#include "hardware/regs/m0plus.h"
+
+// NVIC enable and pending registers of the calling core
+#define NVIC_ISER (*(io_ro_32 *)(PPB_BASE + M0PLUS_NVIC_ISER_OFFSET))
+#define NVIC_ISPR (*(io_ro_32 *)(PPB_BASE + M0PLUS_NVIC_ISPR_OFFSET))
+
+typedef struct {
+    idle_mode_t mode;
+    idle_stats_t stats;
+} idle_core_t;
+
+static idle_core_t cores[NUM_CORES];
+
+static const char *const irq_names[] = {
+    "TIMER_IRQ_0", "TIMER_IRQ_1", "TIMER_IRQ_2", "TIMER_IRQ_3",
+    "PWM_IRQ_WRAP", "USBCTRL_IRQ", "XIP_IRQ",
+    "PIO0_IRQ_0", "PIO0_IRQ_1", "PIO1_IRQ_0", "PIO1_IRQ_1",
+    "DMA_IRQ_0", "DMA_IRQ_1", "IO_IRQ_BANK0", "IO_IRQ_QSPI",
+    "SIO_IRQ_PROC0", "SIO_IRQ_PROC1", "CLOCKS_IRQ",
+    "SPI0_IRQ", "SPI1_IRQ", "UART0_IRQ", "UART1_IRQ",
+    "ADC_IRQ_FIFO", "I2C0_IRQ", "I2C1_IRQ", "RTC_IRQ",
+};
+
+
+static void reset_stats(idle_stats_t *stats) {
+    *stats = (idle_stats_t){0};
+    stats->since_us = time_us_64();
+}
+
+
+void idle_init(idle_mode_t mode) {
+    idle_core_t *c = &cores[get_core_num()];
+    c->mode = mode;
+    if (mode != IDLE_WFI) {
+        // a masked interrupt becoming pending has to wake WFE
+        hw_set_bits(&scb_hw->scr, M0PLUS_SCR_SEVONPEND_BITS);
+    }
+    if (mode == IDLE_SLEEP) {
+        idle_set_sleep_clocks(IDLE_SLEEP_EN0_DEFAULT, IDLE_SLEEP_EN1_DEFAULT);
+    }
+    reset_stats(&c->stats);
+}
+
+
+void idle_set_sleep_clocks(uint32_t en0, uint32_t en1) {
+    clocks_hw->sleep_en0 = en0;
+    clocks_hw->sleep_en1 = en1;
+}
+
+
+void idle_wait(void) {
+    idle_core_t *c = &cores[get_core_num()];
+    if (c->stats.since_us == 0) {
+        idle_init(IDLE_WFE);
+    }
+
+    uint32_t save = save_and_disable_interrupts();
+    if (c->mode == IDLE_SLEEP) {
+        hw_set_bits(&scb_hw->scr, M0PLUS_SCR_SLEEPDEEP_BITS);
+    }
+
+    uint64_t start = time_us_64();
+    if (c->mode == IDLE_WFI) {
+        __wfi();
+    } else {
+        __wfe();
+    }
+    uint64_t end = time_us_64();
+
+    if (c->mode == IDLE_SLEEP) {
+        hw_clear_bits(&scb_hw->scr, M0PLUS_SCR_SLEEPDEEP_BITS);
+    }
+
+    // what woke us, before the handlers run and clear it
+    uint32_t irqs = NVIC_ISPR & NVIC_ISER;
+    uint32_t icsr = scb_hw->icsr & (M0PLUS_ICSR_PENDSTSET_BITS | M0PLUS_ICSR_PENDSVSET_BITS);
+
+    idle_stats_t *s = &c->stats;
+    s->asleep_us += end - start;
+    s->sleeps++;
+    for (uint32_t irq = 0, pending = irqs; pending; irq++, pending >>= 1) {
+        if (pending & 1) {
+            s->wakes[irq]++;
+        }
+    }
+    if (icsr & M0PLUS_ICSR_PENDSTSET_BITS) {
+        s->wakes[IDLE_WAKE_SYSTICK]++;
+    }
+    if (icsr & M0PLUS_ICSR_PENDSVSET_BITS) {
+        s->wakes[IDLE_WAKE_PENDSV]++;
+    }
+    if (!irqs && !icsr) {
+        s->wakes[IDLE_WAKE_EVENT]++;
+    }
+
+    restore_interrupts(save);
+}
+
+
+static int64_t wake_alarm(alarm_id_t id, void *user_data) {
+    (void)id;
+    (void)user_data;
+    __sev(); // for a core other than the alarm pool's
+    return 0;
+}
+
+
+void idle_sleep_until(absolute_time_t t) {
+    if (time_reached(t)) {
+        return;
+    }
+    alarm_id_t id = add_alarm_at(t, wake_alarm, NULL, true);
+    while (!time_reached(t)) {
+        idle_wait();
+    }
+    if (id > 0) {
+        cancel_alarm(id);
+    }
+}
+
+
+void idle_dormant_until_pin(uint pin, bool edge, bool high) {
+    idle_core_t *c = &cores[get_core_num()];
+
+    // run everything from the crystal, so stopping it stops every clock
+    clock_configure(clk_ref, CLOCKS_CLK_REF_CTRL_SRC_VALUE_XOSC_CLKSRC, 0, XOSC_HZ, XOSC_HZ);
+    clock_configure(clk_sys, CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLK_REF, 0, XOSC_HZ, XOSC_HZ);
+    clock_configure(clk_peri, 0, CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_XOSC_CLKSRC, XOSC_HZ, XOSC_HZ);
+    clock_stop(clk_usb);
+    clock_stop(clk_adc);
+    pll_deinit(pll_sys);
+    pll_deinit(pll_usb);
+    hw_write_masked(&rosc_hw->ctrl, ROSC_CTRL_ENABLE_VALUE_DISABLE << ROSC_CTRL_ENABLE_LSB, ROSC_CTRL_ENABLE_BITS);
+
+    uint32_t event = edge ? (high ? GPIO_IRQ_EDGE_RISE : GPIO_IRQ_EDGE_FALL)
+                          : (high ? GPIO_IRQ_LEVEL_HIGH : GPIO_IRQ_LEVEL_LOW);
+    gpio_set_dormant_irq_enabled(pin, event, true);
+
+    // returns once the pin has restarted the crystal
+    xosc_dormant();
+
+    gpio_acknowledge_irq(pin, event);
+    gpio_set_dormant_irq_enabled(pin, event, false);
+
+    hw_write_masked(&rosc_hw->ctrl, ROSC_CTRL_ENABLE_VALUE_ENABLE << ROSC_CTRL_ENABLE_LSB, ROSC_CTRL_ENABLE_BITS);
+    runtime_init_clocks();
+    c->stats.dormant++;
+}
+
+
+void idle_get_stats(uint core, idle_stats_t *stats) {
+    uint32_t save = save_and_disable_interrupts();
+    *stats = cores[core].stats;
+    restore_interrupts(save);
+}
+
+
+uint32_t idle_residency_permille(const idle_stats_t *stats) {
+    uint64_t total = time_us_64() - stats->since_us;
+    return total ? (uint32_t)(stats->asleep_us * 1000 / total) : 0;
+}
+
+
+void idle_print(void) {
+    uint core = get_core_num();
+    idle_stats_t s;
+    idle_get_stats(core, &s);
+
+    uint32_t permille = idle_residency_permille(&s);
+    uint32_t total_ms = (uint32_t)((time_us_64() - s.since_us) / 1000);
+    printf("idle core%u: %lu.%lu%% asleep over %lu.%02lu s, %lu sleeps", core,
+           permille / 10, permille % 10, total_ms / 1000, total_ms % 1000 / 10, s.sleeps);
+    if (s.dormant) {
+        printf(", %lu dormant", s.dormant);
+    }
+    printf(", woken by");
+    for (uint i = 0; i < IDLE_WAKE_SOURCES; i++) {
+        if (!s.wakes[i]) {
+            continue;
+        }
+        if (i < count_of(irq_names)) {
+            printf(" %s", irq_names[i]);
+        } else if (i == IDLE_WAKE_SYSTICK) {
+            printf(" systick");
+        } else if (i == IDLE_WAKE_PENDSV) {
+            printf(" pendsv");
+        } else if (i == IDLE_WAKE_EVENT) {
+            printf(" event");
+        } else {
+            printf(" IRQ%u", i);
+        }
+        printf(" x%lu", s.wakes[i]);
+    }
+    printf("\n");
+
+    uint32_t save = save_and_disable_interrupts();
+    reset_stats(&cores[core].stats);
+    restore_interrupts(save);
+}
+
+
+bool idle_report_every(uint32_t period_ms) {
+    idle_core_t *c = &cores[get_core_num()];
+    if (time_us_64() - c->stats.since_us < (uint64_t)period_ms * 1000) {
+        return false;
+    }
+    idle_print();
+    return true;
+}
@@ -0,0 +1,160 @@
+/*****************************************************************//**
+ * \file   idle.h
+ * \brief  low-power idle with wake source and residency accounting
+ *
+ * idle_wait() is the per-core idle hook: it sleeps until an interrupt
+ * (or, in the WFE modes, an event from the other core) and returns
+ * once the interrupt handler has run. Interrupts are masked around the
+ * sleep, so it can look at what is pending before the handlers clear
+ * it and count the wake source, and the time asleep is summed so the
+ * idle residency (the share of time spent asleep) can be reported.
+ *
+ * The WFE modes set SEVONPEND, so an interrupt that arrives between a
+ * caller's check of its wake condition and the sleep still wakes it:
+ * loops like while (!ready) idle_wait(); can't miss a wake-up. IDLE_WFI
+ * doesn't have that guarantee.
+ *
+ * IDLE_SLEEP also sets SLEEPDEEP. Once both cores are asleep the
+ * clocks block then stops every clock not enabled in SLEEP_EN0/1,
+ * see idle_set_sleep_clocks(). idle_dormant_until_pin() stops the
+ * oscillators altogether; the timer stops with them, so dormant time
+ * is counted in entries only.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#ifndef IDLE_H
+#define IDLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/stdlib.h"
+#include "hardware/regs/clocks.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// wake sources, 0 to 31 are the IRQ numbers
+#define IDLE_WAKE_SYSTICK   32
+#define IDLE_WAKE_PENDSV    33
+#define IDLE_WAKE_EVENT     34      // nothing pending: SEV from the other core or a stale event
+#define IDLE_WAKE_SOURCES   35
+
+// clocks kept running in IDLE_SLEEP unless changed: the timer and its
+// tick, GPIO, the crystal and system PLL, the bus fabric and the SRAMs
+#define IDLE_SLEEP_EN0_DEFAULT (CLOCKS_SLEEP_EN0_CLK_SYS_IO_BITS | CLOCKS_SLEEP_EN0_CLK_SYS_PADS_BITS | \
+                                CLOCKS_SLEEP_EN0_CLK_SYS_PLL_SYS_BITS | CLOCKS_SLEEP_EN0_CLK_SYS_BUSFABRIC_BITS | \
+                                CLOCKS_SLEEP_EN0_CLK_SYS_SRAM0_BITS | CLOCKS_SLEEP_EN0_CLK_SYS_SRAM1_BITS | \
+                                CLOCKS_SLEEP_EN0_CLK_SYS_SRAM2_BITS | CLOCKS_SLEEP_EN0_CLK_SYS_SRAM3_BITS)
+#define IDLE_SLEEP_EN1_DEFAULT (CLOCKS_SLEEP_EN1_CLK_SYS_TIMER_BITS | CLOCKS_SLEEP_EN1_CLK_SYS_WATCHDOG_BITS | \
+                                CLOCKS_SLEEP_EN1_CLK_SYS_XOSC_BITS | CLOCKS_SLEEP_EN1_CLK_SYS_SRAM4_BITS | \
+                                CLOCKS_SLEEP_EN1_CLK_SYS_SRAM5_BITS)
+
+
+typedef enum {
+    IDLE_WFE,       // wait for event, the default
+    IDLE_WFI,       // wait for interrupt
+    IDLE_SLEEP,     // WFE with unused clocks gated while both cores sleep
+} idle_mode_t;
+
+
+/**
+ * @brief accounting for one core since idle_init() or the last idle_print()
+ */
+typedef struct {
+    uint64_t since_us;      // start of the period covered
+    uint64_t asleep_us;     // time spent in idle_wait()
+    uint32_t sleeps;        // calls to idle_wait()
+    uint32_t dormant;       // wake-ups from dormant, their time isn't counted
+    uint32_t wakes[IDLE_WAKE_SOURCES];  // every source pending at a wake-up is counted
+} idle_stats_t;
+
+
+/**
+ * @brief choose how the calling core idles and start its accounting
+ *
+ * @param mode IDLE_WFE, IDLE_WFI or IDLE_SLEEP
+ */
+void idle_init(idle_mode_t mode);
+
+
+/**
+ * @brief sleep until an interrupt or event, after the interrupt handlers have run
+ *
+ * uses IDLE_WFE on a core that never called idle_init()
+ */
+void idle_wait(void);
+
+
+/**
+ * @brief idle until a time, like sleep_until() but with accounting
+ *
+ * the alarm comes from the default alarm pool, so a core other than
+ * the pool's is woken by its SEV and must use one of the WFE modes
+ */
+void idle_sleep_until(absolute_time_t t);
+
+
+/**
+ * @brief idle for a number of milliseconds, like sleep_ms()
+ */
+static inline void idle_sleep_ms(uint32_t ms) {
+    idle_sleep_until(make_timeout_time_ms(ms));
+}
+
+
+/**
+ * @brief clocks left running in IDLE_SLEEP, written to SLEEP_EN0/SLEEP_EN1
+ *
+ * the setting is shared by both cores
+ */
+void idle_set_sleep_clocks(uint32_t en0, uint32_t en1);
+
+
+/**
+ * @brief stop all oscillators until a GPIO edge or level, then restore the default clocks
+ *
+ * Call on core 0 with core 1 idle or reset. USB disconnects, and the
+ * peripherals are clocked as after boot when it returns.
+ *
+ * @param pin GPIO to wake on
+ * @param edge true to wake on an edge, false on a level
+ * @param high true for a rising edge or high level
+ */
+void idle_dormant_until_pin(uint pin, bool edge, bool high);
+
+
+/**
+ * @brief copy the accounting of a core
+ */
+void idle_get_stats(uint core, idle_stats_t *stats);
+
+
+/**
+ * @brief share of the time since stats->since_us spent asleep, in tenths of a percent
+ */
+uint32_t idle_residency_permille(const idle_stats_t *stats);
+
+
+/**
+ * @brief print the calling core's residency and wake sources on stdio, then restart its accounting
+ *
+ *   idle core0: 99.7% asleep over 10.00 s, 21 sleeps, woken by TIMER_IRQ_3 x20 event x1
+ */
+void idle_print(void);
+
+
+/**
+ * @brief idle_print() if at least period_ms have passed since the calling core's accounting started
+ *
+ * @return true if it printed
+ */
+bool idle_report_every(uint32_t period_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // IDLE_H
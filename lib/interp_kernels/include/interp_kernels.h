@@ -0,0 +1,157 @@
+/*****************************************************************//**
+ * \file   interp_kernels.h
+ * \brief  kernels using the RP2040 SIO interpolators
+ *
+ * Each core has its own INTERP0 and INTERP1. The *_init() functions
+ * configure one interpolator for a kernel and the kernel then owns
+ * it until another *_init() is called on it, so e.g. a blend on interp0
+ * and a LUT on interp1 can be used side by side. Nothing is saved
+ * or restored, so don't share an interpolator with an ISR that uses
+ * it without wrapping the ISR in interp_save()/interp_restore().
+ *
+ * Colours use the GRB layout produced by urgb_u32() in the ws2812
+ * example: green in bits 16-23, red in bits 8-15, blue in bits 0-7.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#ifndef INTERP_KERNELS_H
+#define INTERP_KERNELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "hardware/interp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// ---- LUT indexing ---- //
+
+/**
+ * @brief configure lane 0 to turn a value into a table entry address
+ *
+ * the entry used is table[(value >> shift) & ((1 << index_bits) - 1)]
+ *
+ * @param interp interpolator to configure (interp0 or interp1)
+ * @param table base address of the table
+ * @param size_log2 log2 of the entry size in bytes (0, 1 or 2)
+ * @param shift right shift applied to the value, must be >= size_log2
+ * @param index_bits number of index bits kept after the shift
+ */
+void interp_lut_init(interp_hw_t *interp, const void *table, uint size_log2, uint shift, uint index_bits);
+
+
+/**
+ * @brief address of the table entry selected by value
+ */
+static inline const void *interp_lut_addr(interp_hw_t *interp, uint32_t value) {
+    interp->accum[0] = value;
+    return (const void *)interp->peek[0];
+}
+
+
+/**
+ * @brief look up a single byte entry
+ */
+static inline uint8_t interp_lut_u8(interp_hw_t *interp, uint32_t value) {
+    return *(const uint8_t *)interp_lut_addr(interp, value);
+}
+
+
+/**
+ * @brief look up a single word entry
+ */
+static inline uint32_t interp_lut_u32(interp_hw_t *interp, uint32_t value) {
+    return *(const uint32_t *)interp_lut_addr(interp, value);
+}
+
+
+/**
+ * @brief map an array of bytes through a byte table, dst[i] = table[src[i]]
+ *
+ * interp must have been set up with interp_lut_init(interp, table, 0, 0, 8)
+ */
+void interp_lut_map_u8(interp_hw_t *interp, const uint8_t *src, uint8_t *dst, size_t count);
+
+
+/**
+ * @brief map each channel of an array of GRB colours through a byte table
+ *
+ * typically used for gamma correction; interp must have been set up
+ * with interp_lut_init(interp, table, 0, 0, 8)
+ */
+void interp_lut_map_grb(interp_hw_t *interp, const uint32_t *src, uint32_t *dst, size_t count);
+
+
+// ---- colour blending ---- //
+
+/**
+ * @brief configure the interpolator for blend mode, which only interp0 has
+ *
+ * lane 1 carries the blend fraction in accum[1] and returns
+ * base0 + alpha * (base1 - base0) / 256
+ */
+void interp_blend_init(interp_hw_t *interp);
+
+
+/**
+ * @brief linear blend between two GRB colours
+ *
+ * @param interp interp0, set up by interp_blend_init()
+ * @param from colour returned for alpha = 0
+ * @param to colour approached as alpha tends to 256
+ * @param alpha blend fraction in 1/256ths (0 - 255)
+ * @return uint32_t blended GRB colour
+ */
+uint32_t interp_blend_grb(interp_hw_t *interp, uint32_t from, uint32_t to, uint alpha);
+
+
+/**
+ * @brief blend two arrays of GRB colours with the same fraction
+ */
+void interp_blend_span_grb(interp_hw_t *interp, const uint32_t *from, const uint32_t *to,
+                           uint32_t *dst, size_t count, uint alpha);
+
+
+// ---- affine texture address generation ---- //
+
+/**
+ * @brief configure the interpolator to walk a texture along (u, v)
+ *
+ * u and v are fixed point with frac_bits fractional bits; lane 0 maps
+ * u to a column and lane 1 maps v to a row, so every pop returns the
+ * address of the next texel and steps u and v by du and dv. Coordinates
+ * wrap at the texture edges.
+ *
+ * @param interp interpolator to configure
+ * @param texture base address of the texture, row major
+ * @param size_log2 log2 of the texel size in bytes (0, 1 or 2)
+ * @param width_bits log2 of the texture width in texels
+ * @param height_bits log2 of the texture height in texels
+ * @param frac_bits fractional bits of u and v, must be >= width_bits + size_log2
+ */
+void interp_texture_init(interp_hw_t *interp, const void *texture, uint size_log2,
+                         uint width_bits, uint height_bits, uint frac_bits);
+
+
+/**
+ * @brief render a span of byte texels
+ */
+void interp_texture_span_u8(interp_hw_t *interp, uint8_t *dst, uint32_t u, uint32_t v,
+                            uint32_t du, uint32_t dv, size_t count);
+
+
+/**
+ * @brief render a span of word (e.g. GRB colour) texels
+ */
+void interp_texture_span_u32(interp_hw_t *interp, uint32_t *dst, uint32_t u, uint32_t v,
+                             uint32_t du, uint32_t dv, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // INTERP_KERNELS_H
@@ -0,0 +1,138 @@
+/*****************************************************************//**
+ * \file   interp_kernels.c
+ * \brief  kernels using the RP2040 SIO interpolators
+ *
+ * The per-element loops are placed in RAM, they are short and the
+ * interpolator accesses are single cycle so a flash cache miss would
+ * cost more than the loop body.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include "interp_kernels.h"
+#include "pico/platform.h"
+
+
+// shift of each channel within a GRB colour
+static const uint grb_shifts[] = { 0, 8, 16 };
+
+
+void interp_lut_init(interp_hw_t *interp, const void *table, uint size_log2, uint shift, uint index_bits) {
+    hard_assert(shift >= size_log2);
+    hard_assert(size_log2 + index_bits <= 32);
+
+    // shift the index down to a byte offset and keep only the index bits
+    interp_config cfg = interp_default_config();
+    interp_config_set_shift(&cfg, shift - size_log2);
+    interp_config_set_mask(&cfg, size_log2, size_log2 + index_bits - 1);
+    interp_set_config(interp, 0, &cfg);
+
+    interp->base[0] = (uintptr_t)table;
+}
+
+
+void __not_in_flash_func(interp_lut_map_u8)(interp_hw_t *interp, const uint8_t *src, uint8_t *dst, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        interp->accum[0] = src[i];
+        dst[i] = *(const uint8_t *)interp->peek[0];
+    }
+}
+
+
+void __not_in_flash_func(interp_lut_map_grb)(interp_hw_t *interp, const uint32_t *src, uint32_t *dst, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        uint32_t c = src[i];
+        uint32_t out = 0;
+        for (uint ch = 0; ch < count_of(grb_shifts); ch++) {
+            interp->accum[0] = (c >> grb_shifts[ch]) & 0xff;
+            out |= (uint32_t)*(const uint8_t *)interp->peek[0] << grb_shifts[ch];
+        }
+        dst[i] = out;
+    }
+}
+
+
+void interp_blend_init(interp_hw_t *interp) {
+    // only INTERP0 has blend mode, the same bit is clamp mode on INTERP1
+    hard_assert(interp == interp0);
+
+    interp_config cfg = interp_default_config();
+    interp_config_set_blend(&cfg, true);
+    interp_set_config(interp, 0, &cfg);
+
+    // lane 1 passes accum[1] through unshifted, its low 8 bits are the blend fraction
+    cfg = interp_default_config();
+    interp_set_config(interp, 1, &cfg);
+}
+
+
+uint32_t __not_in_flash_func(interp_blend_grb)(interp_hw_t *interp, uint32_t from, uint32_t to, uint alpha) {
+    interp->accum[1] = alpha;
+
+    uint32_t out = 0;
+    for (uint ch = 0; ch < count_of(grb_shifts); ch++) {
+        // one write loads both ends of the blend for this channel
+        interp->base01 = (((to >> grb_shifts[ch]) & 0xff) << 16) | ((from >> grb_shifts[ch]) & 0xff);
+        out |= (interp->peek[1] & 0xff) << grb_shifts[ch];
+    }
+    return out;
+}
+
+
+void __not_in_flash_func(interp_blend_span_grb)(interp_hw_t *interp, const uint32_t *from, const uint32_t *to,
+                                                uint32_t *dst, size_t count, uint alpha) {
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = interp_blend_grb(interp, from[i], to[i], alpha);
+    }
+}
+
+
+void interp_texture_init(interp_hw_t *interp, const void *texture, uint size_log2,
+                         uint width_bits, uint height_bits, uint frac_bits) {
+    hard_assert(frac_bits >= width_bits + size_log2);
+    hard_assert(size_log2 + width_bits + height_bits <= 32);
+
+    // lane 0: integer part of u becomes the byte offset of the column
+    interp_config cfg = interp_default_config();
+    interp_config_set_add_raw(&cfg, true);
+    interp_config_set_shift(&cfg, frac_bits - size_log2);
+    interp_config_set_mask(&cfg, size_log2, size_log2 + width_bits - 1);
+    interp_set_config(interp, 0, &cfg);
+
+    // lane 1: integer part of v becomes the byte offset of the row
+    interp_config_set_shift(&cfg, frac_bits - width_bits - size_log2);
+    interp_config_set_mask(&cfg, size_log2 + width_bits, size_log2 + width_bits + height_bits - 1);
+    interp_set_config(interp, 1, &cfg);
+
+    interp->base[2] = (uintptr_t)texture;
+}
+
+
+/**
+ * @brief load the start point and step of a span
+ */
+static inline void texture_span_start(interp_hw_t *interp, uint32_t u, uint32_t v, uint32_t du, uint32_t dv) {
+    interp->accum[0] = u;
+    interp->base[0] = du;
+    interp->accum[1] = v;
+    interp->base[1] = dv;
+}
+
+
+void __not_in_flash_func(interp_texture_span_u8)(interp_hw_t *interp, uint8_t *dst, uint32_t u, uint32_t v,
+                                                 uint32_t du, uint32_t dv, size_t count) {
+    texture_span_start(interp, u, v, du, dv);
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = *(const uint8_t *)interp->pop[2];
+    }
+}
+
+
+void __not_in_flash_func(interp_texture_span_u32)(interp_hw_t *interp, uint32_t *dst, uint32_t u, uint32_t v,
+                                                  uint32_t du, uint32_t dv, size_t count) {
+    texture_span_start(interp, u, v, du, dv);
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = *(const uint32_t *)interp->pop[2];
+    }
+}
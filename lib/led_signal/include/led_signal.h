@@ -0,0 +1,130 @@
+/*****************************************************************//**
+ * \file   led_signal.h
+ * \brief  LED blinking and patterns that run without the CPU
+ *
+ * Once started, nothing here takes an interrupt or needs the CPU:
+ *
+ *   led_signal_blink     50% square wave from a PWM slice or, for
+ *                        periods too long for PWM, a PIO state machine
+ *   led_signal_pattern   a list of (level, duration) steps played by a
+ *                        PIO state machine, looped forever by two
+ *                        chained DMA channels
+ *
+ * Both blink engines count a fixed number of ticks per half period and
+ * take the rate from their clock divider, so led_signal_set_rate() is
+ * a single write to the divider register while the rate stays in the
+ * running engine's range. The PWM slice covers half periods of about
+ * 0.27 to 67 ms at 125 MHz and the PIO state machine 0.5 ms to 32 s.
+ *
+ * PWM owns the whole slice of the pin, so the other pin of the slice
+ * can't be used for PWM at the same time.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#ifndef LED_SIGNAL_H
+#define LED_SIGNAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hardware/pio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// PIO ticks per half period of a blink, the divider scales it to the rate
+#define LED_SIGNAL_BLINK_TICKS 62500
+
+// steps in a pattern
+#define LED_SIGNAL_MAX_STEPS 16
+
+/**
+ * @brief one pattern step: LED on or off for a number of microseconds (at least 3)
+ */
+#define LED_SIGNAL_STEP(on, us) ((((uint32_t)(us) - 3u) << 1) | ((on) ? 1u : 0u))
+
+
+typedef enum {
+    LED_SIGNAL_IDLE,        // plain GPIO output, held by the last led_signal_stop()
+    LED_SIGNAL_PWM,
+    LED_SIGNAL_PIO,
+    LED_SIGNAL_PATTERN,
+} led_signal_mode_t;
+
+
+/**
+ * @brief one LED and the hardware currently driving it
+ */
+typedef struct {
+    uint pin;
+    led_signal_mode_t mode;
+    PIO pio;
+    uint sm;
+    uint offset;
+    const pio_program_t *program;
+    int data_chan;                  // feeds the steps to the state machine
+    int ctrl_chan;                  // restarts data_chan at the first step
+    const uint32_t *steps_addr;     // read by ctrl_chan
+    uint32_t steps[LED_SIGNAL_MAX_STEPS];
+} led_signal_t;
+
+
+/**
+ * @brief set the pin up as a GPIO output with the LED off
+ *
+ * @param led LED to initialise
+ * @param pin GPIO the LED is connected to
+ */
+void led_signal_init(led_signal_t *led, uint pin);
+
+
+/**
+ * @brief release whichever engine drives the LED and hold it at a level
+ *
+ * @param led LED to stop
+ * @param on level to leave the LED at
+ */
+void led_signal_stop(led_signal_t *led, bool on);
+
+
+/**
+ * @brief start blinking, on PWM if the period fits its range and on PIO otherwise
+ *
+ * @param led LED to blink
+ * @param half_period_us time the LED stays on, and then off, in microseconds
+ * @return false if the period is out of range, which leaves the LED unchanged,
+ *         or no state machine is free
+ */
+bool led_signal_blink(led_signal_t *led, uint32_t half_period_us);
+
+
+/**
+ * @brief change the blink rate
+ *
+ * a single divider write while the new period fits the running engine,
+ * otherwise the same as led_signal_blink()
+ *
+ * @param led LED that is blinking
+ * @param half_period_us new half period in microseconds
+ * @return false if the period is out of range or no state machine is free
+ */
+bool led_signal_set_rate(led_signal_t *led, uint32_t half_period_us);
+
+
+/**
+ * @brief play a pattern of steps in a loop
+ *
+ * @param led LED to drive
+ * @param steps steps made with LED_SIGNAL_STEP(), copied into led
+ * @param count number of steps, 1 to LED_SIGNAL_MAX_STEPS
+ * @return false if count is out of range or no state machine or DMA channels are free
+ */
+bool led_signal_pattern(led_signal_t *led, const uint32_t *steps, uint count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LED_SIGNAL_H
@@ -0,0 +1,215 @@
+/*****************************************************************//**
+ * \file   led_signal.c
+ * \brief  LED blinking and patterns that run without the CPU
+ *
+ * Dividers are kept as fixed point: 8.4 for the PWM slice and 16.8
+ * for the PIO state machine, matching the layout of their registers.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include "led_signal.h"
+#include "led_signal.pio.h"
+#include "pico/stdlib.h"
+#include "hardware/pwm.h"
+#include "hardware/dma.h"
+#include "hardware/clocks.h"
+
+// PWM counter period, the slice runs at 50% duty
+#define PWM_TOP 0xffff
+
+// largest PWM (8.4) and PIO (16.8) dividers
+#define PWM_DIV_MAX 0xfff
+#define PIO_DIV_MAX 0xffffff
+
+// pattern steps are in microseconds
+#define PATTERN_TICK_HZ 1000000
+
+
+/**
+ * @brief PWM divider for a half period, false if out of range
+ */
+static bool pwm_divider(uint32_t half_period_us, uint32_t *div) {
+    // full period is (PWM_TOP + 1) * div / clk_sys
+    uint64_t d = ((uint64_t)half_period_us * 2 * clock_get_hz(clk_sys) << 4) / (1000000ull * (PWM_TOP + 1));
+    *div = (uint32_t)d;
+    return d >= (1u << 4) && d <= PWM_DIV_MAX;
+}
+
+
+/**
+ * @brief PIO divider for a half period, false if out of range
+ */
+static bool pio_divider(uint32_t half_period_us, uint32_t *div) {
+    uint64_t d = ((uint64_t)half_period_us * clock_get_hz(clk_sys) << 8) / (1000000ull * LED_SIGNAL_BLINK_TICKS);
+    *div = (uint32_t)d;
+    return d >= (1u << 8) && d <= PIO_DIV_MAX;
+}
+
+
+/**
+ * @brief claim a state machine for program and drive the LED pin from it
+ */
+static bool claim_sm(led_signal_t *led, const pio_program_t *program) {
+    if (!pio_claim_free_sm_and_add_program(program, &led->pio, &led->sm, &led->offset)) {
+        return false;
+    }
+    led->program = program;
+    pio_gpio_init(led->pio, led->pin);
+    pio_sm_set_consecutive_pindirs(led->pio, led->sm, led->pin, 1, true);
+    return true;
+}
+
+
+static void release_sm(led_signal_t *led) {
+    pio_sm_set_enabled(led->pio, led->sm, false);
+    pio_remove_program_and_unclaim_sm(led->program, led->pio, led->sm, led->offset);
+}
+
+
+void led_signal_init(led_signal_t *led, uint pin) {
+    led->pin = pin;
+    led->mode = LED_SIGNAL_IDLE;
+    led->data_chan = -1;
+    led->ctrl_chan = -1;
+    gpio_init(pin);
+    gpio_set_dir(pin, GPIO_OUT);
+    gpio_put(pin, 0);
+}
+
+
+void led_signal_stop(led_signal_t *led, bool on) {
+    switch (led->mode) {
+    case LED_SIGNAL_PWM:
+        pwm_set_enabled(pwm_gpio_to_slice_num(led->pin), false);
+        break;
+    case LED_SIGNAL_PIO:
+        release_sm(led);
+        break;
+    case LED_SIGNAL_PATTERN:
+        // unchain first, aborting data_chan would otherwise restart it through ctrl_chan
+        dma_hw->ch[led->data_chan].al1_ctrl = (dma_hw->ch[led->data_chan].al1_ctrl & ~DMA_CH0_CTRL_TRIG_CHAIN_TO_BITS) |
+                                              ((uint)led->data_chan << DMA_CH0_CTRL_TRIG_CHAIN_TO_LSB);
+        dma_channel_abort(led->ctrl_chan);
+        dma_channel_abort(led->data_chan);
+        dma_channel_unclaim(led->ctrl_chan);
+        dma_channel_unclaim(led->data_chan);
+        led->data_chan = -1;
+        led->ctrl_chan = -1;
+        release_sm(led);
+        break;
+    case LED_SIGNAL_IDLE:
+        break;
+    }
+    led->mode = LED_SIGNAL_IDLE;
+
+    // back to a plain GPIO
+    gpio_init(led->pin);
+    gpio_set_dir(led->pin, GPIO_OUT);
+    gpio_put(led->pin, on);
+}
+
+
+bool led_signal_blink(led_signal_t *led, uint32_t half_period_us) {
+    uint32_t div;
+    bool use_pwm = pwm_divider(half_period_us, &div);
+    if (!use_pwm && !pio_divider(half_period_us, &div)) {
+        return false; // out of range, leave the LED as it is
+    }
+    led_signal_stop(led, false);
+
+    if (use_pwm) {
+        uint slice = pwm_gpio_to_slice_num(led->pin);
+        pwm_config c = pwm_get_default_config();
+        pwm_config_set_wrap(&c, PWM_TOP);
+        pwm_init(slice, &c, false);
+        pwm_set_chan_level(slice, pwm_gpio_to_channel(led->pin), (PWM_TOP + 1) / 2);
+        pwm_hw->slice[slice].div = div;
+        gpio_set_function(led->pin, GPIO_FUNC_PWM);
+        pwm_set_enabled(slice, true);
+        led->mode = LED_SIGNAL_PWM;
+        return true;
+    }
+
+    if (!claim_sm(led, &led_blink_program)) {
+        return false;
+    }
+    pio_sm_config c = led_blink_program_get_default_config(led->offset);
+    sm_config_set_set_pins(&c, led->pin, 1);
+    pio_sm_init(led->pio, led->sm, led->offset, &c);
+    led->pio->sm[led->sm].clkdiv = div << PIO_SM0_CLKDIV_FRAC_LSB;
+
+    // the program keeps the count in x, see led_signal.pio for the 3 ticks of overhead
+    pio_sm_put(led->pio, led->sm, LED_SIGNAL_BLINK_TICKS - 3);
+    pio_sm_set_enabled(led->pio, led->sm, true);
+    led->mode = LED_SIGNAL_PIO;
+    return true;
+}
+
+
+bool led_signal_set_rate(led_signal_t *led, uint32_t half_period_us) {
+    uint32_t div;
+    if (led->mode == LED_SIGNAL_PWM && pwm_divider(half_period_us, &div)) {
+        pwm_hw->slice[pwm_gpio_to_slice_num(led->pin)].div = div;
+        return true;
+    }
+    if (led->mode == LED_SIGNAL_PIO && pio_divider(half_period_us, &div)) {
+        led->pio->sm[led->sm].clkdiv = div << PIO_SM0_CLKDIV_FRAC_LSB;
+        return true;
+    }
+    // outside the running engine's range, or not blinking yet
+    return led_signal_blink(led, half_period_us);
+}
+
+
+bool led_signal_pattern(led_signal_t *led, const uint32_t *steps, uint count) {
+    if (count == 0 || count > LED_SIGNAL_MAX_STEPS) {
+        return false;
+    }
+    led_signal_stop(led, false);
+
+    led->data_chan = dma_claim_unused_channel(false);
+    led->ctrl_chan = dma_claim_unused_channel(false);
+    if (led->data_chan < 0 || led->ctrl_chan < 0 || !claim_sm(led, &led_pattern_program)) {
+        if (led->data_chan >= 0) dma_channel_unclaim(led->data_chan);
+        if (led->ctrl_chan >= 0) dma_channel_unclaim(led->ctrl_chan);
+        led->data_chan = -1;
+        led->ctrl_chan = -1;
+        return false;
+    }
+    for (uint i = 0; i < count; i++) {
+        led->steps[i] = steps[i];
+    }
+    led->steps_addr = led->steps;
+
+    pio_sm_config c = led_pattern_program_get_default_config(led->offset);
+    sm_config_set_out_pins(&c, led->pin, 1);
+    sm_config_set_out_shift(&c, true, true, 32);
+    sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_TX);
+    pio_sm_init(led->pio, led->sm, led->offset, &c);
+    led->pio->sm[led->sm].clkdiv =
+        (uint32_t)(((uint64_t)clock_get_hz(clk_sys) << 8) / PATTERN_TICK_HZ) << PIO_SM0_CLKDIV_FRAC_LSB;
+
+    // data_chan sends the steps as the FIFO drains, then chains to ctrl_chan
+    dma_channel_config dc = dma_channel_get_default_config(led->data_chan);
+    channel_config_set_transfer_data_size(&dc, DMA_SIZE_32);
+    channel_config_set_read_increment(&dc, true);
+    channel_config_set_write_increment(&dc, false);
+    channel_config_set_dreq(&dc, pio_get_dreq(led->pio, led->sm, true));
+    channel_config_set_chain_to(&dc, led->ctrl_chan);
+    dma_channel_configure(led->data_chan, &dc, &led->pio->txf[led->sm], led->steps, count, false);
+
+    // ctrl_chan points data_chan back at the first step, which retriggers it
+    dma_channel_config cc = dma_channel_get_default_config(led->ctrl_chan);
+    channel_config_set_transfer_data_size(&cc, DMA_SIZE_32);
+    channel_config_set_read_increment(&cc, false);
+    channel_config_set_write_increment(&cc, false);
+    dma_channel_configure(led->ctrl_chan, &cc, &dma_hw->ch[led->data_chan].al3_read_addr_trig,
+                          &led->steps_addr, 1, false);
+
+    dma_channel_start(led->data_chan);
+    pio_sm_set_enabled(led->pio, led->sm, true);
+    led->mode = LED_SIGNAL_PATTERN;
+    return true;
+}
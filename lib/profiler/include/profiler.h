@@ -0,0 +1,99 @@
+/*****************************************************************//**
+ * \file   profiler.h
+ * \brief  timer driven statistical profiler
+ *
+ * A spare TIMER alarm interrupts the core at a fixed rate. The handler
+ * picks the interrupted PC and LR out of the exception stack frame
+ * and counts the (PC, LR) pair in a small open-addressed hash table,
+ * one per core. The alarm interrupt runs at the highest NVIC priority
+ * so handlers below it get sampled too; one that shares the highest
+ * priority, like assign01's alarm ISR, never is.
+ *
+ * The histograms can be printed with profiler_dump() or read out of
+ * RAM over SWD (symbol profiler_histograms), and are symbolised on the
+ * host by tools/host/profile_report against the target's .elf.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// hash table slots per core, must be a power of two
+#ifndef PROFILER_SLOTS
+#define PROFILER_SLOTS 512
+#endif
+
+// marks a histogram in a raw memory dump ("PROF")
+#define PROFILER_MAGIC 0x464f5250
+
+/**
+ * @brief one distinct (PC, LR) pair and how often it was sampled
+ */
+typedef struct {
+    uint32_t pc;
+    uint32_t lr;
+    uint32_t count;
+} profiler_slot_t;
+
+/**
+ * @brief the histogram of one core, laid out for reading over SWD
+ */
+typedef struct {
+    uint32_t magic;         // PROFILER_MAGIC once started
+    uint32_t slot_count;    // PROFILER_SLOTS
+    uint32_t core;          // core the histogram belongs to
+    uint32_t rate_hz;       // sampling rate
+    uint32_t samples;       // samples taken
+    uint32_t lost;          // samples dropped because the table was full
+    profiler_slot_t slots[PROFILER_SLOTS];
+} profiler_histogram_t;
+
+extern profiler_histogram_t profiler_histograms[NUM_CORES];
+
+
+/**
+ * @brief start sampling the calling core
+ *
+ * claims the lowest unused hardware alarm, so each core that is profiled uses one;
+ * claim any alarm the program drives directly before calling this
+ *
+ * @param rate_hz samples per second
+ */
+void profiler_start(uint32_t rate_hz);
+
+
+/**
+ * @brief stop sampling the calling core and release its alarm
+ */
+void profiler_stop(void);
+
+
+/**
+ * @brief clear the calling core's histogram
+ */
+void profiler_reset(void);
+
+
+/**
+ * @brief print every core's histogram on stdio in the format profile_report reads
+ *
+ *   # profile core <n> rate <hz> samples <n> lost <n>
+ *   <core> <pc> <lr> <count>
+ */
+void profiler_dump(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PROFILER_H
@@ -0,0 +1,159 @@
+/*****************************************************************//**
+ * \file   profiler.c
+ * \brief  timer driven statistical profiler
+ *
+ * profiler_isr_entry (profiler_isr.S) finds the exception frame and
+ * calls profiler_sample() with it. Each core claims its own alarm and
+ * enables that alarm's interrupt only in its own NVIC, so a sample is
+ * always taken on the core it belongs to.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "profiler.h"
+#include "pico/stdlib.h"
+#include "hardware/irq.h"
+#include "hardware/timer.h"
+
+#define SLOT_MASK (PROFILER_SLOTS - 1)
+
+// linear probe length before a sample is counted as lost
+#define MAX_PROBE 8
+
+static_assert((PROFILER_SLOTS & SLOT_MASK) == 0, "PROFILER_SLOTS must be a power of two");
+
+typedef struct {
+    int alarm;              // claimed alarm, -1 when stopped
+    uint32_t period_us;
+    uint32_t target;        // time of the next sample
+} profiler_core_t;
+
+profiler_histogram_t profiler_histograms[NUM_CORES];
+static profiler_core_t cores[NUM_CORES] = {{-1, 0, 0}, {-1, 0, 0}};
+
+extern void profiler_isr_entry(void);
+
+
+/**
+ * @brief count one sample, called by profiler_isr_entry with the exception frame
+ *
+ * the hardware stacks r0-r3, r12, lr, pc and xpsr, so the interrupted
+ * pc is frame[6] and its lr is frame[5]
+ */
+void __not_in_flash_func(profiler_sample)(const uint32_t *frame) {
+    uint core = get_core_num();
+    profiler_core_t *c = &cores[core];
+    profiler_histogram_t *h = &profiler_histograms[core];
+
+    // re-arm from the previous target so the rate does not drift with handler latency
+    timer_hw->intr = 1u << c->alarm;
+    c->target += c->period_us;
+    uint32_t now = timer_hw->timerawl;
+    if ((int32_t)(c->target - now) <= 0) {
+        c->target = now + c->period_us;
+    }
+    timer_hw->alarm[c->alarm] = c->target;
+
+    uint32_t pc = frame[6];
+    uint32_t lr = frame[5];
+    uint32_t i = ((pc >> 1) ^ (lr * 0x9e3779b1u)) & SLOT_MASK;
+
+    h->samples++;
+    for (uint probe = 0; probe < MAX_PROBE; probe++, i = (i + 1) & SLOT_MASK) {
+        profiler_slot_t *s = &h->slots[i];
+        if (s->count == 0) {
+            s->pc = pc;
+            s->lr = lr;
+            s->count = 1;
+            return;
+        }
+        if (s->pc == pc && s->lr == lr) {
+            s->count++;
+            return;
+        }
+    }
+    h->lost++;
+}
+
+
+void profiler_reset(void) {
+    profiler_histogram_t *h = &profiler_histograms[get_core_num()];
+    uint32_t save = save_and_disable_interrupts();
+    h->samples = 0;
+    h->lost = 0;
+    memset(h->slots, 0, sizeof(h->slots));
+    restore_interrupts(save);
+}
+
+
+void profiler_start(uint32_t rate_hz) {
+    uint core = get_core_num();
+    profiler_core_t *c = &cores[core];
+    profiler_histogram_t *h = &profiler_histograms[core];
+
+    if (c->alarm >= 0 || rate_hz == 0) {
+        return;
+    }
+
+    h->magic = PROFILER_MAGIC;
+    h->slot_count = PROFILER_SLOTS;
+    h->core = core;
+    h->rate_hz = rate_hz;
+    profiler_reset();
+
+    c->alarm = hardware_alarm_claim_unused(true);
+    c->period_us = 1000000u / rate_hz;
+    if (c->period_us == 0) {
+        c->period_us = 1;
+    }
+
+    uint irq = TIMER_IRQ_0 + c->alarm;
+    irq_set_exclusive_handler(irq, profiler_isr_entry);
+    irq_set_priority(irq, PICO_HIGHEST_IRQ_PRIORITY);
+    hw_set_bits(&timer_hw->inte, 1u << c->alarm);
+    irq_set_enabled(irq, true);
+
+    c->target = timer_hw->timerawl + c->period_us;
+    timer_hw->alarm[c->alarm] = c->target;
+}
+
+
+void profiler_stop(void) {
+    profiler_core_t *c = &cores[get_core_num()];
+
+    if (c->alarm < 0) {
+        return;
+    }
+
+    uint irq = TIMER_IRQ_0 + c->alarm;
+    irq_set_enabled(irq, false);
+    hw_clear_bits(&timer_hw->inte, 1u << c->alarm);
+    timer_hw->armed = 1u << c->alarm;
+    timer_hw->intr = 1u << c->alarm;
+    irq_remove_handler(irq, profiler_isr_entry);
+    hardware_alarm_unclaim(c->alarm);
+    c->alarm = -1;
+}
+
+
+void profiler_dump(void) {
+    for (uint core = 0; core < NUM_CORES; core++) {
+        const profiler_histogram_t *h = &profiler_histograms[core];
+        if (h->magic != PROFILER_MAGIC) {
+            continue;
+        }
+        printf("# profile core %u rate %lu samples %lu lost %lu\n",
+               core, (unsigned long)h->rate_hz, (unsigned long)h->samples, (unsigned long)h->lost);
+        for (uint i = 0; i < PROFILER_SLOTS; i++) {
+            const profiler_slot_t *s = &h->slots[i];
+            if (s->count) {
+                printf("%u %08lx %08lx %lu\n", core,
+                       (unsigned long)s->pc, (unsigned long)s->lr, (unsigned long)s->count);
+            }
+        }
+    }
+}
@@ -0,0 +1,92 @@
+/*****************************************************************//**
+ * \file   shell.h
+ * \brief  line-based command shell over stdio
+ *
+ * shell_poll() takes whatever input stdio has without blocking, so a
+ * program can keep working between commands. Each line is split on
+ * spaces into a command name and its arguments, conventionally
+ * key=value pairs read with shell_arg(), and run from a table the
+ * program passes to shell_init(). "help" lists the table.
+ *
+ * Nothing is echoed and there is no prompt, so the output stays
+ * machine-readable; the shell's own messages start with '#'. Backspace
+ * works; a line longer than SHELL_LINE_MAX is dropped with an error.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#ifndef SHELL_H
+#define SHELL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SHELL_LINE_MAX 160
+#define SHELL_ARGS_MAX 16
+
+/**
+ * @brief one command, argv[0] is its name
+ */
+typedef struct {
+    const char *name;
+    const char *usage;      // arguments, for help
+    void (*run)(int argc, char *argv[]);
+} shell_command_t;
+
+
+/**
+ * @brief set the commands, which must stay valid while the shell runs
+ */
+void shell_init(const shell_command_t *commands, size_t count);
+
+
+/**
+ * @brief read the input that is waiting and run any line it completes
+ *
+ * @return true if a command ran
+ */
+bool shell_poll(void);
+
+
+/**
+ * @brief value of a key=value argument
+ *
+ * @return the value, or NULL if no argument has that key
+ */
+const char *shell_arg(int argc, char *argv[], const char *key);
+
+
+/**
+ * @brief check every argument is key=value with one of the given keys, printing an error if not
+ *
+ * @param keys NULL terminated
+ */
+bool shell_args_known(int argc, char *argv[], const char *const keys[]);
+
+
+/**
+ * @brief parse a decimal count, optionally with an exponent, e.g. 250000 or 1e6
+ *
+ * @return false if it isn't one or doesn't fit 32 bits
+ */
+bool shell_parse_u32(const char *s, uint32_t *value);
+
+
+/**
+ * @brief split a string in place at each sep, e.g. a list value like float,double
+ *
+ * @return number of parts, at most max; the rest stays in the last part
+ */
+size_t shell_split(char *s, char sep, char *parts[], size_t max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SHELL_H
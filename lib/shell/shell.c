@@ -0,0 +1,183 @@
+/*****************************************************************//**
+ * \file   shell.c
+ * \brief  line-based command shell over stdio
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "shell.h"
+#include "pico/stdlib.h"
+
+static const shell_command_t *commands;
+static size_t command_count;
+
+static char line[SHELL_LINE_MAX + 1];
+static size_t line_len;
+static bool overflowed;
+
+
+static void print_help(void) {
+    printf("# help\n");
+    for (size_t i = 0; i < command_count; i++) {
+        printf("# %s %s\n", commands[i].name, commands[i].usage);
+    }
+}
+
+
+static bool run_line(void) {
+    char *argv[SHELL_ARGS_MAX];
+    int argc = 0;
+    char *p = line;
+    while (*p) {
+        while (*p == ' ' || *p == '\t') {
+            *p++ = '\0';
+        }
+        if (!*p) {
+            break;
+        }
+        if (argc == SHELL_ARGS_MAX) {
+            printf("# error: more than %u arguments\n", SHELL_ARGS_MAX - 1);
+            return false;
+        }
+        argv[argc++] = p;
+        while (*p && *p != ' ' && *p != '\t') {
+            p++;
+        }
+    }
+    if (argc == 0) {
+        return false;
+    }
+
+    if (strcmp(argv[0], "help") == 0) {
+        print_help();
+        return true;
+    }
+    for (size_t i = 0; i < command_count; i++) {
+        if (strcmp(argv[0], commands[i].name) == 0) {
+            commands[i].run(argc, argv);
+            return true;
+        }
+    }
+    printf("# error: unknown command %s, try help\n", argv[0]);
+    return false;
+}
+
+
+void shell_init(const shell_command_t *cmds, size_t count) {
+    commands = cmds;
+    command_count = count;
+    line_len = 0;
+    overflowed = false;
+}
+
+
+bool shell_poll(void) {
+    int c;
+    while ((c = getchar_timeout_us(0)) != PICO_ERROR_TIMEOUT) {
+        if (c == '\r' || c == '\n') {
+            bool ran = false;
+            if (overflowed) {
+                printf("# error: line longer than %u characters\n", SHELL_LINE_MAX);
+            } else {
+                line[line_len] = '\0';
+                ran = run_line();
+            }
+            line_len = 0;
+            overflowed = false;
+            // one command per call, the rest of the input waits for the next
+            if (ran) {
+                return true;
+            }
+        } else if (c == '\b' || c == 0x7f) {
+            if (line_len) {
+                line_len--;
+            }
+        } else if (line_len < SHELL_LINE_MAX) {
+            line[line_len++] = (char)c;
+        } else {
+            overflowed = true;
+        }
+    }
+    return false;
+}
+
+
+const char *shell_arg(int argc, char *argv[], const char *key) {
+    size_t len = strlen(key);
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], key, len) == 0 && argv[i][len] == '=') {
+            return &argv[i][len + 1];
+        }
+    }
+    return NULL;
+}
+
+
+bool shell_args_known(int argc, char *argv[], const char *const keys[]) {
+    for (int i = 1; i < argc; i++) {
+        const char *eq = strchr(argv[i], '=');
+        bool known = false;
+        for (size_t k = 0; eq && keys[k]; k++) {
+            known |= strlen(keys[k]) == (size_t)(eq - argv[i]) && strncmp(argv[i], keys[k], eq - argv[i]) == 0;
+        }
+        if (!known) {
+            printf("# error: unknown argument %s\n", argv[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
+
+bool shell_parse_u32(const char *s, uint32_t *value) {
+    uint64_t v = 0;
+    if (*s < '0' || *s > '9') {
+        return false;
+    }
+    while (*s >= '0' && *s <= '9') {
+        v = v * 10 + (uint64_t)(*s++ - '0');
+        if (v > UINT32_MAX) {
+            return false;
+        }
+    }
+    if (*s == 'e' || *s == 'E') {
+        s++;
+        if (*s < '0' || *s > '9') {
+            return false;
+        }
+        uint32_t exp = 0;
+        while (*s >= '0' && *s <= '9' && exp < 10) {
+            exp = exp * 10 + (uint32_t)(*s++ - '0');
+        }
+        while (exp--) {
+            v *= 10;
+            if (v > UINT32_MAX) {
+                return false;
+            }
+        }
+    }
+    if (*s) {
+        return false;
+    }
+    *value = (uint32_t)v;
+    return true;
+}
+
+
+size_t shell_split(char *s, char sep, char *parts[], size_t max) {
+    size_t n = 0;
+    if (max == 0) {
+        return 0;
+    }
+    parts[n++] = s;
+    for (; *s && n < max; s++) {
+        if (*s == sep) {
+            *s = '\0';
+            parts[n++] = s + 1;
+        }
+    }
+    return n;
+}
@@ -0,0 +1,100 @@
+/*****************************************************************//**
+ * \file   stack_usage.h
+ * \brief  Stack painting, high-water marks and exception entry depth
+ *
+ * Each core's stack is filled with a known word, and how much of it has
+ * ever been used is read back later by finding the lowest word that has
+ * been overwritten. The stacks are the SDK's: core 0 runs on the main
+ * stack in SCRATCH_Y, core 1 on the one multicore_launch_core1() gives
+ * it in SCRATCH_X.
+ *
+ * The RP2040 has no separate exception stack under the SDK: handlers
+ * push their frame onto whatever main stack the interrupted core is
+ * using. stack_usage_watch_exceptions() routes every installed handler
+ * through a shim that records the lowest stack pointer seen at exception
+ * entry on each core, so the print shows how deep the stack was when an
+ * interrupt arrived as well as the deepest any code went.
+ *
+ * Painting is only a lower bound: a function that reserves a frame and
+ * never writes part of it leaves that part looking unused. See
+ * tools/host/stack_report for the static worst case.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#ifndef STACK_USAGE_H
+#define STACK_USAGE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define STACK_USAGE_PAINT 0xc5c5c5c5u
+
+// left unpainted below the caller's stack pointer, for stack_usage_paint()'s own frame
+#define STACK_USAGE_MARGIN 64
+
+
+/**
+ * @brief paint core 1's stack and the unused part of core 0's
+ *
+ * call from core 0 early in main, before multicore_launch_core1()
+ */
+void stack_usage_paint(void);
+
+
+/**
+ * @brief route the installed exception handlers through the entry depth shim
+ *
+ * call after every handler has been installed, on both cores; SVCall,
+ * PendSV, SysTick and the IRQs that have a handler are watched. The
+ * others keep the SDK's placeholder, so handlers can still be installed
+ * on them afterwards. A watched exception's handler can't be replaced or
+ * removed (the SDK finds the shim and asserts) until
+ * stack_usage_unwatch_exceptions() has given the vectors back.
+ */
+void stack_usage_watch_exceptions(void);
+
+
+/**
+ * @brief put back the handlers stack_usage_watch_exceptions() wrapped
+ *
+ * the entry depths recorded so far are kept, watching again carries on from them
+ */
+void stack_usage_unwatch_exceptions(void);
+
+
+/**
+ * @brief size of a core's stack in bytes
+ */
+size_t stack_usage_size(unsigned core);
+
+
+/**
+ * @brief bytes of a core's stack that have ever been written, 0 if it wasn't painted
+ */
+size_t stack_usage_used(unsigned core);
+
+
+/**
+ * @brief deepest stack use seen at an exception entry on a core, including the exception frame
+ *
+ * @return bytes from the top of the stack, 0 if no watched exception has been taken
+ */
+size_t stack_usage_exception_depth(unsigned core);
+
+
+/**
+ * @brief print size, used, free and exception entry depth for both cores
+ */
+void stack_usage_print(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // STACK_USAGE_H
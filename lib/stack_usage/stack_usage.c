@@ -0,0 +1,154 @@
+/*****************************************************************//**
+ * \file   stack_usage.c
+ * \brief  Stack painting, high-water marks and exception entry depth
+ *
+ * The stack bounds come from the SDK's linker script. stack_usage_shim
+ * (stack_usage_shim.S) records the stack pointer in
+ * stack_usage_entry_sp and jumps to the handler saved in
+ * stack_usage_handlers for the exception being taken.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include <stdio.h>
+#include "stack_usage.h"
+#include "pico/stdlib.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "hardware/structs/scb.h"
+
+// from the SDK's linker script
+extern uint32_t __StackBottom[];
+extern uint32_t __StackTop[];
+extern uint32_t __StackOneBottom[];
+extern uint32_t __StackOneTop[];
+
+// the SDK's placeholder handlers, from crt0.S
+extern char __default_isrs_start[];
+extern char __default_isrs_end[];
+extern void __unhandled_user_irq(void);
+
+#define NUM_VECTORS (VTABLE_FIRST_IRQ + NUM_IRQS)
+
+// exception numbers of the system handlers that are watched
+#define SVCALL_EXCEPTION 11
+#define PENDSV_EXCEPTION 14
+#define SYSTICK_EXCEPTION 15
+
+// lowest stack pointer seen by the shim on each core
+uint32_t stack_usage_entry_sp[NUM_CORES] = {UINT32_MAX, UINT32_MAX};
+
+// handler the shim passes each exception on to
+uintptr_t stack_usage_handlers[NUM_VECTORS];
+
+static bool painted[NUM_CORES];
+
+extern void stack_usage_shim(void);
+
+
+static uint32_t *stack_bottom(unsigned core) {
+    return core ? __StackOneBottom : __StackBottom;
+}
+
+
+static uint32_t *stack_top(unsigned core) {
+    return core ? __StackOneTop : __StackTop;
+}
+
+
+void stack_usage_paint(void) {
+    uint32_t *sp;
+    __asm volatile ("mov %0, sp" : "=r" (sp));
+
+    for (uint32_t *p = __StackOneBottom; p < __StackOneTop; p++) {
+        *p = STACK_USAGE_PAINT;
+    }
+    painted[1] = true;
+
+    uint32_t *limit = sp - STACK_USAGE_MARGIN / sizeof(uint32_t);
+    for (uint32_t *p = __StackBottom; p < limit; p++) {
+        *p = STACK_USAGE_PAINT;
+    }
+    painted[0] = true;
+}
+
+
+/**
+ * @brief whether a vector still holds the handler it was built with, which the SDK lets a new handler replace
+ */
+static bool is_default_handler(uintptr_t handler) {
+    handler &= ~1u;
+    return handler == ((uintptr_t)__unhandled_user_irq & ~1u) ||
+           (handler >= (uintptr_t)__default_isrs_start && handler < (uintptr_t)__default_isrs_end);
+}
+
+
+void stack_usage_watch_exceptions(void) {
+    uintptr_t *vtable = (uintptr_t *)scb_hw->vtor;
+    uintptr_t shim = (uintptr_t)stack_usage_shim;
+
+    for (unsigned i = SVCALL_EXCEPTION; i < NUM_VECTORS; i++) {
+        if ((i > SVCALL_EXCEPTION && i < PENDSV_EXCEPTION) || vtable[i] == shim || is_default_handler(vtable[i])) {
+            continue;
+        }
+        stack_usage_handlers[i] = vtable[i];
+        __dmb();
+        vtable[i] = shim;
+    }
+}
+
+
+void stack_usage_unwatch_exceptions(void) {
+    uintptr_t *vtable = (uintptr_t *)scb_hw->vtor;
+    uintptr_t shim = (uintptr_t)stack_usage_shim;
+
+    for (unsigned i = SVCALL_EXCEPTION; i < NUM_VECTORS; i++) {
+        if (vtable[i] == shim) {
+            vtable[i] = stack_usage_handlers[i];
+        }
+    }
+    __dmb();
+}
+
+
+size_t stack_usage_size(unsigned core) {
+    return (size_t)((uintptr_t)stack_top(core) - (uintptr_t)stack_bottom(core));
+}
+
+
+size_t stack_usage_used(unsigned core) {
+    if (!painted[core]) {
+        return 0;
+    }
+    uint32_t *p = stack_bottom(core);
+    uint32_t *top = stack_top(core);
+    while (p < top && *p == STACK_USAGE_PAINT) {
+        p++;
+    }
+    return (size_t)((uintptr_t)top - (uintptr_t)p);
+}
+
+
+size_t stack_usage_exception_depth(unsigned core) {
+    uint32_t sp = stack_usage_entry_sp[core];
+    return sp == UINT32_MAX ? 0 : (size_t)((uintptr_t)stack_top(core) - sp);
+}
+
+
+void stack_usage_print(void) {
+    printf("# stack  size  used  free  exception entry\n");
+    for (unsigned core = 0; core < NUM_CORES; core++) {
+        size_t size = stack_usage_size(core);
+        size_t used = stack_usage_used(core);
+        size_t depth = stack_usage_exception_depth(core);
+        printf("core%u  %5u %5u %5u  ", core, (unsigned)size, (unsigned)used, (unsigned)(size - used));
+        if (depth) {
+            printf("%5u", (unsigned)depth);
+        } else {
+            printf("    -");
+        }
+        // the whole stack written means it has probably run into what lies below it
+        printf("%s\n", used >= size ? "  overflowed" : "");
+    }
+}
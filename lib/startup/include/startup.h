@@ -0,0 +1,110 @@
+/*****************************************************************//**
+ * \file   startup.h
+ * \brief  connection-aware stdio startup and boot time breakdown
+ *
+ * startup_stdio_init() replaces stdio_init_all() followed by a fixed
+ * sleep: with USB stdio it waits until a terminal opens the port, up
+ * to a timeout, and goes straight on if no USB host enumerates the
+ * device (running from a power bank) or if stdio isn't on USB at all.
+ *
+ * Each boot phase is timestamped on the way:
+ *
+ *   boot2            bootrom flash setup and boot2, estimated by
+ *                    running them again from RAM (see startup.c)
+ *                    with STARTUP_MEASURE_BOOT2, otherwise and in
+ *                    no_flash builds not measured (0)
+ *   runtime          runtime init before the clocks are set up
+ *   clocks           crystal, PLLs and clock dividers
+ *   to main          the rest of runtime init up to main()
+ *   stdio            stdio_init_all()
+ *   console          waiting for the terminal
+ *   first output     main() between the console and startup_report()
+ *
+ * The phases before the clocks run on the ring oscillator and are
+ * counted in SysTick cycles, converted with its frequency measured
+ * afterwards, so they are estimates to within a few percent. The rest
+ * come from the microsecond timer.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#ifndef STARTUP_H
+#define STARTUP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// longest wait for a terminal to open the USB port
+#ifndef STARTUP_CONSOLE_TIMEOUT_MS
+#define STARTUP_CONSOLE_TIMEOUT_MS 10000
+#endif
+
+// a USB host enumerates the device well within this, otherwise there is none
+#ifndef STARTUP_ENUM_TIMEOUT_MS
+#define STARTUP_ENUM_TIMEOUT_MS 1000
+#endif
+
+// re-run the flash setup and boot2 at startup to estimate their time
+#ifndef STARTUP_MEASURE_BOOT2
+#define STARTUP_MEASURE_BOOT2 0
+#endif
+
+
+typedef enum {
+    STARTUP_BOOT2,
+    STARTUP_RUNTIME,
+    STARTUP_CLOCKS,
+    STARTUP_TO_MAIN,
+    STARTUP_STDIO,
+    STARTUP_CONSOLE,
+    STARTUP_FIRST_OUTPUT,
+    STARTUP_PHASES,
+} startup_phase_t;
+
+
+typedef enum {
+    STARTUP_CONNECTED,      // a terminal opened the USB port
+    STARTUP_TIMED_OUT,      // enumerated, but no terminal within the timeout
+    STARTUP_HEADLESS,       // no USB host
+    STARTUP_NO_USB,         // stdio isn't on USB, nothing to wait for
+} startup_console_t;
+
+
+/**
+ * @brief stdio_init_all(), then wait for a terminal on USB stdio
+ *
+ * call at the top of main(), before anything is printed
+ *
+ * @param timeout_ms longest wait for a terminal
+ * @return how the wait ended
+ */
+startup_console_t startup_stdio_init(uint32_t timeout_ms);
+
+
+/**
+ * @brief print the boot time breakdown, ending the first output phase
+ *
+ *   boot time 1012.3 ms to first output (console connected)
+ *     boot2           ~0.31 ms
+ *     ...
+ *
+ * followed by "variant <name>" in the builds made by apps_add_variants()
+ */
+void startup_report(void);
+
+
+/**
+ * @brief length of a phase in microseconds, 0 until it has ended
+ */
+uint32_t startup_phase_us(startup_phase_t phase);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // STARTUP_H
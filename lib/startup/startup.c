@@ -0,0 +1,202 @@
+/*****************************************************************//**
+ * \file   startup.c
+ * \brief  connection-aware stdio startup and boot time breakdown
+ *
+ * The timer only ticks once runtime_init_clocks() has started the
+ * watchdog tick, so the phases before that are counted with SysTick
+ * from runtime init hooks either side of PICO_RUNTIME_INIT_CLOCKS.
+ * clk_sys runs from the ring oscillator until the very end of the
+ * clock setup, and the cycles are converted with the oscillator's
+ * frequency measured later by the frequency counter.
+ *
+ * boot2 runs before any of our code. With STARTUP_MEASURE_BOOT2 its
+ * cost is estimated by doing what the bootrom does after loading it,
+ * from RAM with interrupts off: connect the flash, leave XIP, flush
+ * the cache and run boot2, which sets XIP up again. The SSI clock is
+ * derived from clk_sys, so the cycle count carries over to the ring
+ * oscillator, as at boot. hardware_flash does the same after every
+ * erase or program. Otherwise, and always in no_flash builds, which
+ * have no boot2, the phase is reported as not measured.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include <stdio.h>
+#include "startup.h"
+#include "cycle_counter.h"
+#include "pico/stdlib.h"
+#include "pico/runtime_init.h"
+#include "pico/bootrom.h"
+#include "hardware/clocks.h"
+#include "hardware/sync.h"
+#include "hardware/regs/addressmap.h"
+#if LIB_PICO_STDIO_USB
+#include "pico/stdio_usb.h"
+#include "tusb.h"
+#endif
+
+// boot2 is the first 256 bytes of flash
+#define BOOT2_SIZE_WORDS 64
+
+#define MEASURE_BOOT2 (STARTUP_MEASURE_BOOT2 && !PICO_NO_FLASH)
+
+// console polling interval
+#define POLL_MS 10
+
+#if MEASURE_BOOT2
+static uint32_t boot2_copy[BOOT2_SIZE_WORDS];
+#endif
+
+// SysTick snapshots either side of the clock setup
+static uint32_t cycles_start;
+static uint32_t cycles_pre_clocks;
+static uint32_t cycles_post_clocks;
+
+// timer at the end of each phase from the clocks on
+static uint64_t us_clocks;
+static uint64_t us_console;
+
+static uint32_t phase_us[STARTUP_PHASES];
+static startup_console_t console;
+
+
+static void startup_runtime_begin(void) {
+    cycle_counter_init();
+    cycles_start = cycle_counter_read();
+}
+PICO_RUNTIME_INIT_FUNC_RUNTIME(startup_runtime_begin, "00010");
+
+
+static void startup_clocks_begin(void) {
+    cycles_pre_clocks = cycle_counter_read();
+}
+PICO_RUNTIME_INIT_FUNC_RUNTIME(startup_clocks_begin, "00499");
+
+
+static void startup_clocks_end(void) {
+    cycles_post_clocks = cycle_counter_read();
+    us_clocks = time_us_64();
+}
+PICO_RUNTIME_INIT_FUNC_RUNTIME(startup_clocks_end, "00501");
+
+
+#if MEASURE_BOOT2
+/**
+ * @brief cycles taken by the bootrom's flash setup and boot2, run from RAM
+ *
+ * call with interrupts disabled and the other core not running from flash,
+ * nothing in here may call into flash, hence the forced inline cycle counter
+ */
+static uint32_t __no_inline_not_in_flash_func(boot2_cycles)(void) {
+    rom_connect_internal_flash_fn connect_internal_flash =
+        (rom_connect_internal_flash_fn)rom_func_lookup_inline(ROM_FUNC_CONNECT_INTERNAL_FLASH);
+    rom_flash_exit_xip_fn flash_exit_xip = (rom_flash_exit_xip_fn)rom_func_lookup_inline(ROM_FUNC_FLASH_EXIT_XIP);
+    rom_flash_flush_cache_fn flash_flush_cache =
+        (rom_flash_flush_cache_fn)rom_func_lookup_inline(ROM_FUNC_FLASH_FLUSH_CACHE);
+
+    uint32_t start = cycle_counter_read();
+    connect_internal_flash();
+    flash_exit_xip();
+    flash_flush_cache();
+    ((void (*)(void))((uintptr_t)boot2_copy + 1))();
+    return cycle_counter_elapsed(start, cycle_counter_read());
+}
+#endif
+
+
+/**
+ * @brief wait for a terminal on USB stdio, see startup_console_t
+ */
+static startup_console_t wait_console(uint32_t timeout_ms) {
+#if LIB_PICO_STDIO_USB
+    absolute_time_t enum_deadline = make_timeout_time_ms(STARTUP_ENUM_TIMEOUT_MS);
+    absolute_time_t deadline = make_timeout_time_ms(timeout_ms);
+    while (!stdio_usb_connected()) {
+        if (!tud_mounted() && time_reached(enum_deadline)) {
+            return STARTUP_HEADLESS;
+        }
+        if (time_reached(deadline)) {
+            return STARTUP_TIMED_OUT;
+        }
+        sleep_ms(POLL_MS);
+    }
+    return STARTUP_CONNECTED;
+#else
+    (void)timeout_ms;
+    return STARTUP_NO_USB;
+#endif
+}
+
+
+startup_console_t startup_stdio_init(uint32_t timeout_ms) {
+    uint64_t us_main = time_us_64();
+
+    cycle_counter_init();
+#if MEASURE_BOOT2
+    // nothing else runs yet, so XIP can go away for a moment
+    for (uint i = 0; i < BOOT2_SIZE_WORDS; i++) {
+        boot2_copy[i] = ((const uint32_t *)XIP_BASE)[i];
+    }
+    uint32_t save = save_and_disable_interrupts();
+    uint32_t boot2 = boot2_cycles();
+    restore_interrupts(save);
+#else
+    uint32_t boot2 = 0;
+#endif
+
+    // everything before the clocks ran at this rate
+    uint32_t rosc_khz = frequency_count_khz(CLOCKS_FC0_SRC_VALUE_ROSC_CLKSRC);
+    phase_us[STARTUP_BOOT2] = (uint64_t)boot2 * 1000 / rosc_khz;
+    phase_us[STARTUP_RUNTIME] = (uint64_t)cycle_counter_elapsed(cycles_start, cycles_pre_clocks) * 1000 / rosc_khz;
+    phase_us[STARTUP_CLOCKS] = (uint64_t)cycle_counter_elapsed(cycles_pre_clocks, cycles_post_clocks) * 1000 / rosc_khz;
+    phase_us[STARTUP_TO_MAIN] = us_main - us_clocks;
+
+    stdio_init_all();
+    uint64_t us_stdio = time_us_64();
+    phase_us[STARTUP_STDIO] = us_stdio - us_main;
+
+    console = wait_console(timeout_ms);
+    us_console = time_us_64();
+    phase_us[STARTUP_CONSOLE] = us_console - us_stdio;
+    return console;
+}
+
+
+void startup_report(void) {
+    static const char *const phase_names[STARTUP_PHASES] = {
+        "boot2", "runtime", "clocks", "to main", "stdio", "console", "first output",
+    };
+    static const char *const console_names[] = {
+        "console connected", "no terminal, timed out", "headless", "stdio not on USB",
+    };
+
+    if (!phase_us[STARTUP_FIRST_OUTPUT]) {
+        phase_us[STARTUP_FIRST_OUTPUT] = time_us_64() - us_console;
+    }
+
+    uint32_t total = 0;
+    for (uint i = 0; i < STARTUP_PHASES; i++) {
+        total += phase_us[i];
+    }
+    printf("boot time %lu.%lu ms to first output (%s)\n", total / 1000, total % 1000 / 100,
+           console_names[console]);
+    for (uint i = 0; i < STARTUP_PHASES; i++) {
+        if (i == STARTUP_BOOT2 && !MEASURE_BOOT2) {
+            printf("  %-13s  not measured\n", phase_names[i]);
+            continue;
+        }
+        // the phases on the ring oscillator are estimates
+        printf("  %-13s %c%lu.%02lu ms\n", phase_names[i], i <= STARTUP_CLOCKS ? '~' : ' ',
+               phase_us[i] / 1000, phase_us[i] % 1000 / 10);
+    }
+#ifdef APPS_VARIANT
+    // optimisation/binary type variant from apps_variants.cmake, to label captured results
+    printf("variant %s\n", APPS_VARIANT);
+#endif
+}
+
+
+uint32_t startup_phase_us(startup_phase_t phase) {
+    return phase < STARTUP_PHASES ? phase_us[phase] : 0;
+}
@@ -0,0 +1,122 @@
+/*****************************************************************//**
+ * \file   telemetry.h
+ * \brief  binary telemetry channel over UART DMA
+ *
+ * Records (see telemetry_proto.h) are framed, queued in a RAM ring
+ * buffer and sent on a UART by DMA, so sending one costs a few
+ * hundred cycles and never waits for the wire. The DMA completion
+ * interrupt starts the next transfer. If the ring is full the record
+ * is dropped and counted; the host sees the gap in sequence numbers.
+ *
+ * Sending is safe from both cores and from interrupt handlers. The
+ * DMA interrupt runs on the core that called telemetry_init().
+ *
+ * Targets using the channel on uart0 must disable stdio on the same
+ * UART with pico_enable_stdio_uart(<target> 0). The host side decoder
+ * is tools/host/telemetry_decode.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "hardware/uart.h"
+#include "telemetry_proto.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// size of the ring buffer in bytes, must be a power of two
+#ifndef TELEMETRY_BUFFER_SIZE
+#define TELEMETRY_BUFFER_SIZE 2048
+#endif
+
+// defaults used by telemetry_init_default()
+#ifndef TELEMETRY_UART
+#define TELEMETRY_UART uart0
+#endif
+#ifndef TELEMETRY_TX_PIN
+#define TELEMETRY_TX_PIN 0
+#endif
+#ifndef TELEMETRY_BAUDRATE
+#define TELEMETRY_BAUDRATE 921600
+#endif
+
+
+/**
+ * @brief set up the UART, claim a DMA channel and install the DMA interrupt
+ *
+ * @param uart UART instance to send on
+ * @param tx_pin GPIO to use as the UART TX pin
+ * @param baudrate requested baud rate
+ */
+void telemetry_init(uart_inst_t *uart, uint tx_pin, uint baudrate);
+
+
+/**
+ * @brief telemetry_init() with TELEMETRY_UART, TELEMETRY_TX_PIN and TELEMETRY_BAUDRATE
+ */
+static inline void telemetry_init_default(void) {
+    telemetry_init(TELEMETRY_UART, TELEMETRY_TX_PIN, TELEMETRY_BAUDRATE);
+}
+
+
+/**
+ * @brief queue a record
+ *
+ * @param type record type (TLM_REC_*)
+ * @param payload payload bytes
+ * @param len payload length, truncated to fit TLM_MAX_RECORD
+ * @return true if queued, false if it was dropped for lack of space
+ */
+bool telemetry_send(uint8_t type, const void *payload, size_t len);
+
+
+/**
+ * @brief queue a TLM_REC_TEXT record
+ */
+bool telemetry_text(const char *msg);
+
+
+/**
+ * @brief queue a TLM_REC_BENCH record
+ *
+ * @param scenario scenario number
+ * @param flags TLM_BENCH_* flags
+ * @param iterations iterations the kernel ran for
+ * @param elapsed_us time the kernel took
+ * @param result value the kernel returned
+ * @param kernel kernel name
+ */
+bool telemetry_bench(uint8_t scenario, uint8_t flags, uint32_t iterations, uint32_t elapsed_us,
+                     double result, const char *kernel);
+
+
+/**
+ * @brief queue a TLM_REC_VALUE record
+ */
+bool telemetry_value(const char *name, uint32_t value);
+
+
+/**
+ * @brief number of records dropped because the ring buffer was full
+ */
+uint32_t telemetry_dropped(void);
+
+
+/**
+ * @brief wait until every queued record has left the UART
+ */
+void telemetry_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TELEMETRY_H
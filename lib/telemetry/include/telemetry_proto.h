@@ -0,0 +1,161 @@
+/*****************************************************************//**
+ * \file   telemetry_proto.h
+ * \brief  wire format of the binary telemetry channel
+ *
+ * Shared by the firmware and the host decoder, so nothing in here
+ * depends on the Pico SDK.
+ *
+ * A record is a fixed header followed by a type specific payload:
+ *
+ *   offset  size  field
+ *   0       1     type (TLM_REC_*)
+ *   1       1     core the record was sent from
+ *   2       2     sequence number, per channel, wraps
+ *   4       4     time_us_32() when the record was sent
+ *   8       n     payload
+ *
+ * The CRC-16/CCITT-FALSE of header + payload is appended (little
+ * endian), the result is COBS encoded and a 0x00 byte ends the frame.
+ * All multi-byte fields are little endian.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#ifndef TELEMETRY_PROTO_H
+#define TELEMETRY_PROTO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// record types
+#define TLM_REC_TEXT    0x01    // payload is a message, not terminated
+#define TLM_REC_BENCH   0x02    // benchmark result, see below
+#define TLM_REC_VALUE   0x03    // named 32 bit value, see below
+
+// size of the record header
+#define TLM_HEADER_SIZE 8
+
+// largest header + payload accepted by the encoder and decoder
+#define TLM_MAX_RECORD  64
+
+// size of the CRC appended to each record
+#define TLM_CRC_SIZE    2
+
+// worst case size of an encoded frame, including the 0x00 delimiter
+#define TLM_MAX_FRAME   (TLM_MAX_RECORD + TLM_CRC_SIZE + (TLM_MAX_RECORD + TLM_CRC_SIZE) / 254 + 2)
+
+// flags in a TLM_REC_BENCH record
+#define TLM_BENCH_CACHE_EN  0x01    // XIP cache was enabled
+#define TLM_BENCH_DUAL_CORE 0x02    // both cores were running kernels
+
+/*
+ * TLM_REC_BENCH payload:
+ *   0   1  scenario number
+ *   1   1  flags (TLM_BENCH_*)
+ *   2   2  reserved, zero
+ *   4   4  iterations
+ *   8   4  elapsed time in microseconds
+ *   12  8  result, IEEE754 double
+ *   20  n  kernel name, not terminated
+ *
+ * TLM_REC_VALUE payload:
+ *   0   4  value
+ *   4   n  name, not terminated
+ */
+#define TLM_BENCH_NAME_OFFSET 20
+#define TLM_VALUE_NAME_OFFSET 4
+
+
+/**
+ * @brief CRC-16/CCITT-FALSE (poly 0x1021, init 0xffff)
+ */
+uint16_t tlm_crc16(const uint8_t *data, size_t len);
+
+
+/**
+ * @brief COBS encode a buffer and terminate it with 0x00
+ *
+ * @param src bytes to encode
+ * @param len number of bytes, at most TLM_MAX_RECORD + TLM_CRC_SIZE
+ * @param dst output, must hold len + len / 254 + 2 bytes
+ * @return size_t bytes written including the delimiter
+ */
+size_t tlm_cobs_encode(const uint8_t *src, size_t len, uint8_t *dst);
+
+
+/**
+ * @brief COBS decode one frame (without its 0x00 delimiter)
+ *
+ * @param src encoded bytes
+ * @param len number of encoded bytes
+ * @param dst output, must hold len bytes
+ * @return size_t decoded length, or 0 if the frame is malformed
+ */
+size_t tlm_cobs_decode(const uint8_t *src, size_t len, uint8_t *dst);
+
+
+/**
+ * @brief build a complete frame from a header and payload
+ *
+ * @param type record type
+ * @param core core number stored in the header
+ * @param seq sequence number stored in the header
+ * @param time_us timestamp stored in the header
+ * @param payload payload bytes (may be NULL if len is 0)
+ * @param len payload length, truncated to fit TLM_MAX_RECORD
+ * @param frame output, must hold TLM_MAX_FRAME bytes
+ * @return size_t length of the frame including the delimiter
+ */
+size_t tlm_frame_build(uint8_t type, uint8_t core, uint16_t seq, uint32_t time_us,
+                       const void *payload, size_t len, uint8_t *frame);
+
+
+/**
+ * @brief fill a TLM_REC_BENCH payload
+ *
+ * @return size_t payload length
+ */
+size_t tlm_bench_payload(uint8_t *payload, uint8_t scenario, uint8_t flags, uint32_t iterations,
+                         uint32_t elapsed_us, double result, const char *kernel);
+
+
+/**
+ * @brief fill a TLM_REC_VALUE payload
+ *
+ * @return size_t payload length
+ */
+size_t tlm_value_payload(uint8_t *payload, uint32_t value, const char *name);
+
+
+/**
+ * @brief little endian field helpers
+ */
+static inline void tlm_put_u16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void tlm_put_u32(uint8_t *p, uint32_t v) {
+    tlm_put_u16(p, (uint16_t)v);
+    tlm_put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+static inline uint16_t tlm_get_u16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t tlm_get_u32(const uint8_t *p) {
+    return tlm_get_u16(p) | ((uint32_t)tlm_get_u16(p + 2) << 16);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TELEMETRY_PROTO_H
@@ -0,0 +1,156 @@
+/*****************************************************************//**
+ * \file   telemetry.c
+ * \brief  binary telemetry channel over UART DMA
+ *
+ * head and tail are free running byte counts into the ring; the DMA
+ * channel always sends one contiguous run starting at tail, and
+ * dma_len is the size of the run in flight (0 when idle).
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include <assert.h>
+#include "telemetry.h"
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+
+#define BUFFER_MASK (TELEMETRY_BUFFER_SIZE - 1)
+
+static_assert((TELEMETRY_BUFFER_SIZE & BUFFER_MASK) == 0, "TELEMETRY_BUFFER_SIZE must be a power of two");
+
+static uint8_t ring[TELEMETRY_BUFFER_SIZE];
+static volatile uint32_t head;
+static volatile uint32_t tail;
+static volatile uint32_t dma_len;
+static uint16_t seq;
+static volatile uint32_t dropped;
+
+static int dma_chan = -1;
+static spin_lock_t *lock;
+static uart_inst_t *tlm_uart;
+
+
+/**
+ * @brief start sending the next contiguous run, caller holds the lock
+ */
+static void start_dma_locked(void) {
+    if (dma_len || head == tail) {
+        return;
+    }
+    uint32_t start = tail & BUFFER_MASK;
+    uint32_t pending = head - tail;
+    uint32_t contiguous = TELEMETRY_BUFFER_SIZE - start;
+    dma_len = pending < contiguous ? pending : contiguous;
+    dma_channel_transfer_from_buffer_now(dma_chan, &ring[start], dma_len);
+}
+
+
+/**
+ * @brief DMA completion, retire the run just sent and start the next one
+ */
+static void __not_in_flash_func(telemetry_dma_isr)(void) {
+    if (!(dma_hw->ints1 & (1u << dma_chan))) {
+        return; // shared handler, not our channel
+    }
+    dma_hw->ints1 = 1u << dma_chan;
+
+    uint32_t save = spin_lock_blocking(lock);
+    tail += dma_len;
+    dma_len = 0;
+    start_dma_locked();
+    spin_unlock(lock, save);
+}
+
+
+void telemetry_init(uart_inst_t *uart, uint tx_pin, uint baudrate) {
+    tlm_uart = uart;
+    uart_init(uart, baudrate);
+    gpio_set_function(tx_pin, GPIO_FUNC_UART);
+
+    lock = spin_lock_init(spin_lock_claim_unused(true));
+
+    // byte wide transfers from the ring to the UART data register, paced by the UART
+    dma_chan = dma_claim_unused_channel(true);
+    dma_channel_config cfg = dma_channel_get_default_config(dma_chan);
+    channel_config_set_transfer_data_size(&cfg, DMA_SIZE_8);
+    channel_config_set_read_increment(&cfg, true);
+    channel_config_set_write_increment(&cfg, false);
+    channel_config_set_dreq(&cfg, uart_get_dreq(uart, true));
+    dma_channel_configure(dma_chan, &cfg, &uart_get_hw(uart)->dr, ring, 0, false);
+
+    dma_channel_set_irq1_enabled(dma_chan, true);
+    irq_add_shared_handler(DMA_IRQ_1, telemetry_dma_isr, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_1, true);
+}
+
+
+bool telemetry_send(uint8_t type, const void *payload, size_t len) {
+    uint8_t frame[TLM_MAX_FRAME];
+
+    if (dma_chan < 0) {
+        return false; // not initialised
+    }
+
+    uint32_t save = spin_lock_blocking(lock);
+
+    // the sequence number advances even if the frame is dropped, so the host sees the gap
+    size_t n = tlm_frame_build(type, (uint8_t)get_core_num(), seq++, time_us_32(), payload, len, frame);
+
+    bool queued = TELEMETRY_BUFFER_SIZE - (head - tail) >= n;
+    if (queued) {
+        uint32_t h = head;
+        for (size_t i = 0; i < n; i++) {
+            ring[(h + i) & BUFFER_MASK] = frame[i];
+        }
+        head = h + n;
+        start_dma_locked();
+    } else {
+        dropped++;
+    }
+
+    spin_unlock(lock, save);
+    return queued;
+}
+
+
+bool telemetry_text(const char *msg) {
+    size_t len = 0;
+    while (msg[len] && len < TLM_MAX_RECORD - TLM_HEADER_SIZE) {
+        len++;
+    }
+    return telemetry_send(TLM_REC_TEXT, msg, len);
+}
+
+
+bool telemetry_bench(uint8_t scenario, uint8_t flags, uint32_t iterations, uint32_t elapsed_us,
+                     double result, const char *kernel) {
+    uint8_t payload[TLM_MAX_RECORD - TLM_HEADER_SIZE];
+    size_t len = tlm_bench_payload(payload, scenario, flags, iterations, elapsed_us, result, kernel);
+    return telemetry_send(TLM_REC_BENCH, payload, len);
+}
+
+
+bool telemetry_value(const char *name, uint32_t value) {
+    uint8_t payload[TLM_MAX_RECORD - TLM_HEADER_SIZE];
+    size_t len = tlm_value_payload(payload, value, name);
+    return telemetry_send(TLM_REC_VALUE, payload, len);
+}
+
+
+uint32_t telemetry_dropped(void) {
+    return dropped;
+}
+
+
+void telemetry_flush(void) {
+    if (dma_chan < 0) {
+        return;
+    }
+    while (head != tail) {
+        tight_loop_contents();
+    }
+    uart_tx_wait_blocking(tlm_uart);
+}
@@ -0,0 +1,132 @@
+/*****************************************************************//**
+ * \file   telemetry_proto.c
+ * \brief  framing, CRC and payload helpers for the telemetry channel
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include <string.h>
+#include "telemetry_proto.h"
+
+
+uint16_t tlm_crc16(const uint8_t *data, size_t len) {
+    uint16_t crc = 0xffff;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+
+size_t tlm_cobs_encode(const uint8_t *src, size_t len, uint8_t *dst) {
+    size_t code_pos = 0;
+    size_t out = 1;
+    uint8_t code = 1;
+
+    for (size_t i = 0; i < len; i++) {
+        if (src[i] == 0) {
+            // close the current block, the zero is implied by its code
+            dst[code_pos] = code;
+            code_pos = out++;
+            code = 1;
+        } else {
+            dst[out++] = src[i];
+            code++;
+            if (code == 0xff) {
+                // longest possible block, no implied zero
+                dst[code_pos] = code;
+                code_pos = out++;
+                code = 1;
+            }
+        }
+    }
+    dst[code_pos] = code;
+    dst[out++] = 0;
+    return out;
+}
+
+
+size_t tlm_cobs_decode(const uint8_t *src, size_t len, uint8_t *dst) {
+    size_t in = 0;
+    size_t out = 0;
+
+    while (in < len) {
+        uint8_t code = src[in++];
+        if (code == 0 || in + code - 1 > len) {
+            return 0;
+        }
+        for (uint8_t i = 1; i < code; i++) {
+            if (src[in] == 0) {
+                return 0;
+            }
+            dst[out++] = src[in++];
+        }
+        if (code != 0xff && in < len) {
+            dst[out++] = 0;
+        }
+    }
+    return out;
+}
+
+
+size_t tlm_frame_build(uint8_t type, uint8_t core, uint16_t seq, uint32_t time_us,
+                       const void *payload, size_t len, uint8_t *frame) {
+    uint8_t record[TLM_MAX_RECORD + TLM_CRC_SIZE];
+
+    if (len > TLM_MAX_RECORD - TLM_HEADER_SIZE) {
+        len = TLM_MAX_RECORD - TLM_HEADER_SIZE;
+    }
+
+    record[0] = type;
+    record[1] = core;
+    tlm_put_u16(&record[2], seq);
+    tlm_put_u32(&record[4], time_us);
+    if (len) {
+        memcpy(&record[TLM_HEADER_SIZE], payload, len);
+    }
+
+    size_t record_len = TLM_HEADER_SIZE + len;
+    tlm_put_u16(&record[record_len], tlm_crc16(record, record_len));
+
+    return tlm_cobs_encode(record, record_len + TLM_CRC_SIZE, frame);
+}
+
+
+/**
+ * @brief copy a name into a payload, keeping the record within TLM_MAX_RECORD
+ */
+static size_t put_name(uint8_t *payload, size_t offset, const char *name) {
+    size_t len = strlen(name);
+    size_t room = TLM_MAX_RECORD - TLM_HEADER_SIZE - offset;
+    if (len > room) {
+        len = room;
+    }
+    memcpy(&payload[offset], name, len);
+    return offset + len;
+}
+
+
+size_t tlm_bench_payload(uint8_t *payload, uint8_t scenario, uint8_t flags, uint32_t iterations,
+                         uint32_t elapsed_us, double result, const char *kernel) {
+    uint64_t bits;
+    memcpy(&bits, &result, sizeof(bits));
+
+    payload[0] = scenario;
+    payload[1] = flags;
+    tlm_put_u16(&payload[2], 0);
+    tlm_put_u32(&payload[4], iterations);
+    tlm_put_u32(&payload[8], elapsed_us);
+    tlm_put_u32(&payload[12], (uint32_t)bits);
+    tlm_put_u32(&payload[16], (uint32_t)(bits >> 32));
+    return put_name(payload, TLM_BENCH_NAME_OFFSET, kernel);
+}
+
+
+size_t tlm_value_payload(uint8_t *payload, uint32_t value, const char *name) {
+    tlm_put_u32(&payload[0], value);
+    return put_name(payload, TLM_VALUE_NAME_OFFSET, name);
+}
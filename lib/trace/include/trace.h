@@ -0,0 +1,143 @@
+/*****************************************************************//**
+ * \file   trace.h
+ * \brief  function entry/exit tracing into per-core RAM ring buffers
+ *
+ * Targets built with trace_functions(<target>) are compiled with
+ * -finstrument-functions, so every C/C++ function calls the hooks in
+ * trace.c on entry and exit (the SDK and the tracer are excluded).
+ * Assembly files include this header and mark their routines with
+ * TRACE_ENTER / TRACE_EXIT, which expand to nothing in other builds.
+ *
+ * Each event is one (function, timestamp) pair written to the calling
+ * core's ring; bit 0 of the function address is set for an exit. The
+ * timestamp is a 32 bit cycle count: SysTick counts the low 24 bits
+ * and its wrap interrupt the top 8. An event logged with interrupts
+ * masked just after a wrap can miss that wrap; the decoder corrects
+ * it from the event order.
+ *
+ * The buffers stay in RAM for reading over SWD with the OpenOCD
+ * helpers in tools/openocd/scripts/tools/pico_dump.tcl, and are
+ * decoded on the host by tools/host/trace_decode.
+ *
+ * Tracing takes over SysTick, so it can't be combined with
+ * lib/cycle_counter in the same program.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 0
+#endif
+
+#ifdef __ASSEMBLER__
+
+// TRACE_ENTER/TRACE_EXIT preserve r0-r4 and lr, but clobber r12 and the flags
+#if TRACE_ENABLED
+.macro TRACE_ENTER fn
+    push    {r0-r4, lr}                 @ Six words keep the stack 8 byte aligned for the C hook
+    ldr     r0, =\fn                    @ Address of the traced routine
+    bl      __cyg_profile_func_enter    @ Log the entry
+    ldr     r4, [sp, #20]               @ Thumb-1 can't pop into lr, restore it through r4
+    mov     lr, r4
+    pop     {r0-r4}
+    add     sp, #4                      @ Drop the saved lr
+.endm
+
+.macro TRACE_EXIT fn
+    push    {r0-r4, lr}
+    ldr     r0, =\fn
+    bl      __cyg_profile_func_exit     @ Log the exit
+    ldr     r4, [sp, #20]
+    mov     lr, r4
+    pop     {r0-r4}
+    add     sp, #4
+.endm
+#else
+.macro TRACE_ENTER fn
+.endm
+
+.macro TRACE_EXIT fn
+.endm
+#endif
+
+#else // !__ASSEMBLER__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// events per core, must be a power of two
+#ifndef TRACE_EVENTS
+#define TRACE_EVENTS 1024
+#endif
+
+// marks a trace buffer in a raw memory dump ("TRCE")
+#define TRACE_MAGIC 0x45435254
+
+// set in trace_event_t.fn for a function exit
+#define TRACE_EXIT_BIT 1u
+
+// keeps a function out of the trace in an instrumented build
+#define TRACE_EXCLUDE __attribute__((no_instrument_function))
+
+/**
+ * @brief one entry or exit
+ */
+typedef struct {
+    uint32_t fn;        // function address, TRACE_EXIT_BIT set for an exit
+    uint32_t stamp;     // cycle count, wrap count in the top 8 bits
+} trace_event_t;
+
+/**
+ * @brief the ring of one core, laid out for reading over SWD
+ */
+typedef struct {
+    uint32_t magic;     // TRACE_MAGIC once trace_init() has run
+    uint32_t core;
+    uint32_t capacity;  // TRACE_EVENTS
+    uint32_t head;      // events written so far, the oldest are overwritten
+    trace_event_t events[TRACE_EVENTS];
+} trace_buffer_t;
+
+extern trace_buffer_t trace_buffers[NUM_CORES];
+
+
+/**
+ * @brief start tracing on the calling core
+ *
+ * takes over SysTick and its exception on that core, call it on every core to be traced
+ */
+void trace_init(void);
+
+
+/**
+ * @brief stop logging on the calling core, the buffer is kept
+ */
+void trace_stop(void);
+
+
+/**
+ * @brief resume logging on the calling core after trace_stop()
+ */
+void trace_resume(void);
+
+
+// hooks called by the compiler instrumentation and the assembly macros
+void __cyg_profile_func_enter(void *fn, void *call_site) TRACE_EXCLUDE;
+void __cyg_profile_func_exit(void *fn, void *call_site) TRACE_EXCLUDE;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __ASSEMBLER__
+
+#endif // TRACE_H
@@ -0,0 +1,105 @@
+/*****************************************************************//**
+ * \file   trace.c
+ * \brief  function entry/exit tracing into per-core RAM ring buffers
+ *
+ * The hooks run in RAM with interrupts masked for the few cycles it
+ * takes to claim a slot, so an interrupt handler traced on the same
+ * core can't tear an event. They only touch registers through the
+ * hardware structs, as inline SDK helpers would otherwise be
+ * instrumented themselves in a traced build.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include <assert.h>
+#include "trace.h"
+#include "hardware/exception.h"
+#include "hardware/structs/sio.h"
+#include "hardware/structs/systick.h"
+#include "hardware/regs/m0plus.h"
+
+#define EVENT_MASK (TRACE_EVENTS - 1)
+#define STAMP_BITS 24
+#define STAMP_MASK M0PLUS_SYST_RVR_RELOAD_BITS
+
+static_assert((TRACE_EVENTS & EVENT_MASK) == 0, "TRACE_EVENTS must be a power of two");
+
+trace_buffer_t trace_buffers[NUM_CORES];
+static volatile uint32_t wraps[NUM_CORES];
+static volatile bool running[NUM_CORES];
+
+
+/**
+ * @brief SysTick reached zero, count the wrap on this core
+ */
+static void TRACE_EXCLUDE __not_in_flash_func(trace_systick_isr)(void) {
+    wraps[sio_hw->cpuid]++;
+}
+
+
+static inline void TRACE_EXCLUDE __always_inline record(uint32_t fn) {
+    uint32_t core = sio_hw->cpuid;
+    if (!running[core]) {
+        return;
+    }
+
+    uint32_t primask;
+    __asm volatile ("mrs %0, primask\n\tcpsid i" : "=r" (primask) :: "memory");
+
+    // SysTick counts down, flip it so stamps increase
+    uint32_t stamp = (wraps[core] << STAMP_BITS) | (STAMP_MASK - systick_hw->cvr);
+    trace_buffer_t *b = &trace_buffers[core];
+    trace_event_t *e = &b->events[b->head & EVENT_MASK];
+    e->fn = fn;
+    e->stamp = stamp;
+    b->head++;
+
+    __asm volatile ("msr primask, %0" :: "r" (primask) : "memory");
+}
+
+
+void __not_in_flash_func(__cyg_profile_func_enter)(void *fn, void *call_site) {
+    (void)call_site;
+    record((uint32_t)fn & ~TRACE_EXIT_BIT);
+}
+
+
+void __not_in_flash_func(__cyg_profile_func_exit)(void *fn, void *call_site) {
+    (void)call_site;
+    record((uint32_t)fn | TRACE_EXIT_BIT);
+}
+
+
+void TRACE_EXCLUDE trace_init(void) {
+    uint32_t core = sio_hw->cpuid;
+    trace_buffer_t *b = &trace_buffers[core];
+
+    running[core] = false;
+    b->magic = TRACE_MAGIC;
+    b->core = core;
+    b->capacity = TRACE_EVENTS;
+    b->head = 0;
+    wraps[core] = 0;
+
+    // wraps have to be counted before any handler that logs events gets to run
+    exception_set_exclusive_handler(SYSTICK_EXCEPTION, trace_systick_isr);
+    exception_set_priority(SYSTICK_EXCEPTION, PICO_HIGHEST_IRQ_PRIORITY);
+
+    systick_hw->csr = 0;
+    systick_hw->rvr = STAMP_MASK;
+    systick_hw->cvr = 0;
+    systick_hw->csr = M0PLUS_SYST_CSR_CLKSOURCE_BITS | M0PLUS_SYST_CSR_TICKINT_BITS | M0PLUS_SYST_CSR_ENABLE_BITS;
+
+    running[core] = true;
+}
+
+
+void TRACE_EXCLUDE trace_stop(void) {
+    running[sio_hw->cpuid] = false;
+}
+
+
+void TRACE_EXCLUDE trace_resume(void) {
+    running[sio_hw->cpuid] = true;
+}
@@ -0,0 +1,92 @@
+/*****************************************************************//**
+ * \file   wallis.h
+ * \brief  C entry points for the wallis product kernels
+ *
+ * The float, double and double-float kernels are instantiations of
+ * the wallis_prod() template in wallis.hpp. The original per-lab
+ * kernels are kept as the *_legacy functions so every instantiation in
+ * wallis_variants can be benchmarked against them.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#ifndef WALLIS_H
+#define WALLIS_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// iteration count the consteval variants are evaluated for at compile time
+#define WALLIS_CONSTEVAL_N 100000
+
+/**
+ * @brief computes pi approximation using wallis product formula with single precision floats
+ *
+ * pi / 2 = product from i = 1 to n of [(2i / (2i - 1)) * (2i / (2i + 1))]
+ * multiply the final product by 2 to get pi approximation
+ *
+ * @param n Number of iterations
+ */
+float wallis_prod_float(size_t n);
+
+
+/**
+ * @brief computes pi approximation using wallis product formula with double precision floats
+ *
+ * calculation is identical to wallis_prod_float except with doubles instead of floats
+ *
+ * @param n Number of iterations
+ */
+double wallis_prod_double(size_t n);
+
+
+/**
+ * @brief computes pi approximation using wallis product formula with double-float arithmetic
+ *
+ * calculation is identical to wallis_prod_float except each value is carried
+ * as an unevaluated sum of two floats, so only single precision ROM routines
+ * are used while the accuracy comes close to double
+ *
+ * @param n Number of iterations
+ * @return double the approximation, rounded to double for printing
+ */
+double wallis_prod_dfloat(size_t n);
+
+
+/**
+ * @brief the original lab02/lab07 float kernel, the baseline for the benchmarks
+ */
+float wallis_prod_float_legacy(size_t n);
+
+
+/**
+ * @brief the original lab02/lab07 double kernel, the baseline for the benchmarks
+ */
+double wallis_prod_double_legacy(size_t n);
+
+
+/**
+ * @brief one benchmarkable kernel
+ */
+typedef struct {
+    const char *name;       // e.g. "float/increment/u4"
+    const char *baseline;   // name of the legacy variant of the same type, NULL if there is none
+    double (*run)(size_t n);
+} wallis_variant_t;
+
+// upper bound on wallis_variant_count, for sizing a result array statically
+#define WALLIS_VARIANT_MAX 24
+
+// every instantiation the labs benchmark, legacy kernels first
+extern const wallis_variant_t wallis_variants[];
+extern const size_t wallis_variant_count;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WALLIS_H
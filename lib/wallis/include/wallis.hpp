@@ -0,0 +1,139 @@
+/*****************************************************************//**
+ * \file   wallis.hpp
+ * \brief  wallis product kernel, generic over the numeric type
+ *
+ * One template covers every variant the labs compare: the numeric
+ * type, how many iterations are unrolled per loop trip and how the two
+ * factors of an iteration are fused. The terms are carried from one
+ * iteration to the next with additions, so the loop never converts
+ * the loop counter or rebuilds 2i from scratch.
+ *
+ * Everything is constexpr, and wallis_prod_consteval() forces the
+ * evaluation into the compiler when the iteration count is known.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#ifndef WALLIS_HPP
+#define WALLIS_HPP
+
+#include <cstddef>
+#include <utility>
+
+// the kernel is inlined whole into each caller at every optimisation level, so a caller
+// placed in RAM or the XIP cache runs the loop there and not from a copy in flash
+#define WALLIS_INLINE [[gnu::always_inline]] inline
+
+
+/**
+ * @brief how the two factors of one iteration are combined
+ *
+ * with a = 2i, iteration i multiplies by (a / (a - 1)) * (a / (a + 1)) = a^2 / (a^2 - 1)
+ */
+enum class wallis_fusion {
+    separate,   // two divides and two multiplies, as written in the formula
+    pair,       // one divide and one multiply by a^2 / (a^2 - 1), exact only while a^2 fits in the mantissa
+    increment,  // product += product / (a^2 - 1), one divide and one add with no mantissa limit
+};
+
+
+namespace wallis_detail {
+
+/**
+ * @brief per-iteration update, carrying the term state from one iteration to the next
+ */
+template <typename T, wallis_fusion Fusion>
+struct stepper;
+
+template <typename T>
+struct stepper<T, wallis_fusion::separate> {
+    T a = T(2);         // 2i
+
+    WALLIS_INLINE constexpr void step(T& product) {
+        product *= a / (a - T(1));
+        product *= a / (a + T(1));
+        a += T(2);
+    }
+};
+
+template <typename T>
+struct stepper<T, wallis_fusion::pair> {
+    T sq = T(4);        // (2i)^2
+    T delta = T(12);    // (2i + 2)^2 - (2i)^2 = 8i + 4
+
+    WALLIS_INLINE constexpr void step(T& product) {
+        product *= sq / (sq - T(1));
+        sq += delta;
+        delta += T(8);
+    }
+};
+
+template <typename T>
+struct stepper<T, wallis_fusion::increment> {
+    T sq = T(4);
+    T delta = T(12);
+
+    WALLIS_INLINE constexpr void step(T& product) {
+        // a^2 / (a^2 - 1) = 1 + 1 / (a^2 - 1), so the small part never has to round against 1
+        product += product / (sq - T(1));
+        sq += delta;
+        delta += T(8);
+    }
+};
+
+template <typename F, size_t... I>
+WALLIS_INLINE constexpr void repeat(F&& f, std::index_sequence<I...>) {
+    ((static_cast<void>(I), f()), ...);
+}
+
+} // namespace wallis_detail
+
+
+/**
+ * @brief computes pi approximation using wallis product formula
+ *
+ * pi / 2 = product from i = 1 to n of [(2i / (2i - 1)) * (2i / (2i + 1))]
+ * multiply the final product by 2 to get pi approximation
+ *
+ * T needs construction from an integer and the usual arithmetic
+ * operators, so float, double and dfloat all work
+ *
+ * the defaults keep the original kernels' term order, so wallis_prod<float>()
+ * computes what lab02 and lab07 always timed as "float"
+ *
+ * @tparam Unroll iterations per loop trip
+ * @tparam Fusion how the two factors of an iteration are combined
+ * @param n Number of iterations
+ */
+template <typename T, size_t Unroll = 1, wallis_fusion Fusion = wallis_fusion::separate>
+WALLIS_INLINE constexpr T wallis_prod(size_t n) {
+    static_assert(Unroll > 0, "Unroll must be at least 1");
+
+    T product = T(1);
+    wallis_detail::stepper<T, Fusion> s;
+    auto step = [&]() __attribute__((always_inline)) { s.step(product); };
+
+    size_t i = 0;
+    for (; i + Unroll <= n; i += Unroll) {
+        wallis_detail::repeat(step, std::make_index_sequence<Unroll>{});
+    }
+    for (; i < n; i++) {
+        step();
+    }
+    return product * T(2);
+}
+
+
+/**
+ * @brief wallis_prod() evaluated by the compiler, costs nothing at run time
+ *
+ * the iteration count is bounded by the compiler's constexpr loop limit
+ * (-fconstexpr-loop-limit, 262144 for gcc)
+ */
+template <typename T, size_t N, size_t Unroll = 1, wallis_fusion Fusion = wallis_fusion::separate>
+consteval T wallis_prod_consteval() {
+    return wallis_prod<T, Unroll, Fusion>(N);
+}
+
+#endif // WALLIS_HPP
@@ -0,0 +1,48 @@
+/*****************************************************************//**
+ * \file   wallis_bench.h
+ * \brief  times every wallis kernel variant against its legacy baseline
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#ifndef WALLIS_BENCH_H
+#define WALLIS_BENCH_H
+
+#include <stdint.h>
+#include "wallis.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief result of one variant
+ */
+typedef struct {
+    const wallis_variant_t *variant;
+    double pi;
+    uint64_t time_us;
+    uint64_t baseline_us;   // time of variant->baseline, 0 if there is none
+} wallis_result_t;
+
+
+/**
+ * @brief run every entry of wallis_variants once
+ *
+ * @param n iterations per run
+ * @param results one entry per variant, at least wallis_variant_count (or WALLIS_VARIANT_MAX) long
+ */
+void wallis_benchmark(size_t n, wallis_result_t *results);
+
+
+/**
+ * @brief print the results as a table with the speedup over the baseline
+ */
+void wallis_print_results(const wallis_result_t *results);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WALLIS_BENCH_H
@@ -0,0 +1,79 @@
+/*****************************************************************//**
+ * \file   wallis.cpp
+ * \brief  C entry points for the wallis product kernel template
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include "wallis.h"
+#include "wallis.hpp"
+#include "dfloat.hpp"
+
+
+float wallis_prod_float(size_t n) {
+    return wallis_prod<float>(n);
+}
+
+
+double wallis_prod_double(size_t n) {
+    return wallis_prod<double>(n);
+}
+
+
+double wallis_prod_dfloat(size_t n) {
+    return static_cast<double>(wallis_prod<dfloat>(n));
+}
+
+
+namespace {
+
+template <typename T, size_t Unroll, wallis_fusion Fusion>
+double run_variant(size_t n) {
+    return static_cast<double>(wallis_prod<T, Unroll, Fusion>(n));
+}
+
+/**
+ * @brief the result for WALLIS_CONSTEVAL_N is a constant in flash, other counts fall back to the loop
+ */
+template <typename T>
+double run_consteval(size_t n) {
+    constexpr T pi = wallis_prod_consteval<T, WALLIS_CONSTEVAL_N>();
+    return n == WALLIS_CONSTEVAL_N ? static_cast<double>(pi) : static_cast<double>(wallis_prod<T>(n));
+}
+
+double run_float_legacy(size_t n) {
+    return wallis_prod_float_legacy(n);
+}
+
+} // namespace
+
+
+extern "C" const wallis_variant_t wallis_variants[] = {
+    {"float/legacy", nullptr, run_float_legacy},
+    {"double/legacy", nullptr, wallis_prod_double_legacy},
+
+    {"float/separate/u1", "float/legacy", run_variant<float, 1, wallis_fusion::separate>},
+    {"float/separate/u4", "float/legacy", run_variant<float, 4, wallis_fusion::separate>},
+    {"float/pair/u1", "float/legacy", run_variant<float, 1, wallis_fusion::pair>},
+    {"float/pair/u4", "float/legacy", run_variant<float, 4, wallis_fusion::pair>},
+    {"float/increment/u1", "float/legacy", run_variant<float, 1, wallis_fusion::increment>},
+    {"float/increment/u4", "float/legacy", run_variant<float, 4, wallis_fusion::increment>},
+    {"float/consteval", "float/legacy", run_consteval<float>},
+
+    {"double/separate/u1", "double/legacy", run_variant<double, 1, wallis_fusion::separate>},
+    {"double/separate/u4", "double/legacy", run_variant<double, 4, wallis_fusion::separate>},
+    {"double/pair/u1", "double/legacy", run_variant<double, 1, wallis_fusion::pair>},
+    {"double/pair/u4", "double/legacy", run_variant<double, 4, wallis_fusion::pair>},
+    {"double/increment/u1", "double/legacy", run_variant<double, 1, wallis_fusion::increment>},
+    {"double/increment/u4", "double/legacy", run_variant<double, 4, wallis_fusion::increment>},
+    {"double/consteval", "double/legacy", run_consteval<double>},
+
+    // no legacy double-float kernel, compare with double/legacy for the accuracy it buys
+    {"dfloat/separate/u1", "double/legacy", run_variant<dfloat, 1, wallis_fusion::separate>},
+    {"dfloat/pair/u1", "double/legacy", run_variant<dfloat, 1, wallis_fusion::pair>},
+    {"dfloat/increment/u1", "double/legacy", run_variant<dfloat, 1, wallis_fusion::increment>},
+};
+
+extern "C" const size_t wallis_variant_count = sizeof(wallis_variants) / sizeof(wallis_variants[0]);
+static_assert(sizeof(wallis_variants) / sizeof(wallis_variants[0]) <= WALLIS_VARIANT_MAX, "raise WALLIS_VARIANT_MAX");
@@ -0,0 +1,50 @@
+/*****************************************************************//**
+ * \file   wallis_bench.c
+ * \brief  times every wallis kernel variant against its legacy baseline
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "wallis_bench.h"
+#include "pico/stdlib.h"
+
+
+void wallis_benchmark(size_t n, wallis_result_t *results) {
+    for (size_t v = 0; v < wallis_variant_count; v++) {
+        const wallis_variant_t *variant = &wallis_variants[v];
+        wallis_result_t *r = &results[v];
+
+        uint64_t start_time = time_us_64();
+        volatile double pi = variant->run(n);
+        r->time_us = time_us_64() - start_time;
+        r->variant = variant;
+        r->pi = pi;
+        r->baseline_us = 0;
+
+        // the legacy kernels come first, so the baseline has always run already
+        for (size_t b = 0; b < v && variant->baseline; b++) {
+            if (strcmp(results[b].variant->name, variant->baseline) == 0) {
+                r->baseline_us = results[b].time_us;
+            }
+        }
+    }
+}
+
+
+void wallis_print_results(const wallis_result_t *results) {
+    printf("\t         Kernel         |   Calculated PI   |   Time (us)   |   Speedup\n");
+    printf("\t--------------------------------------------------------------------------\n");
+    for (size_t v = 0; v < wallis_variant_count; v++) {
+        const wallis_result_t *r = &results[v];
+        printf("\t  %-21s |   %.11f   |   %10llu  |", r->variant->name, r->pi, r->time_us);
+        if (r->baseline_us && r->time_us) {
+            printf("   %6.2fx\n", (double)r->baseline_us / (double)r->time_us);
+        } else {
+            printf("       -\n");
+        }
+    }
+    printf("\n");
+}
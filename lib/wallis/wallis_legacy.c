@@ -0,0 +1,35 @@
+/*****************************************************************//**
+ * \file   wallis_legacy.c
+ * \brief  the original wallis product kernels from lab02 and lab07
+ *
+ * Kept unchanged as the baseline the template instantiations are
+ * measured against. lab02 runs them directly, so this file stays
+ * plain C that the Wokwi simulator can build next to lab02.c.
+ *
+ * \author marco
+ * \date   February 2025
+ *********************************************************************/
+
+#include "wallis.h"
+
+
+float wallis_prod_float_legacy(size_t n) {
+	float product = 1.0f;
+	for (size_t i = 1; i <= n; i++) {
+		float term = (2.0f * i) / (2.0f * i - 1.0f);
+		product *= term;
+		product *= (2.0f * i) / (2.0f * i + 1.0f);
+	}
+	return product * 2.0f;
+}
+
+
+double wallis_prod_double_legacy(size_t n) {
+	double product = 1.0;
+	for (size_t i = 1; i <= n; i++) {
+		double term = (2.0 * i) / (2.0 * i - 1.0);
+		product *= term;
+		product *= (2.0 * i) / (2.0 * i + 1.0);
+	}
+	return product * 2.0;
+}
@@ -0,0 +1,142 @@
+/*****************************************************************//**
+ * \file   xip_cache.h
+ * \brief  XIP cache as 16 KB of extra SRAM, and pinning flash code in it
+ *
+ * The RP2040's flash cache is 16 KB, two-way set associative with
+ * 8 byte lines. It can be used in one of two ways here:
+ *
+ * cache-as-SRAM   with the cache disabled its memory is ordinary
+ *                 single-cycle SRAM at 0x15000000 (XIP_SRAM_BASE).
+ *                 Functions and data marked XIP_SRAM_FUNC/XIP_SRAM_DATA
+ *                 are linked to run there and copied in from flash by
+ *                 xip_cache_sram_load(). Everything else then runs
+ *                 from flash uncached until xip_cache_sram_release().
+ *
+ * pinning         with the cache enabled, lines written through the
+ *                 cached alias are held in the cache rather than
+ *                 evicted. xip_cache_pin() writes each line of a flash
+ *                 range back with its own contents, then checks with
+ *                 the hit counters that the lines survive a sweep of
+ *                 32 KB of other flash; if they don't, it flushes and
+ *                 returns false, so the caller knows the code is only
+ *                 cached normally. At most one way (8 KB) can be
+ *                 pinned, so every set keeps a way for the rest of the
+ *                 program. Functions marked XIP_PIN_FUNC are linked
+ *                 together for xip_cache_pin_marked().
+ *
+ * Flushing the cache (which the SDK's flash_range_* functions do)
+ * unpins everything; it doesn't touch the cache-as-SRAM contents, but
+ * enabling the cache does. The two modes are exclusive: loading the
+ * SRAM section drops any pinned lines.
+ *
+ * The sections are added to the SDK's linker script by xip_cache.ld,
+ * which linking the library pulls in. Code in XIP SRAM is out of BL
+ * range of flash and SRAM, so the linker reaches what it calls through
+ * long branch veneers.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#ifndef XIP_CACHE_H
+#define XIP_CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define XIP_CACHE_SIZE (16 * 1024)
+#define XIP_CACHE_LINE 8
+
+// the most that can be pinned and still leave a way per set
+#define XIP_CACHE_PIN_MAX (XIP_CACHE_SIZE / 2)
+
+// run a function from XIP SRAM, used as e.g. float XIP_SRAM_FUNC(kernel)(size_t n)
+#define XIP_SRAM_FUNC(func_name) __attribute__((section(".xip_sram.text." #func_name), noinline)) func_name
+
+// keep a variable in XIP SRAM, initialised from flash by xip_cache_sram_load()
+#define XIP_SRAM_DATA(var_name) __attribute__((section(".xip_sram.data." #var_name))) var_name
+
+// keep a flash function in the range pinned by xip_cache_pin_marked()
+#define XIP_PIN_FUNC(func_name) __attribute__((section(".xip_pin." #func_name), noinline)) func_name
+
+
+/**
+ * @brief disable the cache and copy the XIP_SRAM_FUNC/XIP_SRAM_DATA section into its memory
+ *
+ * must be called before anything in the section is used, and again
+ * after xip_cache_sram_release()
+ */
+void xip_cache_sram_load(void);
+
+
+/**
+ * @brief flush and re-enable the cache, losing the XIP SRAM contents
+ */
+void xip_cache_sram_release(void);
+
+
+/**
+ * @brief true between xip_cache_sram_load() and xip_cache_sram_release()
+ */
+bool xip_cache_sram_active(void);
+
+
+/**
+ * @brief bytes of XIP SRAM taken by the section
+ */
+size_t xip_cache_sram_used(void);
+
+
+/**
+ * @brief pin the cache lines holding a range of flash
+ *
+ * the cache must be enabled and not in use as SRAM
+ *
+ * @param addr start of the range in the cached flash alias, e.g. a function pointer
+ * @param size length in bytes, rounded out to whole lines
+ * @return true if the lines were pinned and stayed resident, false otherwise (nothing is left pinned)
+ */
+bool xip_cache_pin(const void *addr, size_t size);
+
+
+/**
+ * @brief pin every XIP_PIN_FUNC function
+ *
+ * @return as xip_cache_pin(), true if there is nothing to pin
+ */
+bool xip_cache_pin_marked(void);
+
+
+/**
+ * @brief bytes of flash currently pinned
+ */
+size_t xip_cache_pinned(void);
+
+
+/**
+ * @brief flush the cache, which unpins every line
+ */
+void xip_cache_unpin_all(void);
+
+
+/**
+ * @brief zero the cache hit and access counters
+ */
+void xip_cache_counters_reset(void);
+
+
+/**
+ * @brief hits and accesses since the last xip_cache_counters_reset()
+ */
+void xip_cache_counters(uint32_t *hits, uint32_t *accesses);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // XIP_CACHE_H
@@ -0,0 +1,144 @@
+/*****************************************************************//**
+ * \file   xip_cache.c
+ * \brief  XIP cache as 16 KB of extra SRAM, and pinning flash code in it
+ *
+ * XIP_CTRL is programmed directly, as lab07 already does for the
+ * enable bit. Reading FLUSH stalls until a flush has completed.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include <string.h>
+#include "xip_cache.h"
+#include "pico/stdlib.h"
+#include "hardware/structs/xip_ctrl.h"
+#include "hardware/sync.h"
+
+// from xip_cache.ld
+extern uint8_t __xip_sram_start__[];
+extern uint8_t __xip_sram_end__[];
+extern uint8_t __xip_sram_source__[];
+extern uint8_t __xip_pin_start__[];
+extern uint8_t __xip_pin_end__[];
+
+// flash swept to evict whatever isn't pinned: both ways of every set
+#define EVICT_SWEEP (2 * XIP_CACHE_SIZE)
+
+static bool sram_active;
+static size_t pinned_bytes;
+
+
+static void cache_flush(void) {
+    xip_ctrl_hw->flush = 1;
+    (void)xip_ctrl_hw->flush;
+}
+
+
+static void cache_enable(bool en) {
+    uint32_t reg = xip_ctrl_hw->ctrl;
+    xip_ctrl_hw->ctrl = en ? reg | XIP_CTRL_EN_BITS : reg & ~XIP_CTRL_EN_BITS;
+}
+
+
+void xip_cache_sram_load(void) {
+    cache_enable(false);
+    pinned_bytes = 0;
+    memcpy(__xip_sram_start__, __xip_sram_source__, xip_cache_sram_used());
+    sram_active = true;
+}
+
+
+void xip_cache_sram_release(void) {
+    // the tags still describe what was cached before the memory was overwritten
+    cache_flush();
+    cache_enable(true);
+    sram_active = false;
+}
+
+
+bool xip_cache_sram_active(void) {
+    return sram_active;
+}
+
+
+size_t xip_cache_sram_used(void) {
+    return (size_t)(__xip_sram_end__ - __xip_sram_start__);
+}
+
+
+/**
+ * @brief sweep other flash through the cache, then count how many lines of [start, end) still hit
+ *
+ * runs from RAM with interrupts off, so its own fetches and handlers don't touch the counters
+ */
+static bool __not_in_flash_func(pinned_lines_hit)(uintptr_t start, uintptr_t end) {
+    uintptr_t offset = start - XIP_MAIN_BASE;
+    uintptr_t sweep = XIP_MAIN_BASE + (offset < PICO_FLASH_SIZE_BYTES / 2 ? PICO_FLASH_SIZE_BYTES / 2 : 0);
+
+    uint32_t save = save_and_disable_interrupts();
+    for (uintptr_t a = sweep; a < sweep + EVICT_SWEEP; a += XIP_CACHE_LINE) {
+        (void)*(volatile uint32_t *)a;
+    }
+    xip_ctrl_hw->ctr_hit = 0;
+    xip_ctrl_hw->ctr_acc = 0;
+    for (uintptr_t a = start; a < end; a += XIP_CACHE_LINE) {
+        (void)*(volatile uint32_t *)a;
+    }
+    uint32_t hits = xip_ctrl_hw->ctr_hit;
+    restore_interrupts(save);
+
+    return hits >= (end - start) / XIP_CACHE_LINE;
+}
+
+
+bool xip_cache_pin(const void *addr, size_t size) {
+    uintptr_t start = (uintptr_t)addr & ~(uintptr_t)(XIP_CACHE_LINE - 1);
+    uintptr_t end = ((uintptr_t)addr + size + XIP_CACHE_LINE - 1) & ~(uintptr_t)(XIP_CACHE_LINE - 1);
+    if (sram_active || !(xip_ctrl_hw->ctrl & XIP_CTRL_EN_BITS) || start < XIP_MAIN_BASE ||
+        end > XIP_MAIN_BASE + PICO_FLASH_SIZE_BYTES || pinned_bytes + (end - start) > XIP_CACHE_PIN_MAX) {
+        return false;
+    }
+
+    // write each line back through the cached alias with its own contents, read uncached
+    for (uintptr_t a = start; a < end; a += 4) {
+        uint32_t word = *(volatile uint32_t *)(a - XIP_MAIN_BASE + XIP_NOCACHE_NOALLOC_BASE);
+        *(volatile uint32_t *)a = word;
+    }
+    pinned_bytes += end - start;
+
+    if (!pinned_lines_hit(start, end)) {
+        xip_cache_unpin_all();
+        return false;
+    }
+    return true;
+}
+
+
+bool xip_cache_pin_marked(void) {
+    size_t size = (size_t)(__xip_pin_end__ - __xip_pin_start__);
+    return size == 0 || xip_cache_pin(__xip_pin_start__, size);
+}
+
+
+size_t xip_cache_pinned(void) {
+    return pinned_bytes;
+}
+
+
+void xip_cache_unpin_all(void) {
+    cache_flush();
+    pinned_bytes = 0;
+}
+
+
+void xip_cache_counters_reset(void) {
+    xip_ctrl_hw->ctr_hit = 0;
+    xip_ctrl_hw->ctr_acc = 0;
+}
+
+
+void xip_cache_counters(uint32_t *hits, uint32_t *accesses) {
+    *hits = xip_ctrl_hw->ctr_hit;
+    *accesses = xip_ctrl_hw->ctr_acc;
+}
@@ -0,0 +1,312 @@
+/*****************************************************************//**
+ * \file   bench_history.cpp
+ * \brief  host side of the flash benchmark history (lib/bench_log)
+ *
+ * Runs the firmware's bench_store.c on a simulated NOR flash held in
+ * an image file: erase sets a sector to 0xff, programming a page can
+ * only clear bits, and every erase is counted.
+ *
+ *   bench_history dump <image>
+ *   bench_history add [--sectors N] [--threshold permille] <image> <build> <scenario> <value>
+ *   bench_history --selftest
+ *
+ * dump prints the history in an image read off a board (see
+ * bench_log.h for the picotool command). add appends a result to an
+ * image, creating it blank if needed, after comparing it with its
+ * baseline like the firmware does, and exits with 1 on a regression,
+ * so scripts can keep a history of their own. --selftest fills a
+ * small store past wrapping, tears a write as a power cut would and
+ * checks the recovery, the order, the wear and the regression check;
+ * it needs no hardware.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "bench_store.h"
+#include "selftest.hpp"
+
+namespace {
+
+/**
+ * @brief NOR flash simulation behind a bench_store_backend_t
+ */
+class nor_flash {
+public:
+    explicit nor_flash(uint32_t sectors)
+        : mem_(size_t(sectors) * BENCH_STORE_SECTOR_SIZE, 0xff), erases_(sectors, 0) {
+        backend_.read = read;
+        backend_.erase = erase;
+        backend_.program = program;
+        backend_.ctx = this;
+        backend_.sectors = sectors;
+    }
+
+    const bench_store_backend_t* backend() const { return &backend_; }
+    std::vector<uint8_t>& mem() { return mem_; }
+    const std::vector<uint32_t>& erases() const { return erases_; }
+
+    // the next program stops after this many changed bytes, as if the power went
+    void cut_power_after(int bytes) { cut_ = bytes; }
+
+private:
+    static bool read(void* ctx, uint32_t offset, void* buf, uint32_t len) {
+        auto* f = static_cast<nor_flash*>(ctx);
+        if (size_t(offset) + len > f->mem_.size()) {
+            return false;
+        }
+        std::memcpy(buf, &f->mem_[offset], len);
+        return true;
+    }
+
+    static bool erase(void* ctx, uint32_t offset) {
+        auto* f = static_cast<nor_flash*>(ctx);
+        if (offset % BENCH_STORE_SECTOR_SIZE || offset >= f->mem_.size()) {
+            return false;
+        }
+        std::fill_n(&f->mem_[offset], BENCH_STORE_SECTOR_SIZE, 0xff);
+        f->erases_[offset / BENCH_STORE_SECTOR_SIZE]++;
+        return true;
+    }
+
+    static bool program(void* ctx, uint32_t offset, const void* page) {
+        auto* f = static_cast<nor_flash*>(ctx);
+        if (offset % BENCH_STORE_PAGE_SIZE || offset >= f->mem_.size()) {
+            return false;
+        }
+        const auto* src = static_cast<const uint8_t*>(page);
+        for (uint32_t i = 0; i < BENCH_STORE_PAGE_SIZE; i++) {
+            if (src[i] == 0xff) {
+                continue;
+            }
+            if (f->cut_ == 0) {
+                break;
+            }
+            if (f->cut_ > 0) {
+                f->cut_--;
+            }
+            f->mem_[offset + i] &= src[i];
+        }
+        f->cut_ = -1;
+        return true;
+    }
+
+    std::vector<uint8_t> mem_;
+    std::vector<uint32_t> erases_;
+    bench_store_backend_t backend_;
+    int cut_ = -1;
+};
+
+
+void print_record(const bench_record_t* rec, void* arg) {
+    (void)arg;
+    std::printf("%8u  %08x  %-12.12s  %10u\n", rec->seq, rec->build_id, rec->scenario, rec->value);
+}
+
+
+void collect(const bench_record_t* rec, void* arg) {
+    static_cast<std::vector<bench_record_t>*>(arg)->push_back(*rec);
+}
+
+
+bool load(const char* path, std::vector<uint8_t>& image) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    image.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+
+bool save(const char* path, const std::vector<uint8_t>& image) {
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(image.data()), std::streamsize(image.size()));
+    return bool(out);
+}
+
+
+/**
+ * @brief compare a result with its baseline as bench_log_result() does
+ *
+ * @return true if it is a regression
+ */
+bool compare(const bench_store_t& store, uint32_t build, const char* scenario, uint32_t value, int32_t threshold) {
+    bench_record_t base;
+    std::printf("history %s: %u us", scenario, value);
+    if (!bench_store_baseline(&store, build, scenario, &base)) {
+        std::printf(", no baseline\n");
+        return false;
+    }
+    int32_t change = bench_store_change_permille(base.value, value);
+    bool regression = change > threshold;
+    std::printf(", baseline %u us (build %08x) %+.1f%%%s\n", base.value, base.build_id, change / 10.0,
+                regression ? " REGRESSION" : "");
+    return regression;
+}
+
+
+int dump(const char* path) {
+    std::vector<uint8_t> image;
+    if (!load(path, image)) {
+        std::perror(path);
+        return 1;
+    }
+    if (image.size() % BENCH_STORE_SECTOR_SIZE || image.size() < 2 * BENCH_STORE_SECTOR_SIZE) {
+        std::fprintf(stderr, "%s: not a whole number of sectors (at least 2)\n", path);
+        return 1;
+    }
+    nor_flash flash(uint32_t(image.size() / BENCH_STORE_SECTOR_SIZE));
+    flash.mem() = image;
+
+    bench_store_t store;
+    bench_store_mount(&store, flash.backend());
+    std::printf("     seq  build     scenario           value\n");
+    bench_store_foreach(&store, print_record, nullptr);
+    if (store.corrupt) {
+        std::printf("%u corrupt records skipped\n", store.corrupt);
+    }
+    return 0;
+}
+
+
+int add(const char* path, uint32_t sectors, int32_t threshold, uint32_t build, const char* scenario, uint32_t value) {
+    std::vector<uint8_t> image;
+    if (load(path, image)) {
+        sectors = uint32_t(image.size() / BENCH_STORE_SECTOR_SIZE);
+    }
+    nor_flash flash(sectors);
+    if (!image.empty()) {
+        if (image.size() != flash.mem().size() || sectors < 2) {
+            std::fprintf(stderr, "%s: not a whole number of sectors (at least 2)\n", path);
+            return 1;
+        }
+        flash.mem() = image;
+    }
+
+    bench_store_t store;
+    bench_store_mount(&store, flash.backend());
+    bool regression = compare(store, build, scenario, value, threshold);
+    if (!bench_store_append(&store, build, scenario, value) || !save(path, flash.mem())) {
+        std::fprintf(stderr, "%s: write failed\n", path);
+        return 1;
+    }
+    return regression ? 1 : 0;
+}
+
+
+/**
+ * @brief exercise the store on a small simulated flash and check the results
+ */
+int selftest() {
+    const uint32_t sectors = 4;
+    const uint32_t slots = sectors * BENCH_STORE_RECORDS_PER_SECTOR;
+    selftest_checks check;
+
+    nor_flash flash(sectors);
+    bench_store_t store;
+    check(bench_store_mount(&store, flash.backend()) && store.next == 0 && store.seq == 0, "blank mount");
+
+    // past the end of the ring, the current sector partly refilled
+    const uint32_t appends = slots + 88;
+    bool appended = true;
+    for (uint32_t i = 0; i < appends; i++) {
+        appended &= bench_store_append(&store, i & 1, i & 1 ? "odd" : "even", i);
+    }
+    check(appended, "appends");
+
+    std::vector<bench_record_t> recs;
+    bench_store_foreach(&store, collect, &recs);
+    uint32_t kept = slots - BENCH_STORE_RECORDS_PER_SECTOR + 88;
+    check(recs.size() == kept, "records kept after wrapping");
+    check(!recs.empty() && recs.front().seq == appends - kept && recs.back().seq == appends - 1, "oldest and newest");
+    bool ordered = true;
+    for (size_t i = 1; i < recs.size(); i++) {
+        ordered &= recs[i].seq == recs[i - 1].seq + 1 && recs[i].value == recs[i].seq;
+    }
+    check(ordered, "records in order");
+
+    auto wear = std::minmax_element(flash.erases().begin(), flash.erases().end());
+    check(*wear.first == 1 && *wear.second == 2, "erases spread over the sectors");
+
+    bench_store_t again;
+    bench_store_mount(&again, flash.backend());
+    check(again.next == store.next && again.seq == store.seq && again.corrupt == 0, "remount finds the end");
+
+    // power cut in the middle of a record: the write fails and the remount skips it
+    flash.cut_power_after(10);
+    check(!bench_store_append(&store, 7, "torn", 1), "torn write reported");
+    bench_store_mount(&store, flash.backend());
+    check(store.corrupt == 1 && store.seq == appends, "torn record skipped on mount");
+    check(bench_store_append(&store, 7, "after", 2), "append after a torn record");
+    recs.clear();
+    bench_store_foreach(&store, collect, &recs);
+    check(recs.back().seq == appends && !std::strcmp(recs.back().scenario, "after"), "record after the torn one");
+
+    // baselines come from the newest result of another build
+    bench_store_append(&store, 0xa, "s1 float", 1000);
+    bench_store_append(&store, 0xb, "s1 float", 1100);
+    bench_record_t base;
+    check(bench_store_baseline(&store, 0xb, "s1 float", &base) && base.value == 1000, "baseline of build b");
+    check(bench_store_baseline(&store, 0xc, "s1 float", &base) && base.value == 1100, "baseline of build c");
+    check(!bench_store_baseline(&store, 0xa, "s2 float", &base), "no baseline for a new scenario");
+    check(bench_store_change_permille(1000, 1100) == 100, "10% slower");
+    check(bench_store_change_permille(1000, 950) == -50, "5% faster");
+
+    // names are cut to fit, and compared the same way
+    bench_store_append(&store, 0xa, "a very long scenario name", 5);
+    check(bench_store_baseline(&store, 0xb, "a very long scenario", &base) && base.value == 5, "truncated names");
+
+    check(bench_store_crc32("123456789", 9) == 0xcbf43926, "CRC-32 check value");
+
+    return check.finish();
+}
+
+
+void usage() {
+    std::fprintf(stderr, "usage: bench_history dump <image>\n"
+                         "       bench_history add [--sectors N] [--threshold permille] <image> <build> <scenario> <value>\n"
+                         "       bench_history --selftest\n");
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    if (argc >= 2 && std::strcmp(argv[1], "--selftest") == 0) {
+        return selftest();
+    }
+    if (argc == 3 && std::strcmp(argv[1], "dump") == 0) {
+        return dump(argv[2]);
+    }
+    if (argc >= 2 && std::strcmp(argv[1], "add") == 0) {
+        uint32_t sectors = 8;
+        int32_t threshold = 50;
+        std::vector<const char*> args;
+        for (int i = 2; i < argc; i++) {
+            if (std::strcmp(argv[i], "--sectors") == 0 && i + 1 < argc) {
+                sectors = uint32_t(std::strtoul(argv[++i], nullptr, 0));
+            } else if (std::strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+                threshold = int32_t(std::strtol(argv[++i], nullptr, 0));
+            } else {
+                args.push_back(argv[i]);
+            }
+        }
+        if (args.size() == 4 && sectors >= 2) {
+            return add(args[0], sectors, threshold, uint32_t(std::strtoul(args[1], nullptr, 16)), args[2],
+                       uint32_t(std::strtoul(args[3], nullptr, 0)));
+        }
+    }
+    usage();
+    return 2;
+}
@@ -0,0 +1,292 @@
+/*****************************************************************//**
+ * \file   elf_file.cpp
+ * \brief  minimal ELF reader for the host tools
+ *
+ * Fields are read by offset rather than through <elf.h> so the tools
+ * build on hosts without it.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include "elf_file.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+
+#include <cxxabi.h>
+
+
+namespace {
+
+constexpr uint32_t SHT_SYMTAB = 2;
+constexpr uint32_t SHT_RELA = 4;
+constexpr uint8_t STT_NOTYPE = 0;
+constexpr uint16_t SHN_UNDEF = 0;
+constexpr uint16_t SHN_LORESERVE = 0xff00;
+
+/**
+ * @brief little-endian field reader over the whole file, out of range reads give 0
+ */
+class reader {
+public:
+    explicit reader(const std::vector<uint8_t>& data) : data_(data) {}
+
+    uint64_t get(uint64_t offset, unsigned size) const {
+        if (offset + size > data_.size()) {
+            return 0;
+        }
+        uint64_t value = 0;
+        for (unsigned i = 0; i < size; i++) {
+            value |= uint64_t(data_[offset + i]) << (8 * i);
+        }
+        return value;
+    }
+
+    uint8_t u8(uint64_t offset) const { return uint8_t(get(offset, 1)); }
+    uint16_t u16(uint64_t offset) const { return uint16_t(get(offset, 2)); }
+    uint32_t u32(uint64_t offset) const { return uint32_t(get(offset, 4)); }
+    uint64_t u64(uint64_t offset) const { return get(offset, 8); }
+
+    std::string str(uint64_t offset) const {
+        std::string s;
+        while (offset < data_.size() && data_[offset]) {
+            s.push_back(char(data_[offset++]));
+        }
+        return s;
+    }
+
+    uint64_t size() const { return data_.size(); }
+
+private:
+    const std::vector<uint8_t>& data_;
+};
+
+
+/**
+ * @brief a section header with the file offsets needed to read its contents
+ */
+struct raw_section {
+    elf_section header;
+    uint32_t name_offset;
+    uint64_t file_offset;
+    uint32_t link;
+    uint64_t entsize;
+};
+
+
+/**
+ * @brief relocation entries of one SHT_REL or SHT_RELA section
+ */
+void read_relocations(const reader& r, const raw_section& s, bool is_64bit, std::vector<elf_relocation>& out) {
+    bool rela = s.header.type == SHT_RELA;
+    uint64_t entsize = s.entsize ? s.entsize : (is_64bit ? 16 : 8) + (rela ? (is_64bit ? 8 : 4) : 0);
+    for (uint64_t off = 0; off + entsize <= s.header.size; off += entsize) {
+        uint64_t e = s.file_offset + off;
+        elf_relocation rel;
+        if (is_64bit) {
+            uint64_t info = r.u64(e + 8);
+            rel.offset = r.u64(e);
+            rel.type = uint32_t(info);
+            rel.symbol = uint32_t(info >> 32);
+            rel.addend = rela ? int64_t(r.u64(e + 16)) : 0;
+        } else {
+            uint32_t info = r.u32(e + 4);
+            rel.offset = r.u32(e);
+            rel.type = info & 0xff;
+            rel.symbol = info >> 8;
+            rel.addend = rela ? int32_t(r.u32(e + 8)) : 0;
+        }
+        out.push_back(rel);
+    }
+}
+
+} // namespace
+
+
+bool elf_file::load(const std::string& path, std::string& error) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+    data_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    const std::vector<uint8_t>& data = data_;
+    reader r(data);
+
+    if (data.size() < 52 || r.u32(0) != 0x464c457f) {
+        error = path + " is not an ELF file";
+        return false;
+    }
+    if (r.u8(5) != 1) {
+        error = path + " is not little-endian";
+        return false;
+    }
+
+    is_64bit_ = r.u8(4) == 2;
+    machine_ = r.u16(18);
+
+    uint64_t shoff = is_64bit_ ? r.u64(40) : r.u32(32);
+    uint16_t shentsize = r.u16(is_64bit_ ? 58 : 46);
+    uint16_t shnum = r.u16(is_64bit_ ? 60 : 48);
+    uint16_t shstrndx = r.u16(is_64bit_ ? 62 : 50);
+
+    if (shoff == 0 || shnum == 0 || shoff + uint64_t(shnum) * shentsize > r.size()) {
+        error = path + " has no section headers";
+        return false;
+    }
+
+    std::vector<raw_section> raw(shnum);
+    for (uint16_t i = 0; i < shnum; i++) {
+        uint64_t sh = shoff + uint64_t(i) * shentsize;
+        raw_section& s = raw[i];
+        s.name_offset = r.u32(sh);
+        s.header.type = r.u32(sh + 4);
+        if (is_64bit_) {
+            s.header.flags = r.u64(sh + 8);
+            s.header.addr = r.u64(sh + 16);
+            s.file_offset = r.u64(sh + 24);
+            s.header.size = r.u64(sh + 32);
+            s.link = r.u32(sh + 40);
+            s.header.info = r.u32(sh + 44);
+            s.header.align = r.u64(sh + 48);
+            s.entsize = r.u64(sh + 56);
+        } else {
+            s.header.flags = r.u32(sh + 8);
+            s.header.addr = r.u32(sh + 12);
+            s.file_offset = r.u32(sh + 16);
+            s.header.size = r.u32(sh + 20);
+            s.link = r.u32(sh + 24);
+            s.header.info = r.u32(sh + 28);
+            s.header.align = r.u32(sh + 32);
+            s.entsize = r.u32(sh + 36);
+        }
+    }
+
+    sections_.clear();
+    offsets_.clear();
+    uint64_t shstr = shstrndx < shnum ? raw[shstrndx].file_offset : 0;
+    for (raw_section& s : raw) {
+        s.header.name = shstr ? r.str(shstr + s.name_offset) : std::string();
+        sections_.push_back(s.header);
+        offsets_.push_back(s.file_offset);
+    }
+
+    // only .symtab names local functions, a stripped image has nothing to offer
+    symbols_.clear();
+    symtab_.clear();
+    relocations_.clear();
+    for (const raw_section& s : raw) {
+        if (s.header.type == elf_section::SHT_REL || s.header.type == SHT_RELA) {
+            read_relocations(r, s, is_64bit_, relocations_[s.header.info]);
+        }
+    }
+    for (const raw_section& s : raw) {
+        if (s.header.type != SHT_SYMTAB || s.link >= shnum) {
+            continue;
+        }
+        uint64_t strtab = raw[s.link].file_offset;
+        uint64_t entsize = s.entsize ? s.entsize : (is_64bit_ ? 24 : 16);
+        for (uint64_t off = 0; off + entsize <= s.header.size; off += entsize) {
+            uint64_t sym = s.file_offset + off;
+            elf_symbol e;
+            uint8_t info;
+            if (is_64bit_) {
+                info = r.u8(sym + 4);
+                e.section = r.u16(sym + 6);
+                e.addr = r.u64(sym + 8);
+                e.size = r.u64(sym + 16);
+            } else {
+                e.addr = r.u32(sym + 4);
+                e.size = r.u32(sym + 8);
+                info = r.u8(sym + 12);
+                e.section = r.u16(sym + 14);
+            }
+            e.type = info & 0xf;
+            e.name = r.str(strtab + r.u32(sym));
+            symtab_.push_back(e);
+            if (off == 0) {
+                continue; // the null symbol
+            }
+
+            // skip undefined and absolute symbols, and the ARM $t/$d mapping symbols
+            if (e.section == SHN_UNDEF || e.section >= SHN_LORESERVE || e.name.empty() || e.name[0] == '$') {
+                continue;
+            }
+            if (e.type == elf_symbol::STT_FUNC && machine_ == EM_ARM) {
+                e.addr &= ~uint64_t(1);
+            }
+            symbols_.push_back(std::move(e));
+        }
+    }
+
+    std::sort(symbols_.begin(), symbols_.end(), [](const elf_symbol& a, const elf_symbol& b) {
+        return a.addr != b.addr ? a.addr < b.addr : a.size > b.size;
+    });
+
+    // code labels in .S files carry no type, count those in executable sections as functions too
+    auto is_code = [&](const elf_symbol& e) {
+        return e.type == elf_symbol::STT_FUNC ||
+               (e.type == STT_NOTYPE && e.section < shnum && (raw[e.section].header.flags & elf_section::SHF_EXECINSTR));
+    };
+
+    functions_.clear();
+    for (size_t i = 0; i < symbols_.size(); i++) {
+        // aliases share an address, keep the first (largest) one
+        const elf_symbol& e = symbols_[i];
+        if (is_code(e) && (functions_.empty() || symbols_[functions_.back()].addr != e.addr)) {
+            functions_.push_back(i);
+        }
+    }
+    return true;
+}
+
+
+std::vector<uint8_t> elf_file::contents(size_t section) const {
+    if (section >= sections_.size() || sections_[section].type == elf_section::SHT_NOBITS) {
+        return {};
+    }
+    uint64_t begin = std::min<uint64_t>(offsets_[section], data_.size());
+    uint64_t end = std::min<uint64_t>(begin + sections_[section].size, data_.size());
+    return std::vector<uint8_t>(data_.begin() + begin, data_.begin() + end);
+}
+
+
+std::vector<elf_relocation> elf_file::relocations(size_t section) const {
+    auto it = relocations_.find(uint32_t(section));
+    return it == relocations_.end() ? std::vector<elf_relocation>() : it->second;
+}
+
+
+const elf_symbol* elf_file::function_at(uint64_t addr) const {
+    auto it = std::upper_bound(functions_.begin(), functions_.end(), addr,
+                               [this](uint64_t a, size_t i) { return a < symbols_[i].addr; });
+    if (it == functions_.begin()) {
+        return nullptr;
+    }
+    const elf_symbol* f = &symbols_[*(it - 1)];
+    if (f->size) {
+        return addr < f->addr + f->size ? f : nullptr;
+    }
+    return it != functions_.end() || addr - f->addr < 0x1000 ? f : nullptr;
+}
+
+
+std::string elf_file::function_name(uint64_t addr) const {
+    const elf_symbol* f = function_at(addr);
+    return f ? demangle(f->name) : "??";
+}
+
+
+std::string elf_file::demangle(const std::string& name) {
+    if (name.compare(0, 2, "_Z") != 0) {
+        return name;
+    }
+    int status = 0;
+    char* plain = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status);
+    std::string result = status == 0 && plain ? plain : name;
+    std::free(plain);
+    return result;
+}
@@ -0,0 +1,140 @@
+/*****************************************************************//**
+ * \file   elf_file.hpp
+ * \brief  minimal ELF reader for the host tools
+ *
+ * Loads the section headers and the symbol table of an ELF file so
+ * the tools can map target addresses back to function names and
+ * account for section sizes. Handles 32 and 64 bit little-endian
+ * files; the firmware images are ELF32 ARM. Section contents and
+ * relocations are kept for loading relocatable objects. Nothing
+ * beyond sections, symbols and relocations is parsed.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#ifndef ELF_FILE_HPP
+#define ELF_FILE_HPP
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+
+/**
+ * @brief a section header
+ */
+struct elf_section {
+    std::string name;
+    uint32_t type;
+    uint64_t flags;
+    uint64_t addr;
+    uint64_t size;
+    uint64_t align;
+    uint32_t info;          // the section a relocation section applies to
+
+    static constexpr uint32_t SHT_REL = 9;
+    static constexpr uint32_t SHT_NOBITS = 8;
+    static constexpr uint64_t SHF_WRITE = 0x1;
+    static constexpr uint64_t SHF_ALLOC = 0x2;
+    static constexpr uint64_t SHF_EXECINSTR = 0x4;
+};
+
+
+/**
+ * @brief a defined symbol from .symtab
+ */
+struct elf_symbol {
+    std::string name;
+    uint64_t addr;          // Thumb bit already cleared for ARM functions
+    uint64_t size;
+    uint8_t type;
+    uint16_t section;
+
+    static constexpr uint8_t STT_OBJECT = 1;
+    static constexpr uint8_t STT_FUNC = 2;
+    static constexpr uint8_t STT_SECTION = 3;
+    static constexpr uint16_t SHN_UNDEF = 0;
+};
+
+
+/**
+ * @brief a relocation of a relocatable object
+ */
+struct elf_relocation {
+    uint64_t offset;        // within the section it applies to
+    uint32_t type;
+    uint32_t symbol;        // index into symbol_table()
+    int64_t addend;         // 0 for SHT_REL, the addend is then in the section contents
+};
+
+
+class elf_file {
+public:
+    /**
+     * @brief read the file at path
+     *
+     * @return false with a message in error if it is not a usable ELF file
+     */
+    bool load(const std::string& path, std::string& error);
+
+    const std::vector<elf_section>& sections() const { return sections_; }
+
+    /**
+     * @brief defined symbols sorted by address
+     */
+    const std::vector<elf_symbol>& symbols() const { return symbols_; }
+
+    /**
+     * @brief every .symtab entry in index order, undefined and section symbols included
+     *
+     * addresses are as stored, with the Thumb bit
+     */
+    const std::vector<elf_symbol>& symbol_table() const { return symtab_; }
+
+    /**
+     * @brief contents of a section, empty for SHT_NOBITS
+     */
+    std::vector<uint8_t> contents(size_t section) const;
+
+    /**
+     * @brief relocations that apply to a section
+     */
+    std::vector<elf_relocation> relocations(size_t section) const;
+
+    /**
+     * @brief the function containing addr, or nullptr
+     *
+     * functions with no recorded size are taken to extend to the next function
+     */
+    const elf_symbol* function_at(uint64_t addr) const;
+
+    /**
+     * @brief demangled name of the function containing addr, or "??"
+     */
+    std::string function_name(uint64_t addr) const;
+
+    /**
+     * @brief demangle a C++ symbol name, other names are returned unchanged
+     */
+    static std::string demangle(const std::string& name);
+
+    uint16_t machine() const { return machine_; }
+    bool is_64bit() const { return is_64bit_; }
+
+    static constexpr uint16_t EM_ARM = 40;
+
+private:
+    std::vector<uint8_t> data_;
+    std::vector<uint64_t> offsets_;     // file offset of each section
+    std::vector<elf_section> sections_;
+    std::vector<elf_symbol> symbols_;
+    std::vector<elf_symbol> symtab_;
+    std::map<uint32_t, std::vector<elf_relocation>> relocations_;  // by the section they apply to
+    std::vector<size_t> functions_;    // indices of STT_FUNC entries in symbols_
+    uint16_t machine_ = 0;
+    bool is_64bit_ = false;
+};
+
+#endif // ELF_FILE_HPP
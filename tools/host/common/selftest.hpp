@@ -0,0 +1,47 @@
+/*****************************************************************//**
+ * \file   selftest.hpp
+ * \brief  the checks behind each host tool's --selftest
+ *
+ * A tool's selftest() runs its checks through one of these and
+ * returns finish(), so they all report the same way: each failed
+ * check on stderr, then "selftest ok" or "selftest FAILED", exiting
+ * 0 or 1. Each tool's CMakeLists.txt registers its --selftest with
+ * ctest.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#ifndef SELFTEST_HPP
+#define SELFTEST_HPP
+
+#include <cstdio>
+
+
+class selftest_checks {
+public:
+    /**
+     * @brief record a check, printing what if it failed
+     */
+    void operator()(bool cond, const char* what) {
+        if (!cond) {
+            std::fprintf(stderr, "selftest: %s\n", what);
+            ok_ = false;
+        }
+    }
+
+    /**
+     * @brief print the verdict
+     *
+     * @return the exit status, 0 if every check passed
+     */
+    int finish() const {
+        std::printf("selftest %s\n", ok_ ? "ok" : "FAILED");
+        return ok_ ? 0 : 1;
+    }
+
+private:
+    bool ok_ = true;
+};
+
+#endif // SELFTEST_HPP
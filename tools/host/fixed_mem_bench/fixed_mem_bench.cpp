@@ -0,0 +1,229 @@
+/*****************************************************************//**
+ * \file   fixed_mem_bench.cpp
+ * \brief  checks lib/fixed_mem and times it against the C library's malloc
+ *
+ * Runs the allocation patterns of fixed_mem_bench.hpp with the host
+ * malloc and with the fixed_mem arenas and prints the time per
+ * operation of each and the arena's high-water mark. The host malloc
+ * is not newlib's, so the ratios only hint at the Pico's; run the same
+ * patterns there with lab07's "mem" command.
+ *
+ *   fixed_mem_bench [--ops <n>]
+ *   fixed_mem_bench --selftest
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "fixed_mem.hpp"
+#include "fixed_mem_bench.hpp"
+#include "selftest.hpp"
+
+namespace {
+
+// counts live instances, to check the containers construct and destroy in pairs
+struct counted {
+    static int live;
+    int value;
+    explicit counted(int v) : value(v) { live++; }
+    counted(const counted& o) : value(o.value) { live++; }
+    counted& operator=(const counted& o) = default;
+    ~counted() { live--; }
+};
+int counted::live = 0;
+
+struct timer {
+    uint32_t deadline;
+    fixed_mem::list_link link;
+    fixed_mem::list_link expired;
+};
+
+
+int selftest() {
+    selftest_checks check;
+
+    {
+        fixed_mem::static_vector<counted, 4> v;
+        for (int i = 0; i < 4; i++) {
+            v.emplace_back(i);
+        }
+        check(v.full() && !v.push_back(counted(9)), "vector refuses when full");
+        v.erase(1);
+        check(v.size() == 3 && v[0].value == 0 && v[1].value == 2 && v[2].value == 3, "vector erase keeps order");
+        v.swap_erase(0);
+        check(v.size() == 2 && v[0].value == 3 && v[1].value == 2, "vector swap_erase");
+        check(counted::live == 2, "vector destroys what it removes");
+    }
+    check(counted::live == 0, "vector destroys its elements");
+
+    {
+        fixed_mem::ring<counted, 3> r;
+        check(r.push(counted(1)) && r.push(counted(2)) && r.push(counted(3)) && !r.push(counted(4)),
+              "ring refuses when full");
+        counted c(0);
+        check(r.pop(c) && c.value == 1, "ring pops oldest");
+        r.push(counted(4));
+        check(r.push_overwrite(counted(5)) && r.front().value == 3 && r.back().value == 5, "ring overwrite drops oldest");
+        check(r[1].value == 4 && r.size() == 3, "ring wraps");
+        r.clear();
+        check(r.empty() && !r.pop(c), "ring empty");
+        check(counted::live == 1, "ring destroys what it pops");
+    }
+    check(counted::live == 0, "ring destroys its elements");
+
+    {
+        timer t[3] = {{30, {}, {}}, {10, {}, {}}, {20, {}, {}}};
+        fixed_mem::intrusive_list<timer, &timer::link> pending;
+        fixed_mem::intrusive_list<timer, &timer::expired> expired;
+        for (timer& e : t) {
+            auto pos = pending.begin();
+            while (pos != pending.end() && pos->deadline < e.deadline) {
+                ++pos;
+            }
+            pending.insert(pos, e);
+        }
+        uint32_t order[3], n = 0;
+        for (timer& e : pending) {
+            order[n++] = e.deadline;
+        }
+        check(n == 3 && order[0] == 10 && order[1] == 20 && order[2] == 30, "list insert sorted");
+        expired.push_back(t[0]);
+        pending.remove(t[2]);
+        check(pending.size() == 2 && expired.size() == 1 && !t[2].link.linked(), "list remove");
+        check(t[0].link.linked() && t[0].expired.linked(), "element on two lists");
+        check(pending.pop_front() == &t[1] && &pending.front() == &t[0], "list pop_front");
+        check(expired.pop_front() == &t[0] && expired.pop_front() == nullptr, "list empty");
+    }
+
+    {
+        fixed_mem::min_heap<uint32_t, 8> h;
+        const uint32_t in[] = {50, 20, 70, 10, 40, 30, 60, 80};
+        for (uint32_t x : in) {
+            h.push(x);
+        }
+        check(h.full() && !h.push(5), "heap refuses when full");
+        check(h.remove_if([](uint32_t x) { return x == 30; }) && !h.remove_if([](uint32_t x) { return x == 99; }),
+              "heap remove_if");
+        uint32_t last = 0;
+        bool sorted = true;
+        size_t n = 0;
+        while (!h.empty()) {
+            sorted &= h.top() >= last && h.top() != 30;
+            last = h.top();
+            h.pop();
+            n++;
+        }
+        check(sorted && n == 7, "heap pops smallest first");
+    }
+
+    {
+        fixed_mem::static_bump_arena<64> a;
+        void* p = a.allocate(10, 1);
+        auto m = a.mark();
+        {
+            fixed_mem::arena_scope scope(a);
+            uint32_t* w = a.create_array<uint32_t>(4);
+            check(w && reinterpret_cast<uintptr_t>(w) % alignof(uint32_t) == 0, "arena aligns");
+            check(a.allocate(64) == nullptr, "arena refuses when out of room");
+        }
+        check(p && a.mark() == m, "arena scope rewinds");
+        fixed_mem::arena_stats s = a.stats();
+        check(s.capacity == 64 && s.used == 10 && s.high_water == 28 && s.failures == 1, "arena stats");
+        a.reset();
+        check(a.allocate(64, 1) != nullptr && a.create_array<uint32_t>(SIZE_MAX / 2) == nullptr, "arena reset, overflow");
+    }
+
+    {
+        fixed_mem::pool<counted, 3> p;
+        counted* a = p.create(1);
+        counted* b = p.create(2);
+        counted* c = p.create(3);
+        check(a && b && c && p.create(4) == nullptr, "pool refuses when full");
+        p.destroy(b);
+        counted* d = p.create(5);
+        check(d == b && d->value == 5, "pool reuses a freed block");
+        check(p.owns(a) && !p.owns(&check), "pool owns");
+        p.destroy(a);
+        p.destroy(c);
+        p.destroy(d);
+        fixed_mem::arena_stats s = p.stats();
+        check(s.capacity == 3 && s.used == 0 && s.high_water == 3 && s.failures == 1, "pool stats");
+        check(counted::live == 0, "pool destroys");
+    }
+
+    {
+        fixed_mem::per_core<fixed_mem::static_bump_arena<32>> arenas;
+        arenas[1].allocate(8);
+        check(&arenas.local() == &arenas[0] && arenas[0].mark() == 0 && arenas[1].mark() == 8, "per core");
+    }
+
+    {
+        uint32_t ticks = 0;
+        fixed_mem::bench_result r[fixed_mem::BENCH_PATTERNS];
+        fixed_mem::benchmark([&] { return ticks++; }, 1000, r);
+        bool fits = true;
+        for (const fixed_mem::bench_result& e : r) {
+            fits &= e.fixed.failures == 0 && e.malloc_failures == 0 && e.fixed.used == 0;
+        }
+        check(fits, "benchmark arenas fit and are empty after");
+        check(r[0].fixed.high_water == 8 && r[1].fixed.high_water == 16 && r[2].fixed.high_water == 16,
+              "benchmark pool depths");
+        check(r[3].fixed.high_water <= 1024 && r[3].fixed.high_water > 128, "benchmark temps high water");
+    }
+
+    return check.finish();
+}
+
+
+void usage() {
+    std::fprintf(stderr,
+                 "usage: fixed_mem_bench [--ops <n>]\n"
+                 "       fixed_mem_bench --selftest\n");
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    uint32_t ops = 1000000;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--selftest") == 0) {
+            return selftest();
+        } else if (std::strcmp(argv[i], "--ops") == 0 && i + 1 < argc) {
+            ops = std::strtoul(argv[++i], nullptr, 0);
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (ops == 0) {
+        usage();
+        return 2;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto now_ns = [&] {
+        return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start)
+                .count();
+    };
+    fixed_mem::bench_result results[fixed_mem::BENCH_PATTERNS];
+    fixed_mem::benchmark(now_ns, ops, results);
+
+    std::printf("%-8s %10s %10s %8s %12s\n", "pattern", "malloc ns", "fixed ns", "speedup", "high water");
+    for (const fixed_mem::bench_result& r : results) {
+        std::printf("%-8s %10.1f %10.1f %7.2fx %6zu/%-5zu\n", r.pattern, (double)r.malloc_ticks / r.ops,
+                    (double)r.fixed_ticks / r.ops, (double)r.malloc_ticks / r.fixed_ticks, r.fixed.high_water,
+                    r.fixed.capacity);
+        if (r.malloc_failures || r.fixed.failures) {
+            std::printf("  %u malloc and %u arena failures\n", r.malloc_failures, r.fixed.failures);
+        }
+    }
+    return 0;
+}
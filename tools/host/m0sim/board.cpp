@@ -0,0 +1,403 @@
+/*****************************************************************//**
+ * \file   board.cpp
+ * \brief  RP2040 memory map with stub peripherals for the simulator
+ *
+ * Register offsets are those of the SDK's hardware/regs headers.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include "board.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+constexpr uint32_t IO_BANK0_BASE = 0x40014000;
+constexpr uint32_t TIMER_BASE = 0x40054000;
+constexpr uint32_t SIO_BASE = 0xd0000000;
+constexpr uint32_t PPB_BASE = 0xe0000000;
+
+constexpr uint32_t APB_ALIAS_BITS = 0x3000;
+constexpr uint32_t ICSR_PENDSVSET = 1u << 28;
+constexpr uint32_t ICSR_PENDSVCLR = 1u << 27;
+
+// the RP2040 implements the top two bits of each priority
+constexpr unsigned PRIORITY_MASK = 0xc0;
+
+bool in(uint32_t addr, uint32_t base, uint32_t size) {
+    return addr - base < size;
+}
+
+std::string hex(uint32_t x) {
+    char buf[16];
+    std::snprintf(buf, sizeof(buf), "0x%08x", x);
+    return buf;
+}
+
+} // namespace
+
+
+board::board(const uint64_t* cycles) : cycles_(cycles), ram_(SRAM_END - SRAM_BASE) {
+}
+
+
+void board::load(uint32_t addr, const std::vector<uint8_t>& bytes) {
+    if (!in(addr, SRAM_BASE, SRAM_END - SRAM_BASE) || bytes.size() > SRAM_END - addr) {
+        throw sim_fault("load outside SRAM at " + hex(addr));
+    }
+    std::memcpy(&ram_[addr - SRAM_BASE], bytes.data(), bytes.size());
+}
+
+
+uint32_t board::read(uint32_t addr, unsigned size) {
+    if (in(addr, SRAM_BASE, SRAM_END - SRAM_BASE)) {
+        uint32_t value = 0;
+        std::memcpy(&value, &ram_[addr - SRAM_BASE], size);
+        return value;
+    }
+    uint32_t word = peripheral_read(addr & ~3u);
+    uint32_t shift = 8 * (addr & 3);
+    return size == 4 ? word : (word >> shift) & ((1u << 8 * size) - 1);
+}
+
+
+void board::write(uint32_t addr, uint32_t value, unsigned size) {
+    if (in(addr, SRAM_BASE, SRAM_END - SRAM_BASE)) {
+        std::memcpy(&ram_[addr - SRAM_BASE], &value, size);
+        return;
+    }
+    if (size != 4) {
+        throw sim_fault("narrow write to peripheral " + hex(addr));
+    }
+    peripheral_write(addr, value);
+}
+
+
+int board::wait_states(uint32_t addr) {
+    if (in(addr, SIO_BASE, 0x10000000)) {
+        return -1;
+    }
+    if (in(addr, 0x40000000, 0x20000000)) {
+        return APB_WAIT_STATES;
+    }
+    return 0;
+}
+
+
+uint32_t board::peripheral_read(uint32_t addr) {
+    uint32_t reg = addr & ~APB_ALIAS_BITS;
+    if (in(reg, IO_BANK0_BASE, 0x1000)) {
+        return io_bank0_read(reg - IO_BANK0_BASE);
+    }
+    if (in(reg, TIMER_BASE, 0x1000)) {
+        return timer_read(reg - TIMER_BASE);
+    }
+    if (in(addr, SIO_BASE, 0x1000)) {
+        return sio_read(addr - SIO_BASE);
+    }
+    if (in(addr, PPB_BASE + 0xe000, 0x1000)) {
+        return ppb_read(addr - PPB_BASE);
+    }
+    throw sim_fault("read from unmapped address " + hex(addr));
+}
+
+
+void board::peripheral_write(uint32_t addr, uint32_t value) {
+    if (in(addr, 0x40000000, 0x20000000)) {
+        uint32_t reg = addr & ~APB_ALIAS_BITS;
+        uint32_t alias = (addr & APB_ALIAS_BITS) >> 12;
+        if (alias) {
+            uint32_t old = peripheral_read(reg);
+            value = alias == 1 ? old ^ value : alias == 2 ? old | value : old & ~value;
+        }
+        if (in(reg, IO_BANK0_BASE, 0x1000)) {
+            io_bank0_write(reg - IO_BANK0_BASE, value);
+            return;
+        }
+        if (in(reg, TIMER_BASE, 0x1000)) {
+            timer_write(reg - TIMER_BASE, value);
+            return;
+        }
+    } else if (in(addr, SIO_BASE, 0x1000)) {
+        sio_write(addr - SIO_BASE, value);
+        return;
+    } else if (in(addr, PPB_BASE + 0xe000, 0x1000)) {
+        ppb_write(addr - PPB_BASE, value);
+        return;
+    }
+    throw sim_fault("write to unmapped address " + hex(addr));
+}
+
+
+// IO_BANK0
+
+uint32_t board::io_bank0_read(uint32_t offset) {
+    if (in(offset, 0xf0, 0x10)) {
+        return gpio_intr_[(offset - 0xf0) / 4];
+    }
+    if (in(offset, 0x100, 0x10)) {
+        return gpio_inte[(offset - 0x100) / 4];
+    }
+    if (in(offset, 0x110, 0x10)) {
+        return gpio_intf_[(offset - 0x110) / 4];
+    }
+    if (in(offset, 0x120, 0x10)) {
+        unsigned i = (offset - 0x120) / 4;
+        return (gpio_intr_[i] & gpio_inte[i]) | gpio_intf_[i];
+    }
+    if (offset < 0x190) {
+        return gpio_ctrl_[offset];      // GPIO STATUS/CTRL and the other cores' registers
+    }
+    throw sim_fault("read from unmapped IO_BANK0 offset " + hex(offset));
+}
+
+
+void board::io_bank0_write(uint32_t offset, uint32_t value) {
+    if (in(offset, 0xf0, 0x10)) {
+        gpio_intr_[(offset - 0xf0) / 4] &= ~value;      // write 1 to clear the edge latches
+    } else if (in(offset, 0x100, 0x10)) {
+        gpio_inte[(offset - 0x100) / 4] = value;
+    } else if (in(offset, 0x110, 0x10)) {
+        gpio_intf_[(offset - 0x110) / 4] = value;
+    } else if (in(offset, 0x120, 0x10)) {
+        return;     // read only
+    } else if (offset < 0x190) {
+        gpio_ctrl_[offset] = value;
+    } else {
+        throw sim_fault("write to unmapped IO_BANK0 offset " + hex(offset));
+    }
+    update_gpio_irq();
+}
+
+
+void board::update_gpio_irq() {
+    for (unsigned i = 0; i < 4; i++) {
+        if ((gpio_intr_[i] & gpio_inte[i]) | gpio_intf_[i]) {
+            pend_irq(IO_IRQ_BANK0);
+            return;
+        }
+    }
+}
+
+
+void board::set_input(unsigned pin, bool level) {
+    uint32_t mask = 1u << pin;
+    bool old = gpio_in & mask;
+    gpio_in = level ? gpio_in | mask : gpio_in & ~mask;
+    if (old && !level) {
+        gpio_intr_[pin / 8] |= edge_low_mask(pin);
+    } else if (!old && level) {
+        gpio_intr_[pin / 8] |= edge_low_mask(pin) << 1;
+    }
+    update_gpio_irq();
+}
+
+
+bool board::pin_level(unsigned pin) const {
+    uint32_t mask = 1u << pin;
+    return (gpio_oe & mask ? gpio_out : gpio_in) & mask;
+}
+
+
+void board::set_output(unsigned pin, bool level) {
+    gpio_out = level ? gpio_out | 1u << pin : gpio_out & ~(1u << pin);
+}
+
+
+// TIMER
+
+uint32_t board::timer_read(uint32_t offset) {
+    uint64_t now = *cycles_ / (CLOCK_HZ / 1000000);
+    switch (offset) {
+    case 0x08:
+    case 0x24: return uint32_t(now >> 32);      // TIMEHR, TIMERAWH
+    case 0x0c:
+    case 0x28: return uint32_t(now);            // TIMELR, TIMERAWL
+    case 0x10: return alarm0_;
+    case 0x20: return armed_;
+    case 0x34: return timer_intr_;
+    case 0x38: return timer_inte_;
+    case 0x3c: return timer_intf_;
+    case 0x40: return (timer_intr_ & timer_inte_) | timer_intf_;
+    }
+    if (offset <= 0x40) {
+        return 0;
+    }
+    throw sim_fault("read from unmapped TIMER offset " + hex(offset));
+}
+
+
+void board::timer_write(uint32_t offset, uint32_t value) {
+    switch (offset) {
+    case 0x10: alarm0_ = value; armed_ = true; break;
+    case 0x20: armed_ = armed_ && !(value & 1); break;
+    case 0x34: timer_intr_ &= ~value; break;
+    case 0x38: timer_inte_ = value; break;
+    case 0x3c: timer_intf_ = value; break;
+    default:
+        if (offset > 0x40) {
+            throw sim_fault("write to unmapped TIMER offset " + hex(offset));
+        }
+        return;
+    }
+    update_timer_irq();
+}
+
+
+void board::update_timer_irq() {
+    if (((timer_intr_ & timer_inte_) | timer_intf_) & 1) {
+        pend_irq(TIMER_IRQ_0);
+    }
+}
+
+
+void board::fire_alarm() {
+    armed_ = false;
+    timer_intr_ |= 1;
+    update_timer_irq();
+}
+
+
+void board::tick() {
+    if (armed_ && int32_t(time_us() - alarm0_) >= 0) {
+        fire_alarm();
+    }
+}
+
+
+// SIO
+
+uint32_t board::sio_read(uint32_t offset) {
+    switch (offset) {
+    case 0x00: return 0;        // CPUID, always core 0
+    case 0x04: return ((gpio_out & gpio_oe) | (gpio_in & ~gpio_oe)) & ((1u << NUM_GPIOS) - 1);
+    case 0x08: return 0;
+    case 0x10: return gpio_out;
+    case 0x20: return gpio_oe;
+    case 0x14: case 0x18: case 0x1c:
+    case 0x24: case 0x28: case 0x2c: return 0;
+    }
+    throw sim_fault("read from unmodelled SIO offset " + hex(offset));
+}
+
+
+void board::sio_write(uint32_t offset, uint32_t value) {
+    switch (offset) {
+    case 0x10: gpio_out = value; return;
+    case 0x14: gpio_out |= value; return;
+    case 0x18: gpio_out &= ~value; return;
+    case 0x1c: gpio_out ^= value; return;
+    case 0x20: gpio_oe = value; return;
+    case 0x24: gpio_oe |= value; return;
+    case 0x28: gpio_oe &= ~value; return;
+    case 0x2c: gpio_oe ^= value; return;
+    }
+    throw sim_fault("write to unmodelled SIO offset " + hex(offset));
+}
+
+
+// PPB
+
+uint32_t board::ppb_read(uint32_t offset) {
+    if (in(offset, 0xe010, 0x10)) {
+        return systick_[(offset - 0xe010) / 4];
+    }
+    if (offset == 0xe100 || offset == 0xe180) {
+        return nvic_enabled_;
+    }
+    if (offset == 0xe200 || offset == 0xe280) {
+        return nvic_pending_;
+    }
+    if (in(offset, 0xe400, 0x20)) {
+        uint32_t value;
+        std::memcpy(&value, &nvic_priority_[offset - 0xe400], 4);
+        return value;
+    }
+    switch (offset) {
+    case 0xed00: return 0x410cc601;     // CPUID of the Cortex-M0+ r0p1
+    case 0xed04: return pendsv_ ? ICSR_PENDSVSET : 0;
+    case 0xed08: return vtor_;
+    case 0xed0c: return 0xfa050000;
+    case 0xed10: return scr_;
+    case 0xed1c: return shpr2_;
+    case 0xed20: return shpr3_;
+    }
+    throw sim_fault("read from unmodelled PPB offset " + hex(offset));
+}
+
+
+void board::ppb_write(uint32_t offset, uint32_t value) {
+    if (in(offset, 0xe010, 0x10)) {
+        systick_[(offset - 0xe010) / 4] = value;
+        return;
+    }
+    if (in(offset, 0xe400, 0x20)) {
+        std::memcpy(&nvic_priority_[offset - 0xe400], &value, 4);
+        return;
+    }
+    switch (offset) {
+    case 0xe100: nvic_enabled_ |= value; return;
+    case 0xe180: nvic_enabled_ &= ~value; return;
+    case 0xe200: nvic_pending_ |= value; return;
+    case 0xe280: nvic_pending_ &= ~value; return;
+    case 0xed04:
+        if (value & ICSR_PENDSVSET) {
+            pendsv_ = true;
+        }
+        if (value & ICSR_PENDSVCLR) {
+            pendsv_ = false;
+        }
+        return;
+    case 0xed08: vtor_ = value & ~0xffu; return;
+    case 0xed0c: return;
+    case 0xed10: scr_ = value; return;
+    case 0xed1c: shpr2_ = value; return;
+    case 0xed20: shpr3_ = value; return;
+    }
+    throw sim_fault("write to unmodelled PPB offset " + hex(offset));
+}
+
+
+unsigned board::priority(unsigned exception) const {
+    if (exception >= cortex_m0::EXC_IRQ0) {
+        return nvic_priority_[exception - cortex_m0::EXC_IRQ0] & PRIORITY_MASK;
+    }
+    switch (exception) {
+    case cortex_m0::EXC_SVCALL: return (shpr2_ >> 24) & PRIORITY_MASK;
+    case cortex_m0::EXC_PENDSV: return (shpr3_ >> 16) & PRIORITY_MASK;
+    case cortex_m0::EXC_SYSTICK: return (shpr3_ >> 24) & PRIORITY_MASK;
+    }
+    return 0;
+}
+
+
+unsigned board::take_pending(unsigned ipsr, bool primask) {
+    if (primask) {
+        return 0;
+    }
+    unsigned current = ipsr ? priority(ipsr) : 0x100;
+    unsigned best = 0;
+    unsigned best_priority = current;
+    // lowest exception number wins a tie, so PendSV is considered first
+    if (pendsv_ && priority(cortex_m0::EXC_PENDSV) < best_priority) {
+        best = cortex_m0::EXC_PENDSV;
+        best_priority = priority(best);
+    }
+    uint32_t ready = nvic_pending_ & nvic_enabled_;
+    for (unsigned irq = 0; irq < 32; irq++) {
+        unsigned exception = cortex_m0::EXC_IRQ0 + irq;
+        if ((ready >> irq & 1) && priority(exception) < best_priority) {
+            best = exception;
+            best_priority = priority(exception);
+        }
+    }
+    if (best == cortex_m0::EXC_PENDSV) {
+        pendsv_ = false;
+    } else if (best) {
+        nvic_pending_ &= ~(1u << (best - cortex_m0::EXC_IRQ0));
+    }
+    return best;
+}
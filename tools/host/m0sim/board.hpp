@@ -0,0 +1,154 @@
+/*****************************************************************//**
+ * \file   board.hpp
+ * \brief  RP2040 memory map with stub peripherals for the simulator
+ *
+ * Just enough of the chip for the assembly routines in the labs and
+ * assignments to run:
+ *
+ *   0x20000000  SRAM, zero wait state; the object under test is
+ *               loaded at the bottom, the vector table and the stack
+ *               sit at the top
+ *   0x40014000  IO_BANK0: raw edge latches, PROC0 enable/force/status
+ *   0x40054000  TIMER: microsecond time derived from the cycle count,
+ *               ALARM0 and the interrupt registers
+ *   0xd0000000  SIO: CPUID and the GPIO in/out/output enable registers
+ *               with their SET/CLR/XOR aliases, single cycle
+ *   0xe0000000  PPB: NVIC enable/pending/priority, ICSR, VTOR, SHPR2/3
+ *               and SysTick (registers only, it doesn't count)
+ *
+ * APB peripherals honour the atomic XOR/SET/CLR aliases at +0x1000,
+ * +0x2000 and +0x3000. An APB access is charged APB_WAIT_STATES on
+ * top of the core's two cycles; the real bridge cost varies with the
+ * peripheral, so treat those figures as approximate. Code fetches are
+ * free, which matches code running from SRAM or from a warm XIP cache.
+ *
+ * Anything else faults, so a stray address shows up as an error rather
+ * than as a silent zero.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#ifndef BOARD_HPP
+#define BOARD_HPP
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "cortex_m0.hpp"
+
+
+class board : public bus {
+public:
+    static constexpr uint32_t SRAM_BASE = 0x20000000;
+    static constexpr uint32_t SRAM_END = 0x20042000;
+    static constexpr uint32_t SCRATCH_BASE = 0x20040000;    // trampolines written by the harness
+    static constexpr uint32_t VECTOR_TABLE = 0x20041000;
+    static constexpr uint32_t STACK_TOP = SRAM_END;
+
+    static constexpr uint32_t CLOCK_HZ = 125000000;
+    static constexpr int APB_WAIT_STATES = 1;
+
+    static constexpr unsigned TIMER_IRQ_0 = 0;
+    static constexpr unsigned IO_IRQ_BANK0 = 13;
+    static constexpr unsigned NUM_GPIOS = 30;
+
+    explicit board(const uint64_t* cycles);
+
+    uint32_t read(uint32_t addr, unsigned size) override;
+    void write(uint32_t addr, uint32_t value, unsigned size) override;
+    int wait_states(uint32_t addr) override;
+
+    /**
+     * @brief copy bytes into SRAM, outside of any cycle accounting
+     */
+    void load(uint32_t addr, const std::vector<uint8_t>& bytes);
+
+    /**
+     * @brief pull an input low or let it go high, latching the edge and raising IO_IRQ_BANK0 if enabled
+     */
+    void set_input(unsigned pin, bool level);
+
+    /**
+     * @brief the level the pin is at, driven or not
+     */
+    bool pin_level(unsigned pin) const;
+
+    /**
+     * @brief drive an output directly, as if the SIO had set it
+     */
+    void set_output(unsigned pin, bool level);
+
+    /**
+     * @brief fire ALARM0 now, as when TIMERAWL reaches it
+     */
+    void fire_alarm();
+
+    /**
+     * @brief fire ALARM0 if the time has reached it, called between instructions
+     */
+    void tick();
+
+    /**
+     * @brief set an IRQ pending in the NVIC
+     */
+    void pend_irq(unsigned irq) { nvic_pending_ |= 1u << irq; }
+
+    /**
+     * @brief the exception to take next given the current one, or 0
+     *
+     * clears its pending bit
+     */
+    unsigned take_pending(unsigned ipsr, bool primask);
+
+    uint32_t time_us() const { return uint32_t(*cycles_ / (CLOCK_HZ / 1000000)); }
+
+    // the edge-low bit of a pin in the IO_BANK0 INTR/INTE/INTS registers
+    static uint32_t edge_low_mask(unsigned pin) { return 1u << (4 * (pin % 8) + 2); }
+
+    uint32_t gpio_oe = 0;
+    uint32_t gpio_out = 0;
+    uint32_t gpio_in = (1u << NUM_GPIOS) - 1;      // inputs idle high, as with the button pull-ups
+    uint32_t gpio_inte[4] = {};                     // PROC0_INTE0-3
+
+private:
+    uint32_t peripheral_read(uint32_t addr);
+    void peripheral_write(uint32_t addr, uint32_t value);
+    uint32_t io_bank0_read(uint32_t offset);
+    void io_bank0_write(uint32_t offset, uint32_t value);
+    uint32_t timer_read(uint32_t offset);
+    void timer_write(uint32_t offset, uint32_t value);
+    uint32_t sio_read(uint32_t offset);
+    void sio_write(uint32_t offset, uint32_t value);
+    uint32_t ppb_read(uint32_t offset);
+    void ppb_write(uint32_t offset, uint32_t value);
+    void update_gpio_irq();
+    void update_timer_irq();
+    unsigned priority(unsigned exception) const;
+
+    const uint64_t* cycles_;     // the core's, the time base of the TIMER
+    std::vector<uint8_t> ram_;
+
+    uint32_t gpio_intr_[4] = {};
+    uint32_t gpio_intf_[4] = {};
+    std::map<uint32_t, uint32_t> gpio_ctrl_;
+
+    uint32_t alarm0_ = 0;
+    bool armed_ = false;
+    uint32_t timer_intr_ = 0;
+    uint32_t timer_inte_ = 0;
+    uint32_t timer_intf_ = 0;
+
+    uint32_t nvic_enabled_ = 0;
+    uint32_t nvic_pending_ = 0;
+    uint8_t nvic_priority_[32] = {};
+    uint32_t vtor_ = VECTOR_TABLE;
+    uint32_t shpr2_ = 0;
+    uint32_t shpr3_ = 0;
+    uint32_t scr_ = 0;
+    uint32_t systick_[4] = {};
+    bool pendsv_ = false;
+};
+
+#endif // BOARD_HPP
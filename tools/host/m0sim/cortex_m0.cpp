@@ -0,0 +1,605 @@
+/*****************************************************************//**
+ * \file   cortex_m0.cpp
+ * \brief  ARMv6-M (Thumb-1) interpreter with Cortex-M0+ cycle counts
+ *
+ * Decoding follows the ARMv6-M Architecture Reference Manual, section
+ * A5.2. While an instruction executes, r_[PC] already holds the
+ * address of the next one; reads of the PC as an operand see the
+ * address of the instruction plus 4, as on the hardware.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include "cortex_m0.hpp"
+
+#include <cstdio>
+
+namespace {
+
+constexpr uint32_t VTOR = 0xe000ed08;
+constexpr uint32_t XPSR_ALIGN = 1u << 9;    // the frame was padded to 8 bytes
+
+uint32_t bit(uint32_t x, unsigned n) {
+    return (x >> n) & 1;
+}
+
+int32_t sign_extend(uint32_t x, unsigned bits) {
+    uint32_t m = 1u << (bits - 1);
+    return int32_t((x ^ m) - m);
+}
+
+std::string hex(uint32_t x) {
+    char buf[16];
+    std::snprintf(buf, sizeof(buf), "0x%08x", x);
+    return buf;
+}
+
+} // namespace
+
+
+uint32_t cortex_m0::xpsr() const {
+    return uint32_t(n) << 31 | uint32_t(z) << 30 | uint32_t(c) << 29 | uint32_t(v) << 28 | 1u << 24 | ipsr_;
+}
+
+
+uint32_t cortex_m0::fetch16(uint32_t addr) {
+    return bus_.read(addr, 2);
+}
+
+
+uint32_t cortex_m0::load(uint32_t addr, unsigned size) {
+    if (addr & (size - 1)) {
+        throw sim_fault("unaligned load from " + hex(addr));
+    }
+    cycles += bus_.wait_states(addr);
+    return bus_.read(addr, size);
+}
+
+
+void cortex_m0::store(uint32_t addr, uint32_t value, unsigned size) {
+    if (addr & (size - 1)) {
+        throw sim_fault("unaligned store to " + hex(addr));
+    }
+    cycles += bus_.wait_states(addr);
+    bus_.write(addr, value, size);
+}
+
+
+uint32_t cortex_m0::add_with_carry(uint32_t x, uint32_t y, bool carry, bool set_flags) {
+    uint64_t unsigned_sum = uint64_t(x) + y + carry;
+    int64_t signed_sum = int64_t(int32_t(x)) + int32_t(y) + carry;
+    uint32_t result = uint32_t(unsigned_sum);
+    if (set_flags) {
+        set_nz(result);
+        c = unsigned_sum >> 32;
+        v = int64_t(int32_t(result)) != signed_sum;
+    }
+    return result;
+}
+
+
+void cortex_m0::set_nz(uint32_t result) {
+    n = result >> 31;
+    z = result == 0;
+}
+
+
+bool cortex_m0::condition(unsigned cond) const {
+    switch (cond) {
+    case 0x0: return z;
+    case 0x1: return !z;
+    case 0x2: return c;
+    case 0x3: return !c;
+    case 0x4: return n;
+    case 0x5: return !n;
+    case 0x6: return v;
+    case 0x7: return !v;
+    case 0x8: return c && !z;
+    case 0x9: return !c || z;
+    case 0xa: return n == v;
+    case 0xb: return n != v;
+    case 0xc: return !z && n == v;
+    case 0xd: return z || n != v;
+    default: return true;
+    }
+}
+
+
+void cortex_m0::branch(uint32_t target) {
+    if (ipsr_ && (target & 0xfffffff0) == 0xfffffff0) {
+        exception_return(target);
+        return;
+    }
+    if (!(target & 1)) {
+        throw sim_fault("branch to " + hex(target) + " without the Thumb bit");
+    }
+    r_[PC] = target & ~1u;
+}
+
+
+void cortex_m0::take_exception(unsigned number) {
+    uint32_t sp = r_[SP] - 32;
+    uint32_t psr = xpsr();
+    if (sp & 4) {
+        sp -= 4;
+        psr |= XPSR_ALIGN;
+    }
+    const uint32_t frame[8] = {r_[0], r_[1], r_[2], r_[3], r_[12], r_[LR], r_[PC], psr};
+    for (unsigned i = 0; i < 8; i++) {
+        bus_.write(sp + 4 * i, frame[i], 4);
+    }
+    r_[SP] = sp;
+    r_[LR] = ipsr_ ? 0xfffffff1 : 0xfffffff9;
+    ipsr_ = number;
+
+    uint32_t handler = bus_.read(bus_.read(VTOR, 4) + 4 * number, 4);
+    if (!handler) {
+        throw sim_fault("no handler for exception " + std::to_string(number));
+    }
+    r_[PC] = handler & ~1u;
+    cycles += EXC_ENTRY_CYCLES;
+}
+
+
+void cortex_m0::exception_return(uint32_t exc_return) {
+    if (exc_return != 0xfffffff1 && exc_return != 0xfffffff9) {
+        throw sim_fault("unsupported EXC_RETURN " + hex(exc_return));
+    }
+    uint32_t sp = r_[SP];
+    uint32_t frame[8];
+    for (unsigned i = 0; i < 8; i++) {
+        frame[i] = bus_.read(sp + 4 * i, 4);
+    }
+    for (unsigned i = 0; i < 4; i++) {
+        r_[i] = frame[i];
+    }
+    r_[12] = frame[4];
+    r_[LR] = frame[5];
+    r_[PC] = frame[6] & ~1u;
+    uint32_t psr = frame[7];
+    n = bit(psr, 31);
+    z = bit(psr, 30);
+    c = bit(psr, 29);
+    v = bit(psr, 28);
+    ipsr_ = psr & 0x3f;
+    r_[SP] = sp + 32 + (psr & XPSR_ALIGN ? 4 : 0);
+    cycles += EXC_RETURN_CYCLES;
+    exceptions_returned++;
+}
+
+
+void cortex_m0::step() {
+    uint32_t addr = r_[PC];
+    uint32_t op = fetch16(addr);
+    uint32_t pc = addr + 4;     // the PC as an operand
+    instructions++;
+
+    if ((op >> 11) >= 0x1d) {
+        uint32_t second = fetch16(addr + 2);
+        r_[PC] = addr + 4;
+        execute32(op, second);
+        return;
+    }
+    r_[PC] = addr + 2;
+
+    unsigned rd = op & 7;
+    unsigned rn = (op >> 3) & 7;
+    unsigned rm = (op >> 6) & 7;
+
+    switch (op >> 12) {
+    case 0x0:
+    case 0x1: {
+        unsigned kind = (op >> 11) & 3;
+        unsigned imm5 = (op >> 6) & 0x1f;
+        uint32_t x = r_[rn];
+        uint32_t result;
+        if (kind == 3) {
+            // ADDS/SUBS, register or 3 bit immediate
+            uint32_t y = bit(op, 10) ? rm : r_[rm];
+            result = bit(op, 9) ? add_with_carry(x, ~y, true, true) : add_with_carry(x, y, false, true);
+        } else if (kind == 0) {
+            // LSLS #imm, MOVS when imm is 0
+            if (imm5) {
+                c = bit(x, 32 - imm5);
+            }
+            result = x << imm5;
+            set_nz(result);
+        } else if (kind == 1) {
+            unsigned s = imm5 ? imm5 : 32;
+            c = bit(x, s - 1);
+            result = s == 32 ? 0 : x >> s;
+            set_nz(result);
+        } else {
+            unsigned s = imm5 ? imm5 : 32;
+            c = bit(x, s - 1);
+            result = s == 32 ? uint32_t(int32_t(x) >> 31) : uint32_t(int32_t(x) >> s);
+            set_nz(result);
+        }
+        r_[rd] = result;
+        cycles += 1;
+        return;
+    }
+
+    case 0x2:
+    case 0x3: {
+        // MOVS/CMP/ADDS/SUBS #imm8
+        unsigned r = (op >> 8) & 7;
+        uint32_t imm = op & 0xff;
+        switch ((op >> 11) & 3) {
+        case 0: r_[r] = imm; set_nz(imm); break;
+        case 1: add_with_carry(r_[r], ~imm, true, true); break;
+        case 2: r_[r] = add_with_carry(r_[r], imm, false, true); break;
+        case 3: r_[r] = add_with_carry(r_[r], ~imm, true, true); break;
+        }
+        cycles += 1;
+        return;
+    }
+
+    case 0x4:
+        if ((op >> 10) == 0x10) {
+            // data processing on low registers
+            uint32_t x = r_[rd], y = r_[rn];
+            unsigned s = y & 0xff;
+            uint32_t result = x;
+            bool write = true;
+            switch ((op >> 6) & 0xf) {
+            case 0x0: result = x & y; break;
+            case 0x1: result = x ^ y; break;
+            case 0x2:
+                if (s >= 1 && s <= 32) c = bit(x, 32 - s);
+                else if (s > 32) c = false;
+                result = s >= 32 ? 0 : x << s;
+                break;
+            case 0x3:
+                if (s >= 1 && s <= 32) c = bit(x, s - 1);
+                else if (s > 32) c = false;
+                result = s >= 32 ? 0 : x >> s;
+                break;
+            case 0x4:
+                if (s >= 1 && s < 32) {
+                    c = bit(x, s - 1);
+                    result = uint32_t(int32_t(x) >> s);
+                } else if (s >= 32) {
+                    c = bit(x, 31);
+                    result = uint32_t(int32_t(x) >> 31);
+                }
+                break;
+            case 0x5: result = add_with_carry(x, y, c, true); break;
+            case 0x6: result = add_with_carry(x, ~y, c, true); break;
+            case 0x7:
+                if (s) {
+                    unsigned r = s & 31;
+                    result = r ? (x >> r) | (x << (32 - r)) : x;
+                    c = bit(result, 31);
+                }
+                break;
+            case 0x8: result = x & y; write = false; break;
+            case 0x9: result = add_with_carry(~y, 0, true, true); break;   // RSBS #0
+            case 0xa: add_with_carry(x, ~y, true, true); write = false; break;
+            case 0xb: add_with_carry(x, y, false, true); write = false; break;
+            case 0xc: result = x | y; break;
+            case 0xd: result = x * y; break;
+            case 0xe: result = x & ~y; break;
+            case 0xf: result = ~y; break;
+            }
+            unsigned dp = (op >> 6) & 0xf;
+            if (dp != 0x5 && dp != 0x6 && dp != 0x9 && dp != 0xa && dp != 0xb) {
+                set_nz(result);
+            }
+            if (write) {
+                r_[rd] = result;
+            }
+            cycles += 1;
+            return;
+        }
+        if ((op >> 10) == 0x11) {
+            // ADD, CMP, MOV on any register, BX and BLX
+            unsigned d = (op & 7) | (bit(op, 7) << 3);
+            unsigned m = (op >> 3) & 0xf;
+            uint32_t y = m == PC ? pc : r_[m];
+            uint32_t x = d == PC ? pc : r_[d];
+            switch ((op >> 8) & 3) {
+            case 0:
+                if (d == PC) {
+                    r_[PC] = (x + y) & ~1u;
+                    cycles += 2;
+                } else {
+                    r_[d] = x + y;
+                    cycles += 1;
+                }
+                return;
+            case 1:
+                add_with_carry(x, ~y, true, true);
+                cycles += 1;
+                return;
+            case 2:
+                if (d == PC) {
+                    r_[PC] = y & ~1u;
+                    cycles += 2;
+                } else {
+                    r_[d] = y;
+                    cycles += 1;
+                }
+                return;
+            case 3:
+                if (bit(op, 7)) {
+                    r_[LR] = r_[PC] | 1;
+                }
+                cycles += 2;
+                branch(y);
+                return;
+            }
+        }
+        {
+            // LDR Rt, [PC, #imm8]
+            unsigned t = (op >> 8) & 7;
+            r_[t] = load((pc & ~3u) + (op & 0xff) * 4, 4);
+            cycles += 2;
+            return;
+        }
+
+    case 0x5: {
+        // load/store with register offset
+        uint32_t a = r_[rn] + r_[rm];
+        switch ((op >> 9) & 7) {
+        case 0: store(a, r_[rd], 4); break;
+        case 1: store(a, r_[rd] & 0xffff, 2); break;
+        case 2: store(a, r_[rd] & 0xff, 1); break;
+        case 3: r_[rd] = uint32_t(sign_extend(load(a, 1), 8)); break;
+        case 4: r_[rd] = load(a, 4); break;
+        case 5: r_[rd] = load(a, 2); break;
+        case 6: r_[rd] = load(a, 1); break;
+        case 7: r_[rd] = uint32_t(sign_extend(load(a, 2), 16)); break;
+        }
+        cycles += 2;
+        return;
+    }
+
+    case 0x6:
+    case 0x7: {
+        // word and byte, immediate offset
+        unsigned imm5 = (op >> 6) & 0x1f;
+        unsigned size = bit(op, 12) ? 1 : 4;
+        uint32_t a = r_[rn] + imm5 * size;
+        if (bit(op, 11)) {
+            r_[rd] = load(a, size);
+        } else {
+            store(a, size == 4 ? r_[rd] : r_[rd] & 0xff, size);
+        }
+        cycles += 2;
+        return;
+    }
+
+    case 0x8: {
+        uint32_t a = r_[rn] + ((op >> 6) & 0x1f) * 2;
+        if (bit(op, 11)) {
+            r_[rd] = load(a, 2);
+        } else {
+            store(a, r_[rd] & 0xffff, 2);
+        }
+        cycles += 2;
+        return;
+    }
+
+    case 0x9: {
+        unsigned t = (op >> 8) & 7;
+        uint32_t a = r_[SP] + (op & 0xff) * 4;
+        if (bit(op, 11)) {
+            r_[t] = load(a, 4);
+        } else {
+            store(a, r_[t], 4);
+        }
+        cycles += 2;
+        return;
+    }
+
+    case 0xa: {
+        // ADR, or ADD Rd, SP, #imm8
+        unsigned d = (op >> 8) & 7;
+        r_[d] = (bit(op, 11) ? r_[SP] : pc & ~3u) + (op & 0xff) * 4;
+        cycles += 1;
+        return;
+    }
+
+    case 0xb:
+        switch ((op >> 8) & 0xf) {
+        case 0x0: {
+            uint32_t imm = (op & 0x7f) * 4;
+            r_[SP] = bit(op, 7) ? r_[SP] - imm : r_[SP] + imm;
+            cycles += 1;
+            return;
+        }
+        case 0x2: {
+            uint32_t x = r_[rn];
+            switch ((op >> 6) & 3) {
+            case 0: r_[rd] = uint32_t(sign_extend(x & 0xffff, 16)); break;
+            case 1: r_[rd] = uint32_t(sign_extend(x & 0xff, 8)); break;
+            case 2: r_[rd] = x & 0xffff; break;
+            case 3: r_[rd] = x & 0xff; break;
+            }
+            cycles += 1;
+            return;
+        }
+        case 0x4:
+        case 0x5: {
+            // PUSH, lowest register at the lowest address
+            unsigned count = __builtin_popcount(op & 0x1ff);
+            uint32_t a = r_[SP] - 4 * count;
+            r_[SP] = a;
+            for (unsigned i = 0; i < 8; i++) {
+                if (bit(op, i)) {
+                    store(a, r_[i], 4);
+                    a += 4;
+                }
+            }
+            if (bit(op, 8)) {
+                store(a, r_[LR], 4);
+            }
+            cycles += 1 + count;
+            return;
+        }
+        case 0x6:
+            if ((op & 0xffef) == 0xb662) {
+                primask_ = bit(op, 4);
+                cycles += 1;
+                return;
+            }
+            break;
+        case 0xa: {
+            uint32_t x = r_[rn];
+            switch ((op >> 6) & 3) {
+            case 0: r_[rd] = __builtin_bswap32(x); break;
+            case 1: r_[rd] = ((x & 0x00ff00ff) << 8) | ((x >> 8) & 0x00ff00ff); break;
+            case 3: r_[rd] = uint32_t(sign_extend(((x & 0xff) << 8) | ((x >> 8) & 0xff), 16)); break;
+            default: throw sim_fault("undefined instruction at " + hex(addr));
+            }
+            cycles += 1;
+            return;
+        }
+        case 0xc:
+        case 0xd: {
+            unsigned count = __builtin_popcount(op & 0x1ff);
+            uint32_t a = r_[SP];
+            r_[SP] = a + 4 * count;
+            for (unsigned i = 0; i < 8; i++) {
+                if (bit(op, i)) {
+                    r_[i] = load(a, 4);
+                    a += 4;
+                }
+            }
+            if (bit(op, 8)) {
+                cycles += 3 + count;
+                branch(load(a, 4));
+            } else {
+                cycles += 1 + count;
+            }
+            return;
+        }
+        case 0xe:
+            halt_ = halt::bkpt;
+            r_[PC] = addr;
+            return;
+        case 0xf:
+            switch (op & 0xff) {
+            case 0x20: halt_ = halt::wfe; cycles += 2; return;
+            case 0x30: halt_ = halt::wfi; cycles += 2; return;
+            case 0x00:
+            case 0x10:
+            case 0x40: cycles += 1; return;     // NOP, YIELD, SEV
+            }
+            break;
+        }
+        throw sim_fault("undefined instruction " + hex(op) + " at " + hex(addr));
+
+    case 0xc: {
+        // STM/LDM, increment after with writeback (none for LDM with the base in the list)
+        unsigned base = (op >> 8) & 7;
+        uint32_t a = r_[base];
+        unsigned count = __builtin_popcount(op & 0xff);
+        bool load_base = false;
+        for (unsigned i = 0; i < 8; i++) {
+            if (!bit(op, i)) {
+                continue;
+            }
+            if (bit(op, 11)) {
+                r_[i] = load(a, 4);
+                load_base |= i == base;
+            } else {
+                store(a, r_[i], 4);
+            }
+            a += 4;
+        }
+        if (!load_base) {
+            r_[base] = a;
+        }
+        cycles += 1 + count;
+        return;
+    }
+
+    case 0xd: {
+        unsigned cond = (op >> 8) & 0xf;
+        if (cond == 0xf) {
+            take_exception(EXC_SVCALL);
+            return;
+        }
+        if (cond == 0xe) {
+            throw sim_fault("UDF at " + hex(addr));
+        }
+        if (condition(cond)) {
+            r_[PC] = pc + uint32_t(sign_extend((op & 0xff) << 1, 9));
+            cycles += 2;
+        } else {
+            cycles += 1;
+        }
+        return;
+    }
+
+    case 0xe:
+        r_[PC] = pc + uint32_t(sign_extend((op & 0x7ff) << 1, 12));
+        cycles += 2;
+        return;
+    }
+    throw sim_fault("undefined instruction " + hex(op) + " at " + hex(addr));
+}
+
+
+void cortex_m0::execute32(uint32_t first, uint32_t second) {
+    uint32_t addr = r_[PC] - 4;
+
+    if ((first >> 11) == 0x1e && (second & 0xd000) == 0xd000) {
+        // BL
+        uint32_t s = bit(first, 10);
+        uint32_t i1 = !(bit(second, 13) ^ s);
+        uint32_t i2 = !(bit(second, 11) ^ s);
+        uint32_t imm = s << 24 | i1 << 23 | i2 << 22 | (first & 0x3ff) << 12 | (second & 0x7ff) << 1;
+        r_[LR] = r_[PC] | 1;
+        r_[PC] = r_[PC] + uint32_t(sign_extend(imm, 25));
+        cycles += 3;
+        return;
+    }
+
+    if ((first & 0xfff0) == 0xf380 && (second & 0xff00) == 0x8800) {
+        // MSR
+        uint32_t x = r_[first & 0xf];
+        switch (second & 0xff) {
+        case 0: case 1: case 2: case 3:
+            n = bit(x, 31);
+            z = bit(x, 30);
+            c = bit(x, 29);
+            v = bit(x, 28);
+            break;
+        case 8: r_[SP] = x & ~3u; break;
+        case 16: primask_ = x & 1; break;
+        default: break;     // PSP and CONTROL aren't modelled
+        }
+        cycles += 3;
+        return;
+    }
+
+    if (first == 0xf3ef && (second & 0xf000) == 0x8000) {
+        // MRS
+        unsigned d = (second >> 8) & 0xf;
+        unsigned sysm = second & 0xff;
+        uint32_t x = 0;
+        if (sysm < 8) {
+            uint32_t psr = xpsr();
+            x = (sysm & 1 ? psr & 0x3f : 0) | (sysm & 4 ? 0 : psr & 0xf0000000);
+        } else if (sysm == 8) {
+            x = r_[SP];
+        } else if (sysm == 16) {
+            x = primask_;
+        }
+        r_[d] = x;
+        cycles += 3;
+        return;
+    }
+
+    if (first == 0xf3bf && (second & 0xff00) == 0x8f00) {
+        // DSB, DMB, ISB
+        cycles += 3;
+        return;
+    }
+
+    throw sim_fault("undefined instruction " + hex(first) + " " + hex(second) + " at " + hex(addr));
+}
@@ -0,0 +1,133 @@
+/*****************************************************************//**
+ * \file   cortex_m0.hpp
+ * \brief  ARMv6-M (Thumb-1) interpreter with Cortex-M0+ cycle counts
+ *
+ * Executes one instruction per step() and adds its cycle count from
+ * the Cortex-M0+ TRM, assuming zero wait state memory:
+ *
+ *   data processing, MULS (the RP2040 has the fast multiplier)  1
+ *   LDR/STR of any size                                          2
+ *   LDR/STR to the single-cycle IO port (SIO)                    1
+ *   LDM/STM/PUSH and POP without PC                              1 + N
+ *   POP with PC                                                  3 + N
+ *   B<cond> not taken / taken                                    1 / 2
+ *   B, BX, BLX, MOV or ADD to PC                                 2
+ *   BL                                                           3
+ *   MRS, MSR, DMB, DSB, ISB                                      3
+ *   exception entry                                              15
+ *
+ * The bus adds its wait states to each access, see bus::wait_states().
+ * The TRM gives no figure for exception return; it is counted as the
+ * EXC_RETURN_CYCLES of unstacking on top of the instruction that
+ * returns.
+ *
+ * Only the main stack, privileged thread mode and the exceptions the
+ * harness raises are modelled: no MPU, no PSP, no faults beyond
+ * stopping the run with a message.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#ifndef CORTEX_M0_HPP
+#define CORTEX_M0_HPP
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+
+/**
+ * @brief an access or instruction the simulation can't carry out
+ */
+struct sim_fault : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+
+/**
+ * @brief memory and peripherals as seen by the core
+ */
+class bus {
+public:
+    virtual ~bus() = default;
+
+    // size is 1, 2 or 4; throw sim_fault for an unmapped address
+    virtual uint32_t read(uint32_t addr, unsigned size) = 0;
+    virtual void write(uint32_t addr, uint32_t value, unsigned size) = 0;
+
+    // cycles an access takes beyond the core's own 2, negative for the IO port
+    virtual int wait_states(uint32_t addr) { (void)addr; return 0; }
+};
+
+
+class cortex_m0 {
+public:
+    static constexpr uint32_t EXC_ENTRY_CYCLES = 15;
+    static constexpr uint32_t EXC_RETURN_CYCLES = 10;
+
+    static constexpr unsigned SP = 13;
+    static constexpr unsigned LR = 14;
+    static constexpr unsigned PC = 15;
+
+    static constexpr unsigned EXC_SVCALL = 11;
+    static constexpr unsigned EXC_PENDSV = 14;
+    static constexpr unsigned EXC_SYSTICK = 15;
+    static constexpr unsigned EXC_IRQ0 = 16;
+
+    enum class halt { none, bkpt, wfi, wfe };
+
+    explicit cortex_m0(bus& b) : bus_(b) {}
+
+    /**
+     * @brief execute the instruction at PC
+     *
+     * @throw sim_fault for an undefined instruction or a bad access
+     */
+    void step();
+
+    /**
+     * @brief stack a frame and jump to the handler in the vector table VTOR points at
+     */
+    void take_exception(unsigned number);
+
+    uint32_t reg(unsigned n) const { return r_[n]; }
+    void set_reg(unsigned n, uint32_t v) { r_[n] = v; }
+
+    // next instruction, without the Thumb bit
+    uint32_t pc() const { return r_[PC]; }
+    void set_pc(uint32_t a) { r_[PC] = a & ~1u; }
+
+    uint32_t xpsr() const;
+    unsigned ipsr() const { return ipsr_; }
+    bool primask() const { return primask_; }
+
+    // why the last step() stopped, cleared by clear_halt()
+    halt halted() const { return halt_; }
+    void clear_halt() { halt_ = halt::none; }
+
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    unsigned exceptions_returned = 0;
+
+    bool n = false, z = false, c = false, v = false;
+
+private:
+    uint32_t fetch16(uint32_t addr);
+    uint32_t load(uint32_t addr, unsigned size);
+    void store(uint32_t addr, uint32_t value, unsigned size);
+    uint32_t add_with_carry(uint32_t x, uint32_t y, bool carry, bool set_flags);
+    void set_nz(uint32_t result);
+    bool condition(unsigned cond) const;
+    void branch(uint32_t target);      // BX semantics: exception return or the Thumb bit
+    void exception_return(uint32_t exc_return);
+    void execute32(uint32_t first, uint32_t second);
+
+    bus& bus_;
+    uint32_t r_[16] = {};
+    unsigned ipsr_ = 0;
+    bool primask_ = false;
+    halt halt_ = halt::none;
+};
+
+#endif // CORTEX_M0_HPP
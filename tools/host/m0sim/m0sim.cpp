@@ -0,0 +1,920 @@
+/*****************************************************************//**
+ * \file   m0sim.cpp
+ * \brief  cycle counts of the assembly routines on a simulated Cortex-M0+
+ *
+ * Loads an assembled object (the .S.obj from the firmware build, or
+ * any relocatable ARM object), links it into simulated SRAM and runs
+ * its routines one path at a time, counting core cycles:
+ *
+ *   m0sim [--trace] [--save <file> | --check <file>] <object.o>
+ *   m0sim [--trace] <object.o> --call <symbol> [r0 [r1 [r2 [r3]]]]
+ *   m0sim --selftest
+ *
+ * Calls to anything the object doesn't define go to host stubs rather
+ * than to the SDK: asm_gpio_init/set_dir/get/put/set_irq and
+ * asm_irq_set_priority act on the simulated SIO, IO_BANK0 and NVIC,
+ * deferred_queue accepts the job, and everything else (printf, the
+ * idle and telemetry hooks, ...) returns 0. The SDK's sf_table and
+ * sd_table are linked as tables whose add, sub, mul and div entries
+ * point at stubs doing the arithmetic on the host. Stubs take no
+ * cycles; the count is that of the routine's own instructions, plus
+ * exception entry and return for the handlers, and the calls it made
+ * are listed next to it.
+ *
+ * The paths run depend on what the object defines:
+ *
+ *   gpio_isr, alrm_isr   (assign01) every button with the LED flashing
+ *                        and paused, a spurious interrupt, and the
+ *                        alarm with the LED off and on
+ *   sub_toggle           (lab03, lab04) with the LED off and on
+ *   svc_isr              (lab05) SVC #0, #1 and an out of range #2
+ *   wallis_asm_float,    (lab07) 100 iterations, checked bit for bit
+ *   wallis_asm_double    against the same steps done on the host
+ *
+ * Each path starts from a fresh board, after the object's own set-up
+ * routines (install_*_isr, init_*) have run. --save writes the counts
+ * as a baseline and --check compares against one, exiting with 1 if
+ * any path got slower.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "board.hpp"
+#include "cortex_m0.hpp"
+#include "elf_file.hpp"
+#include "selftest.hpp"
+
+namespace {
+
+// past the end of SRAM but within BL range of it, so relocated calls reach the stubs
+constexpr uint32_t STUB_BASE = 0x20100000;
+constexpr uint32_t STUB_SIZE = 8;
+constexpr uint32_t RETURN_ADDRESS = 0x201ffff0;     // LR of a call made by the harness
+
+constexpr uint64_t MAX_INSTRUCTIONS = 1000000;
+
+// longer call lists are printed as a count per callee
+constexpr size_t MAX_LISTED_CALLS = 12;
+
+constexpr uint16_t SHN_ABS = 0xfff1;
+
+constexpr uint32_t R_ARM_NONE = 0;
+constexpr uint32_t R_ARM_ABS32 = 2;
+constexpr uint32_t R_ARM_REL32 = 3;
+constexpr uint32_t R_ARM_THM_CALL = 10;
+constexpr uint32_t R_ARM_V4BX = 40;
+constexpr uint32_t R_ARM_THM_JUMP11 = 102;
+constexpr uint32_t R_ARM_THM_JUMP8 = 103;
+
+// entries of the bootrom float and double tables, at the SF_TABLE_FADD..FDIV offsets
+const char* const ROM_TABLE_OPS[] = {"add", "sub", "mul", "div"};
+
+// must match assignments/assign01/assign01.S
+constexpr unsigned LED_PIN = 25;
+constexpr unsigned BTN_DN = 20;
+constexpr unsigned BTN_EN = 21;
+constexpr unsigned BTN_UP = 22;
+
+
+int32_t sign_extend(uint32_t x, unsigned bits) {
+    uint32_t m = 1u << (bits - 1);
+    return int32_t((x ^ m) - m);
+}
+
+
+/**
+ * @brief an object linked at board::SRAM_BASE
+ */
+struct image {
+    std::vector<uint8_t> bytes;
+    std::map<std::string, uint32_t> symbols;        // without the Thumb bit
+    std::vector<std::string> stubs;                 // undefined symbols, by stub slot
+};
+
+
+uint32_t stub_address(image& img, const std::string& name) {
+    auto it = std::find(img.stubs.begin(), img.stubs.end(), name);
+    size_t slot = it - img.stubs.begin();
+    if (it == img.stubs.end()) {
+        img.stubs.push_back(name);
+    }
+    return STUB_BASE + STUB_SIZE * uint32_t(slot);
+}
+
+
+bool relocate(image& img, uint32_t place, uint32_t type, uint32_t s, int64_t addend, std::string& error) {
+    uint8_t* p = &img.bytes[place - board::SRAM_BASE];
+    auto get16 = [&](size_t i) { return uint32_t(p[i] | p[i + 1] << 8); };
+    auto put16 = [&](size_t i, uint32_t v) { p[i] = uint8_t(v); p[i + 1] = uint8_t(v >> 8); };
+    uint32_t word;
+    std::memcpy(&word, p, 4);
+
+    switch (type) {
+    case R_ARM_NONE:
+    case R_ARM_V4BX:
+        return true;
+    case R_ARM_ABS32:
+        word += s + uint32_t(addend);
+        std::memcpy(p, &word, 4);
+        return true;
+    case R_ARM_REL32:
+        word += s + uint32_t(addend) - place;
+        std::memcpy(p, &word, 4);
+        return true;
+    case R_ARM_THM_CALL: {
+        uint32_t first = get16(0), second = get16(2);
+        uint32_t sb = (first >> 10) & 1;
+        uint32_t i1 = !(((second >> 13) & 1) ^ sb);
+        uint32_t i2 = !(((second >> 11) & 1) ^ sb);
+        int32_t a = sign_extend(sb << 24 | i1 << 23 | i2 << 22 | (first & 0x3ff) << 12 | (second & 0x7ff) << 1, 25);
+        int64_t offset = int64_t(s & ~1u) + a + addend - place;
+        if (offset < -(1 << 24) || offset >= (1 << 24)) {
+            error = "BL out of range";
+            return false;
+        }
+        uint32_t o = uint32_t(offset);
+        sb = (o >> 24) & 1;
+        uint32_t j1 = !(((o >> 23) & 1) ^ sb);
+        uint32_t j2 = !(((o >> 22) & 1) ^ sb);
+        put16(0, 0xf000 | sb << 10 | ((o >> 12) & 0x3ff));
+        put16(2, (second & 0xd000) | j1 << 13 | j2 << 11 | ((o >> 1) & 0x7ff));
+        return true;
+    }
+    case R_ARM_THM_JUMP11:
+    case R_ARM_THM_JUMP8: {
+        unsigned bits = type == R_ARM_THM_JUMP11 ? 11 : 8;
+        uint32_t mask = (1u << bits) - 1;
+        uint32_t op = get16(0);
+        int64_t offset = int64_t(s & ~1u) + sign_extend((op & mask) << 1, bits + 1) + addend - place;
+        if (offset < -(1 << bits) || offset >= (1 << bits)) {
+            error = "branch out of range";
+            return false;
+        }
+        put16(0, (op & ~mask) | ((uint32_t(offset) >> 1) & mask));
+        return true;
+    }
+    }
+    error = "unsupported relocation type " + std::to_string(type);
+    return false;
+}
+
+
+/**
+ * @brief lay out the allocated sections of a relocatable object from SRAM_BASE and apply its relocations
+ */
+bool link(const elf_file& elf, image& img, std::string& error) {
+    const std::vector<elf_section>& sections = elf.sections();
+    std::vector<uint32_t> base(sections.size(), 0);
+    uint32_t cursor = board::SRAM_BASE;
+    for (size_t i = 0; i < sections.size(); i++) {
+        const elf_section& s = sections[i];
+        if (!(s.flags & elf_section::SHF_ALLOC)) {
+            continue;
+        }
+        if (s.addr) {
+            error = "section " + s.name + " already has an address, pass the object file rather than the linked image";
+            return false;
+        }
+        uint32_t align = uint32_t(std::max<uint64_t>(s.align, 4));
+        cursor = (cursor + align - 1) & ~(align - 1);
+        base[i] = cursor;
+        cursor += uint32_t(s.size);
+        if (cursor > board::SCRATCH_BASE) {
+            error = "object too large for SRAM";
+            return false;
+        }
+        img.bytes.resize(cursor - board::SRAM_BASE);
+        std::vector<uint8_t> data = elf.contents(i);
+        std::copy(data.begin(), data.end(), img.bytes.begin() + (base[i] - board::SRAM_BASE));
+    }
+    if (img.bytes.empty()) {
+        error = "nothing to load";
+        return false;
+    }
+    // room for a relocation at the very end
+    img.bytes.resize(img.bytes.size() + 4);
+
+    const std::vector<elf_symbol>& symtab = elf.symbol_table();
+    std::vector<uint32_t> values(symtab.size(), 0);
+    for (size_t i = 1; i < symtab.size(); i++) {
+        const elf_symbol& sym = symtab[i];
+        if (sym.section == elf_symbol::SHN_UNDEF && (sym.name == "sf_table" || sym.name == "sd_table")) {
+            cursor = (cursor + 3) & ~3u;
+            values[i] = cursor;
+            img.bytes.resize(cursor + 4 * std::size(ROM_TABLE_OPS) + 4 - board::SRAM_BASE);
+            for (const char* op : ROM_TABLE_OPS) {
+                uint32_t entry = stub_address(img, (sym.name == "sf_table" ? "rom_f" : "rom_d") + std::string(op)) | 1;
+                std::memcpy(&img.bytes[cursor - board::SRAM_BASE], &entry, 4);
+                cursor += 4;
+            }
+            if (cursor > board::SCRATCH_BASE) {
+                error = "object too large for SRAM";
+                return false;
+            }
+        } else if (sym.section == elf_symbol::SHN_UNDEF) {
+            values[i] = stub_address(img, sym.name) | 1;
+        } else if (sym.section == SHN_ABS) {
+            values[i] = uint32_t(sym.addr);
+        } else if (sym.section < sections.size() && base[sym.section]) {
+            values[i] = base[sym.section] + uint32_t(sym.addr);
+            if (sym.type != elf_symbol::STT_SECTION && !sym.name.empty() && sym.name[0] != '$') {
+                img.symbols.emplace(sym.name, values[i] & ~1u);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < sections.size(); i++) {
+        if (!base[i]) {
+            continue;
+        }
+        for (const elf_relocation& r : elf.relocations(i)) {
+            if (r.symbol >= values.size() || r.offset >= sections[i].size) {
+                error = "bad relocation in " + sections[i].name;
+                return false;
+            }
+            if (!relocate(img, base[i] + uint32_t(r.offset), r.type, values[r.symbol], r.addend, error)) {
+                error += " in " + sections[i].name + " against " + symtab[r.symbol].name;
+                return false;
+            }
+        }
+    }
+    img.bytes.resize(cursor - board::SRAM_BASE);
+    return true;
+}
+
+
+/**
+ * @brief a board with the image loaded, running routines to completion
+ */
+class simulation {
+public:
+    explicit simulation(const image& img) : hw(&cpu.cycles), cpu(hw), img_(img) {
+        hw.load(board::SRAM_BASE, img.bytes);
+        for (const auto& [name, addr] : img.symbols) {
+            labels_.emplace_back(addr, name);
+        }
+        std::sort(labels_.begin(), labels_.end());
+    }
+
+    /**
+     * @brief address of a symbol the object defines, 0 if it doesn't
+     */
+    uint32_t symbol(const std::string& name) const {
+        auto it = img_.symbols.find(name);
+        return it == img_.symbols.end() ? 0 : it->second;
+    }
+
+    /**
+     * @brief call a routine with up to four arguments and run until it returns
+     *
+     * @return r0
+     */
+    uint32_t call(uint32_t addr, const std::vector<uint32_t>& args = {}) {
+        for (size_t i = 0; i < args.size() && i < 4; i++) {
+            cpu.set_reg(unsigned(i), args[i]);
+        }
+        cpu.set_reg(cortex_m0::SP, board::STACK_TOP);
+        cpu.set_reg(cortex_m0::LR, RETURN_ADDRESS | 1);
+        cpu.set_pc(addr);
+        run();
+        if (cpu.pc() != RETURN_ADDRESS) {
+            throw sim_fault("routine at " + label(addr) + " stopped at " + label(cpu.pc()) + " instead of returning");
+        }
+        return cpu.reg(0);
+    }
+
+    /**
+     * @brief run the instructions at SCRATCH_BASE in thread mode, taking any exception that is pending
+     */
+    void run_thread(const std::vector<uint16_t>& code) {
+        std::vector<uint8_t> bytes;
+        for (uint16_t op : code) {
+            bytes.push_back(uint8_t(op));
+            bytes.push_back(uint8_t(op >> 8));
+        }
+        hw.load(board::SCRATCH_BASE, bytes);
+        cpu.set_reg(cortex_m0::SP, board::STACK_TOP);
+        cpu.set_pc(board::SCRATCH_BASE);
+        run();
+        if (cpu.halted() != cortex_m0::halt::bkpt) {
+            throw sim_fault("thread code didn't reach its BKPT");
+        }
+    }
+
+    void write_word(uint32_t addr, uint32_t value) { hw.write(addr, value, 4); }
+
+    // stub calls in the order they were made
+    std::vector<std::string> calls;
+
+    // print every instruction as it runs
+    bool trace = false;
+
+    board hw;
+    cortex_m0 cpu;
+
+private:
+    void run() {
+        uint64_t limit = cpu.instructions + MAX_INSTRUCTIONS;
+        cpu.clear_halt();
+        for (;;) {
+            uint32_t pc = cpu.pc();
+            if (pc == RETURN_ADDRESS) {
+                return;
+            }
+            if (pc - STUB_BASE < STUB_SIZE * img_.stubs.size()) {
+                run_stub(img_.stubs[(pc - STUB_BASE) / STUB_SIZE]);
+                continue;
+            }
+            hw.tick();
+            if (unsigned exception = hw.take_pending(cpu.ipsr(), cpu.primask())) {
+                if (trace) {
+                    std::printf("%10" PRIu64 "  exception %u\n", cpu.cycles, exception);
+                }
+                cpu.take_exception(exception);
+                continue;
+            }
+            if (trace) {
+                std::printf("%10" PRIu64 "  %08x  %04x  %s\n", cpu.cycles, pc, hw.read(pc, 2), label(pc).c_str());
+            }
+            cpu.step();
+            if (cpu.halted() == cortex_m0::halt::bkpt) {
+                return;
+            }
+            if (cpu.halted() != cortex_m0::halt::none) {
+                // the harness raises interrupts before it runs anything, so nothing would wake the core
+                throw sim_fault("sleeping at " + label(pc) + " with nothing to wake it");
+            }
+            if (cpu.instructions > limit) {
+                throw sim_fault("no return after " + std::to_string(MAX_INSTRUCTIONS) + " instructions, at " + label(pc));
+            }
+        }
+    }
+
+    void run_stub(const std::string& name) {
+        calls.push_back(name);
+        uint32_t r0 = cpu.reg(0), r1 = cpu.reg(1);
+        uint32_t result = 0;
+        if (name == "asm_gpio_init") {
+            hw.gpio_oe &= ~(1u << r0);
+            hw.gpio_out &= ~(1u << r0);
+        } else if (name == "asm_gpio_set_dir") {
+            hw.gpio_oe = r1 ? hw.gpio_oe | 1u << r0 : hw.gpio_oe & ~(1u << r0);
+        } else if (name == "asm_gpio_get") {
+            result = hw.pin_level(r0);
+        } else if (name == "asm_gpio_put") {
+            hw.set_output(r0, r1);
+        } else if (name == "asm_gpio_set_irq") {
+            hw.gpio_inte[r0 / 8] |= board::edge_low_mask(r0);
+        } else if (name == "asm_irq_set_priority") {
+            uint32_t reg = 0xe000e400 + (r0 & ~3u);
+            uint32_t shift = 8 * (r0 & 3);
+            hw.write(reg, (hw.read(reg, 4) & ~(0xffu << shift)) | (r1 & 0xff) << shift, 4);
+        } else if (name == "deferred_queue") {
+            result = 1;
+        } else if (name.compare(0, 5, "rom_f") == 0) {
+            float a, b;
+            std::memcpy(&a, &r0, 4);
+            std::memcpy(&b, &r1, 4);
+            float f = rom_op(name.substr(5), a, b);
+            std::memcpy(&result, &f, 4);
+        } else if (name.compare(0, 5, "rom_d") == 0) {
+            double d = rom_op(name.substr(5), reg_double(0), reg_double(2));
+            uint64_t bits;
+            std::memcpy(&bits, &d, 8);
+            result = uint32_t(bits);
+            cpu.set_reg(1, uint32_t(bits >> 32));
+        }
+        cpu.set_reg(0, result);
+        cpu.set_pc(cpu.reg(cortex_m0::LR));
+    }
+
+    template <typename T>
+    static T rom_op(const std::string& op, T a, T b) {
+        return op == "add" ? a + b : op == "sub" ? a - b : op == "mul" ? a * b : a / b;
+    }
+
+    double reg_double(unsigned lo) const {
+        uint64_t bits = cpu.reg(lo) | uint64_t(cpu.reg(lo + 1)) << 32;
+        double d;
+        std::memcpy(&d, &bits, 8);
+        return d;
+    }
+
+    std::string label(uint32_t addr) const {
+        auto it = std::upper_bound(labels_.begin(), labels_.end(), std::make_pair(addr, std::string("\xff")));
+        if (it == labels_.begin()) {
+            char buf[16];
+            std::snprintf(buf, sizeof(buf), "0x%08x", addr);
+            return buf;
+        }
+        --it;
+        return addr == it->first ? it->second : it->second + "+" + std::to_string(addr - it->first);
+    }
+
+    const image& img_;
+    std::vector<std::pair<uint32_t, std::string>> labels_;
+};
+
+
+/**
+ * @brief one way through a routine: set-up that isn't counted, then the counted part
+ */
+struct sim_path {
+    std::string name;
+    std::function<void(simulation&)> setup;
+    std::function<void(simulation&)> body;
+};
+
+
+struct path_result {
+    std::string name;
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    std::vector<std::string> calls;
+    std::string error;
+};
+
+
+// thread code an interrupt arrives in: a BKPT to stop at once the handler returns
+const std::vector<uint16_t> idle_thread = {0xbe00};
+
+
+void call_if_defined(simulation& sim, const char* name) {
+    if (uint32_t addr = sim.symbol(name)) {
+        sim.call(addr);
+    }
+}
+
+
+/**
+ * @brief run the thread code, which has to be interrupted at least once
+ */
+void interrupted(simulation& sim, const std::vector<uint16_t>& code = idle_thread) {
+    sim.run_thread(code);
+    if (!sim.cpu.exceptions_returned) {
+        throw sim_fault("no handler ran");
+    }
+}
+
+
+void add_assign01_paths(const image& img, std::vector<sim_path>& paths) {
+    if (!img.symbols.count("gpio_isr") || !img.symbols.count("alrm_isr")) {
+        return;
+    }
+    auto setup = [](uint32_t lstate, bool led) {
+        return [=](simulation& sim) {
+            call_if_defined(sim, "install_alarm_isr");
+            call_if_defined(sim, "install_gpio_isr");
+            call_if_defined(sim, "init_leds");
+            call_if_defined(sim, "init_btns");
+            if (uint32_t addr = sim.symbol("lstate")) {
+                sim.write_word(addr, lstate);
+            }
+            sim.hw.set_output(LED_PIN, led);
+        };
+    };
+    static const std::pair<const char*, uint32_t> states[] = {{"flashing", 1}, {"paused", 0}};
+    static const std::pair<const char*, unsigned> buttons[] = {{"down", BTN_DN}, {"enter", BTN_EN}, {"up", BTN_UP}};
+
+    for (const auto& [button, pin] : buttons) {
+        for (const auto& [state, lstate] : states) {
+            unsigned p = pin;
+            paths.push_back({std::string("gpio_isr/") + button + "/" + state, setup(lstate, false), [p](simulation& sim) {
+                sim.hw.set_input(p, false);
+                interrupted(sim);
+            }});
+        }
+    }
+    paths.push_back({"gpio_isr/spurious", setup(1, false), [](simulation& sim) {
+        sim.hw.pend_irq(board::IO_IRQ_BANK0);
+        interrupted(sim);
+    }});
+
+    for (bool led : {false, true}) {
+        for (const auto& [state, lstate] : states) {
+            paths.push_back({std::string("alrm_isr/") + (led ? "led_on/" : "led_off/") + state, setup(lstate, led),
+                             [](simulation& sim) {
+                sim.hw.fire_alarm();
+                sim.hw.pend_irq(board::TIMER_IRQ_0);
+                interrupted(sim);
+            }});
+        }
+    }
+}
+
+
+void add_toggle_paths(const image& img, std::vector<sim_path>& paths) {
+    if (!img.symbols.count("sub_toggle")) {
+        return;
+    }
+    for (bool led : {false, true}) {
+        paths.push_back({std::string("sub_toggle/") + (led ? "led_on" : "led_off"), [led](simulation& sim) {
+            sim.hw.gpio_oe |= 1u << LED_PIN;
+            sim.hw.set_output(LED_PIN, led);
+        }, [](simulation& sim) {
+            sim.call(sim.symbol("sub_toggle"));
+        }});
+    }
+}
+
+
+void add_svc_paths(const image& img, std::vector<sim_path>& paths) {
+    if (!img.symbols.count("svc_isr")) {
+        return;
+    }
+    for (uint16_t n = 0; n < 3; n++) {
+        paths.push_back({"svc_isr/svc_" + std::to_string(n), [](simulation& sim) {
+            call_if_defined(sim, "init_gpio_led");
+            call_if_defined(sim, "install_svc_isr");
+        }, [n](simulation& sim) {
+            interrupted(sim, {uint16_t(0xdf00 | n), 0xbe00});
+        }});
+    }
+}
+
+
+/**
+ * @brief wallis_prod<T, 1, wallis_fusion::increment>() from lib/wallis, the steps the assembly kernels take
+ */
+template <typename T>
+T wallis_reference(uint32_t n) {
+    T product = 1, sq = 4, delta = 12;
+    for (uint32_t i = 0; i < n; i++) {
+        product += product / (sq - T(1));
+        sq += delta;
+        delta += T(8);
+    }
+    return product * T(2);
+}
+
+
+void add_wallis_paths(const image& img, std::vector<sim_path>& paths) {
+    const uint32_t n = 100;
+    auto no_setup = [](simulation&) {};
+    if (img.symbols.count("wallis_asm_float")) {
+        paths.push_back({"wallis_asm_float/n_100", no_setup, [n](simulation& sim) {
+            float expect = wallis_reference<float>(n);
+            uint32_t bits;
+            std::memcpy(&bits, &expect, 4);
+            if (sim.call(sim.symbol("wallis_asm_float"), {n}) != bits) {
+                throw sim_fault("result differs from the increment kernel");
+            }
+        }});
+    }
+    if (img.symbols.count("wallis_asm_double")) {
+        paths.push_back({"wallis_asm_double/n_100", no_setup, [n](simulation& sim) {
+            double expect = wallis_reference<double>(n);
+            uint64_t bits;
+            std::memcpy(&bits, &expect, 8);
+            uint32_t lo = sim.call(sim.symbol("wallis_asm_double"), {n});
+            if (lo != uint32_t(bits) || sim.cpu.reg(1) != uint32_t(bits >> 32)) {
+                throw sim_fault("result differs from the increment kernel");
+            }
+        }});
+    }
+}
+
+
+path_result run_path(const image& img, const sim_path& path, bool trace) {
+    path_result r;
+    r.name = path.name;
+    simulation sim(img);
+    try {
+        path.setup(sim);
+        sim.calls.clear();
+        sim.trace = trace;
+        uint64_t cycles = sim.cpu.cycles, instructions = sim.cpu.instructions;
+        if (trace) {
+            std::printf("%s:\n", path.name.c_str());
+        }
+        path.body(sim);
+        r.cycles = sim.cpu.cycles - cycles;
+        r.instructions = sim.cpu.instructions - instructions;
+    } catch (const sim_fault& e) {
+        r.error = e.what();
+    }
+    r.calls = sim.calls;
+    return r;
+}
+
+
+void print_results(const std::vector<path_result>& results) {
+    std::printf("%-28s %8s %8s  %s\n", "path", "cycles", "instrs", "calls");
+    for (const path_result& r : results) {
+        if (!r.error.empty()) {
+            std::printf("%-28s  error: %s\n", r.name.c_str(), r.error.c_str());
+            continue;
+        }
+        std::string calls;
+        if (r.calls.size() > MAX_LISTED_CALLS) {
+            // loops, count each callee instead
+            std::map<std::string, size_t> counts;
+            for (const std::string& c : r.calls) {
+                counts[c]++;
+            }
+            for (const auto& [name, count] : counts) {
+                calls += (calls.empty() ? "" : " ") + name + " x" + std::to_string(count);
+            }
+        }
+        for (size_t i = 0; i < r.calls.size() && r.calls.size() <= MAX_LISTED_CALLS; i++) {
+            calls += (calls.empty() ? "" : " ") + r.calls[i];
+        }
+        std::printf("%-28s %8" PRIu64 " %8" PRIu64 "  %s\n", r.name.c_str(), r.cycles, r.instructions, calls.c_str());
+    }
+}
+
+
+bool save_baseline(const std::string& path, const std::vector<path_result>& results) {
+    std::ofstream out(path);
+    out << "# m0sim cycle counts: path cycles\n";
+    for (const path_result& r : results) {
+        if (r.error.empty()) {
+            out << r.name << ' ' << r.cycles << '\n';
+        }
+    }
+    return bool(out);
+}
+
+
+/**
+ * @brief compare against a saved baseline
+ *
+ * @return false if a path got slower or failed
+ */
+bool check_baseline(const std::string& path, const std::vector<path_result>& results) {
+    std::ifstream in(path);
+    if (!in) {
+        std::fprintf(stderr, "m0sim: can't read %s\n", path.c_str());
+        return false;
+    }
+    std::map<std::string, uint64_t> baseline;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string name;
+        uint64_t cycles;
+        if (line.empty() || line[0] == '#' || !(fields >> name >> cycles)) {
+            continue;
+        }
+        baseline[name] = cycles;
+    }
+
+    bool ok = true;
+    std::printf("\nagainst %s:\n", path.c_str());
+    for (const path_result& r : results) {
+        auto it = baseline.find(r.name);
+        if (!r.error.empty()) {
+            std::printf("  %-28s failed\n", r.name.c_str());
+            ok = false;
+        } else if (it == baseline.end()) {
+            std::printf("  %-28s new, %" PRIu64 " cycles\n", r.name.c_str(), r.cycles);
+        } else if (r.cycles != it->second) {
+            bool slower = r.cycles > it->second;
+            std::printf("  %-28s %" PRIu64 " -> %" PRIu64 " cycles (%+" PRId64 ")%s\n", r.name.c_str(), it->second,
+                        r.cycles, int64_t(r.cycles - it->second), slower ? "  SLOWER" : "");
+            ok = ok && !slower;
+        }
+    }
+    std::printf("%s\n", ok ? "no regressions" : "REGRESSION");
+    return ok;
+}
+
+
+/**
+ * @brief run known instruction sequences and check registers, flags and cycle counts
+ */
+int selftest() {
+    selftest_checks check;
+
+    // assembled with llvm-mc -triple=thumbv6m-none-eabi, loaded at SRAM_BASE
+    static const uint16_t program[] = {
+        0x2005,         // 00 t1:   movs r0, #5
+        0x3806,         // 02       subs r0, #6
+        0x490d,         // 04       ldr r1, [pc, #52]   @ 0x7fffffff
+        0x3101,         // 06       adds r1, #1
+        0xbe00,         // 08       bkpt
+        0x200a,         // 0a t2:   movs r0, #10
+        0x3801,         // 0c 1:    subs r0, #1
+        0xd1fd,         // 0e       bne 1b
+        0xbe00,         // 10       bkpt
+        0x2407,         // 12 t3:   movs r4, #7
+        0xf000, 0xf801, // 14       bl f
+        0xbe00,         // 18       bkpt
+        0xb510,         // 1a f:    push {r4, lr}
+        0x2401,         // 1c       movs r4, #1
+        0xbd10,         // 1e       pop {r4, pc}
+        0x4807,         // 20 t4:   ldr r0, [pc, #28]   @ 0x20000100
+        0x212a,         // 22       movs r1, #42
+        0x6001,         // 24       str r1, [r0]
+        0x6802,         // 26       ldr r2, [r0]
+        0x4b06,         // 28       ldr r3, [pc, #24]   @ SIO_BASE
+        0x681b,         // 2a       ldr r3, [r3]        @ CPUID
+        0xbe00,         // 2c       bkpt
+        0x2055,         // 2e t5:   movs r0, #0x55
+        0xdf03,         // 30       svc #3
+        0xbe00,         // 32       bkpt
+        0x9806,         // 34 svc:  ldr r0, [sp, #24]   @ stacked PC
+        0x3802,         // 36       subs r0, #2
+        0x8800,         // 38       ldrh r0, [r0]       @ the SVC instruction
+        0x4770,         // 3a       bx lr
+        0xffff, 0x7fff, // 3c
+        0x0100, 0x2000, // 40
+        0x0000, 0xd000, // 44
+    };
+    std::vector<uint8_t> bytes;
+    for (uint16_t op : program) {
+        bytes.push_back(uint8_t(op));
+        bytes.push_back(uint8_t(op >> 8));
+    }
+
+    uint64_t cycles = 0;
+    board hw(&cycles);
+    cortex_m0 cpu(hw);
+    hw.load(board::SRAM_BASE, bytes);
+    hw.write(board::VECTOR_TABLE + 4 * cortex_m0::EXC_SVCALL, (board::SRAM_BASE + 0x34) | 1, 4);
+
+    auto run = [&](uint32_t offset) {
+        cpu.cycles = 0;
+        cpu.clear_halt();
+        cpu.set_pc(board::SRAM_BASE + offset);
+        for (int i = 0; i < 100 && cpu.halted() == cortex_m0::halt::none; i++) {
+            cpu.step();
+        }
+        return cpu.cycles;
+    };
+    cpu.set_reg(cortex_m0::SP, board::STACK_TOP);
+
+    try {
+        check(run(0x00) == 5, "t1 cycles");
+        check(cpu.reg(0) == 0xffffffff && cpu.n && !cpu.c && !cpu.z, "subs borrow");
+        check(cpu.reg(1) == 0x80000000 && cpu.v, "adds overflow");
+
+        check(run(0x0a) == 30, "loop of 10: 1 + 10 subs + 9 taken + 1 not taken");
+        check(cpu.reg(0) == 0 && cpu.z, "loop count");
+
+        check(run(0x12) == 13, "bl, push and pop pc");
+        check(cpu.reg(4) == 7 && cpu.reg(cortex_m0::SP) == board::STACK_TOP, "callee saved r4");
+
+        check(run(0x20) == 10, "SRAM loads cost 2, SIO loads 1");
+        check(cpu.reg(2) == 42 && cpu.reg(3) == 0, "store, load and CPUID");
+
+        // an unaligned SP makes the exception entry pad the frame
+        cpu.set_reg(cortex_m0::SP, board::STACK_TOP - 4);
+        cpu.cycles = 0;
+        cpu.clear_halt();
+        cpu.set_pc(board::SRAM_BASE + 0x2e);
+        while (cpu.pc() != board::SRAM_BASE + 0x3a) {
+            cpu.step();
+        }
+        check(cpu.ipsr() == cortex_m0::EXC_SVCALL && cpu.reg(0) == 0xdf03, "handler sees the SVC");
+        check(cpu.reg(cortex_m0::LR) == 0xfffffff9 && cpu.reg(cortex_m0::SP) == board::STACK_TOP - 40,
+              "frame and EXC_RETURN");
+        cpu.step();
+        check(cpu.ipsr() == 0 && cpu.reg(0) == 0x55 && cpu.reg(cortex_m0::SP) == board::STACK_TOP - 4,
+              "exception return restores r0 and SP");
+        check(cpu.exceptions_returned == 1 && cpu.pc() == board::SRAM_BASE + 0x32, "return address");
+        check(cpu.cycles == 1 + cortex_m0::EXC_ENTRY_CYCLES + 2 + 1 + 2 + 2 + cortex_m0::EXC_RETURN_CYCLES,
+              "svc round trip");
+    } catch (const sim_fault& e) {
+        check(false, e.what());
+    }
+
+    // the highest priority pending interrupt is taken first, and never one of equal priority
+    hw.write(0xe000e100, 1u << board::TIMER_IRQ_0 | 1u << board::IO_IRQ_BANK0, 4);
+    hw.write(0xe000e40c, 0x40u << 8, 4);        // IRQ 13 at 0x40, IRQ 0 at 0
+    hw.pend_irq(board::IO_IRQ_BANK0);
+    hw.pend_irq(board::TIMER_IRQ_0);
+    check(hw.take_pending(0, true) == 0, "PRIMASK masks");
+    check(hw.take_pending(0, false) == cortex_m0::EXC_IRQ0 + board::TIMER_IRQ_0, "priority order");
+    check(hw.take_pending(cortex_m0::EXC_IRQ0 + board::TIMER_IRQ_0, false) == 0, "no preemption by lower priority");
+    check(hw.take_pending(0, false) == cortex_m0::EXC_IRQ0 + board::IO_IRQ_BANK0, "then the other");
+
+    // a falling edge on an enabled pin latches and raises IO_IRQ_BANK0
+    hw.gpio_inte[2] = board::edge_low_mask(21);
+    hw.set_input(21, false);
+    check(hw.read(0x40014128, 4) == board::edge_low_mask(21), "PROC0_INTS2");
+    check(hw.take_pending(0, false) == cortex_m0::EXC_IRQ0 + board::IO_IRQ_BANK0, "edge interrupt");
+    hw.write(0x400140f8, board::edge_low_mask(21), 4);
+    check(hw.read(0x40014128, 4) == 0, "INTR2 write to clear");
+
+    // the APB atomic aliases
+    hw.write(0x40054038 + 0x2000, 1, 4);
+    hw.write(0x40054038 + 0x2000, 4, 4);
+    hw.write(0x40054038 + 0x3000, 1, 4);
+    check(hw.read(0x40054038, 4) == 4, "SET and CLR aliases");
+
+    return check.finish();
+}
+
+
+void usage() {
+    std::fprintf(stderr, "usage: m0sim [--trace] [--save file | --check file] <object.o>\n"
+                         "       m0sim [--trace] <object.o> --call <symbol> [r0 [r1 [r2 [r3]]]]\n"
+                         "       m0sim --selftest\n");
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    bool trace = false;
+    std::string object, save, check, call;
+    std::vector<uint32_t> args;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--selftest") {
+            return selftest();
+        } else if (arg == "--trace") {
+            trace = true;
+        } else if (arg == "--save" && has_value) {
+            save = argv[++i];
+        } else if (arg == "--check" && has_value) {
+            check = argv[++i];
+        } else if (arg == "--call" && has_value) {
+            call = argv[++i];
+            while (i + 1 < argc && argv[i + 1][0] != '-') {
+                args.push_back(uint32_t(std::strtoul(argv[++i], nullptr, 0)));
+            }
+        } else if (object.empty() && arg[0] != '-') {
+            object = arg;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (object.empty() || args.size() > 4) {
+        usage();
+        return 2;
+    }
+
+    elf_file elf;
+    image img;
+    std::string error;
+    if (!elf.load(object, error)) {
+        std::fprintf(stderr, "m0sim: %s\n", error.c_str());
+        return 1;
+    }
+    if (elf.machine() != elf_file::EM_ARM || elf.is_64bit()) {
+        std::fprintf(stderr, "m0sim: %s is not an ARM object\n", object.c_str());
+        return 1;
+    }
+    if (!link(elf, img, error)) {
+        std::fprintf(stderr, "m0sim: %s: %s\n", object.c_str(), error.c_str());
+        return 1;
+    }
+
+    std::vector<sim_path> paths;
+    if (!call.empty()) {
+        if (!img.symbols.count(call)) {
+            std::fprintf(stderr, "m0sim: %s doesn't define %s\n", object.c_str(), call.c_str());
+            return 1;
+        }
+        paths.push_back({call, [](simulation&) {}, [call, args](simulation& sim) {
+            uint32_t r0 = sim.call(sim.symbol(call), args);
+            std::printf("%s returned 0x%08x\n", call.c_str(), r0);
+        }});
+    } else {
+        add_assign01_paths(img, paths);
+        add_toggle_paths(img, paths);
+        add_svc_paths(img, paths);
+        add_wallis_paths(img, paths);
+    }
+    if (paths.empty()) {
+        std::fprintf(stderr, "m0sim: no known routines in %s, use --call\n", object.c_str());
+        return 1;
+    }
+
+    std::vector<path_result> results;
+    bool ok = true;
+    for (const sim_path& p : paths) {
+        results.push_back(run_path(img, p, trace));
+        ok = ok && results.back().error.empty();
+    }
+    print_results(results);
+
+    if (!save.empty() && !save_baseline(save, results)) {
+        std::fprintf(stderr, "m0sim: can't write %s\n", save.c_str());
+        return 1;
+    }
+    if (!check.empty()) {
+        ok = check_baseline(check, results) && ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,669 @@
+/*****************************************************************//**
+ * \file   multicore_stress.cpp
+ * \brief  stress tests of the dual-core FIFO protocols on the host
+ *
+ * Runs the inter-core protocols of the dual-core programs against
+ * the pico_host emulation, many times over under the deterministic
+ * schedule with a different seed each time and a few times under the
+ * free one:
+ *
+ *   dispatch   multi_c: core 1 pops a function pointer and an
+ *              argument and pushes the result, core 0 keeps up to 8
+ *              jobs in flight and checks every result
+ *   lab07      lab07: core 1 times the float kernel it is sent while
+ *              core 0 runs the double one, then core 1 is reset and
+ *              launched again
+ *   blink      lab01_multicore: core 1 toggles an LED every delay and
+ *              takes a new delay from the FIFO between toggles; the toggle
+ *              count is only checked against virtual time
+ *   stream     10000 words through the FIFO to a core 1 that stalls
+ *              now and then, so the FIFO fills and the pusher blocks
+ *   overrun    dispatch with 20 jobs pushed before any result is
+ *              popped: core 1 blocks pushing its 9th result while core
+ *              0 blocks pushing the rest. Expected to deadlock, so it
+ *              only runs under the deterministic schedule.
+ *
+ *   multicore_stress [--seeds N] [--free N] [scenario...]
+ *   multicore_stress --seed S [--trace file] <scenario>
+ *   multicore_stress --overhead [jobs]
+ *   multicore_stress --selftest
+ *
+ * Every run is a child process, so a deadlock or a hang (killed after
+ * RUN_TIMEOUT_S) doesn't end the others. The summary gives, per
+ * scenario, the outcomes and how often the interleavings filled each
+ * FIFO and blocked a core, which shows how much of the protocol the
+ * seeds covered. A failing seed is rerun alone with --seed and
+ * --trace to get its FIFO events.
+ *
+ * --overhead dispatches an empty function under the free schedule,
+ * one at a time and pipelined, and reports the round trip. That is
+ * the cost of waking a host thread, far above the few cycles of the
+ * SIO FIFO, so it only says how the protocols compare: how many round
+ * trips a job takes and how much pipelining hides.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "pico/multicore.h"
+#include "pico/stdlib.h"
+#include "pico_host.h"
+#include "selftest.hpp"
+#include "wallis.h"
+
+namespace {
+
+// a run still going after this long is counted as a hang
+constexpr unsigned RUN_TIMEOUT_S = 20;
+
+
+// dispatch, as multi_c does it
+
+int32_t factorial(int32_t n) {
+    int32_t f = 1;
+    for (int32_t i = 2; i <= n; i++) {
+        f *= i;
+    }
+    return f;
+}
+
+
+int32_t fibonacci(int32_t n) {
+    int32_t a = 0, b = 1;
+    for (int32_t i = 0; i < n; i++) {
+        int32_t c = a + b;
+        a = b;
+        b = c;
+    }
+    return a;
+}
+
+
+int32_t nothing(int32_t n) {
+    return n;
+}
+
+
+void dispatcher() {
+    while (true) {
+        auto func = reinterpret_cast<int32_t (*)(int32_t)>(multicore_fifo_pop_blocking());
+        int32_t p = int32_t(multicore_fifo_pop_blocking());
+        multicore_fifo_push_blocking(uint32_t(func(p)));
+    }
+}
+
+
+void dispatch_job(uint32_t i) {
+    multicore_fifo_push_blocking(reinterpret_cast<uintptr_t>(i & 1 ? &factorial : &fibonacci));
+    multicore_fifo_push_blocking(i % 13);
+}
+
+
+/**
+ * @brief send jobs in batches of 1 to depth and check every result
+ */
+int run_dispatch(uint32_t jobs, uint32_t depth) {
+    multicore_launch_core1(dispatcher);
+    uint32_t sent = 0;
+    uint32_t batch = 1;
+    while (sent < jobs) {
+        uint32_t n = std::min(batch, jobs - sent);
+        for (uint32_t i = 0; i < n; i++) {
+            dispatch_job(sent + i);
+        }
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t job = sent + i;
+            int32_t want = job & 1 ? factorial(job % 13) : fibonacci(job % 13);
+            int32_t got = int32_t(multicore_fifo_pop_blocking());
+            if (got != want) {
+                std::fprintf(stderr, "dispatch: job %u returned %d, expected %d\n", job, got, want);
+                return 1;
+            }
+        }
+        sent += n;
+        batch = batch % depth + 1;
+    }
+    return 0;
+}
+
+
+int scenario_dispatch() {
+    // the results of 8 jobs just fit core 1's FIFO
+    return run_dispatch(400, PICO_HOST_FIFO_DEPTH);
+}
+
+
+int scenario_overrun() {
+    multicore_launch_core1(dispatcher);
+    for (uint32_t i = 0; i < 20; i++) {
+        dispatch_job(i);
+    }
+    for (uint32_t i = 0; i < 20; i++) {
+        multicore_fifo_pop_blocking();
+    }
+    return 0;
+}
+
+
+// lab07: core 1 runs the kernel it is sent and returns the time it took
+
+void lab07_core1() {
+    while (true) {
+        void* func_ptr = reinterpret_cast<void*>(multicore_fifo_pop_blocking());
+        size_t iterations = multicore_fifo_pop_blocking();
+        uint64_t start = time_us_64();
+        if (func_ptr == reinterpret_cast<void*>(&wallis_prod_float)) {
+            volatile float result = wallis_prod_float(iterations);
+            (void)result;
+        } else {
+            volatile double result = wallis_prod_double(iterations);
+            (void)result;
+        }
+        multicore_fifo_push_blocking(time_us_64() - start);
+    }
+}
+
+
+int scenario_lab07() {
+    const size_t iterations = 20000;
+    for (int launch = 0; launch < 2; launch++) {
+        multicore_launch_core1(lab07_core1);
+        for (int scenario = 3; scenario <= 4; scenario++) {
+            multicore_fifo_push_blocking(reinterpret_cast<uintptr_t>(&wallis_prod_float));
+            multicore_fifo_push_blocking(iterations);
+            double pi = wallis_prod_double(iterations);
+            uint64_t single_time = multicore_fifo_pop_blocking();
+            (void)single_time;
+            if (std::fabs(pi - M_PI) > 1e-3) {
+                std::fprintf(stderr, "lab07: pi %.6f\n", pi);
+                return 1;
+            }
+            if (multicore_fifo_rvalid()) {
+                std::fprintf(stderr, "lab07: core 1 sent more than its time\n");
+                return 1;
+            }
+        }
+        // as lab07 does before writing flash; the next launch starts core 1 afresh
+        multicore_reset_core1();
+    }
+    return 0;
+}
+
+
+// lab01_multicore: the blink delay is changed through the FIFO
+
+const uint32_t blink_delays[] = {50, 10, 25, 2, 40};
+std::vector<uint32_t> blink_seen;
+
+void blink_core1() {
+    uint32_t delay = multicore_fifo_pop_blocking();
+    uint32_t toggles = 0;
+    bool led = false;
+    blink_seen.push_back(delay);
+    while (true) {
+        led = !led;
+        toggles++;
+        // wait out the half period unless a new delay arrives first
+        uint32_t next;
+        absolute_time_t until = make_timeout_time_ms(delay);
+        while (!time_reached(until)) {
+            int64_t left = absolute_time_diff_us(get_absolute_time(), until);
+            if (left > 0 && multicore_fifo_pop_timeout_us(uint64_t(left), &next)) {
+                if (next == 0) {
+                    multicore_fifo_push_blocking(toggles);
+                    return;
+                }
+                delay = next;
+                blink_seen.push_back(delay);
+            }
+        }
+    }
+}
+
+
+int scenario_blink() {
+    blink_seen.clear();
+    multicore_launch_core1(blink_core1);
+    for (uint32_t d : blink_delays) {
+        multicore_fifo_push_blocking(d);
+        sleep_ms(200);
+    }
+    multicore_fifo_push_blocking(0);
+    uint32_t toggles = multicore_fifo_pop_blocking();
+
+    // core 1 returned before pushing the count, so blink_seen is complete
+    if (!std::equal(blink_seen.begin(), blink_seen.end(), std::begin(blink_delays), std::end(blink_delays))) {
+        std::fprintf(stderr, "blink: core 1 saw %zu of %zu delays, or out of order\n", blink_seen.size(),
+                     std::size(blink_delays));
+        return 1;
+    }
+    // 200 ms at each delay, give or take a toggle for every change. Only virtual time is exact
+    // enough to count on, a free run oversleeps every half period by the host's timer slack
+    if (pico_host_schedule() != PICO_HOST_DETERMINISTIC) {
+        return 0;
+    }
+    uint32_t expected = 0;
+    for (uint32_t d : blink_delays) {
+        expected += 200 / d;
+    }
+    uint32_t slack = 2 * std::size(blink_delays);
+    if (toggles + slack < expected || toggles > expected + slack) {
+        std::fprintf(stderr, "blink: %u toggles, expected about %u\n", toggles, expected);
+        return 1;
+    }
+    return 0;
+}
+
+
+// stream: sequence numbers to a core 1 that stalls at times
+
+constexpr uint32_t STREAM_WORDS = 10000;
+
+void stream_core1() {
+    uint32_t expect = 0;
+    uint32_t bad = 0;
+    uint32_t stall = 1;
+    for (uint32_t i = 0; i < STREAM_WORDS; i++) {
+        uint32_t w = multicore_fifo_pop_blocking();
+        bad += w != expect++;
+        stall = stall * 1103515245u + 12345u;
+        if ((stall >> 16) % 64 == 0) {
+            sleep_us(50);
+        }
+    }
+    multicore_fifo_push_blocking(bad);
+}
+
+
+int scenario_stream() {
+    multicore_launch_core1(stream_core1);
+    for (uint32_t i = 0; i < STREAM_WORDS; i++) {
+        multicore_fifo_push_blocking(i);
+    }
+    uint32_t bad = multicore_fifo_pop_blocking();
+    if (bad) {
+        std::fprintf(stderr, "stream: %u words out of sequence\n", bad);
+        return 1;
+    }
+    return 0;
+}
+
+
+struct scenario {
+    const char* name;
+    int (*run)();
+    bool deadlocks;     // a deadlock is the expected outcome
+};
+
+const scenario scenarios[] = {
+    {"dispatch", scenario_dispatch, false},
+    {"lab07", scenario_lab07, false},
+    {"blink", scenario_blink, false},
+    {"stream", scenario_stream, false},
+    {"overrun", scenario_overrun, true},
+};
+
+
+const scenario* find_scenario(const char* name) {
+    for (const scenario& s : scenarios) {
+        if (std::strcmp(s.name, name) == 0) {
+            return &s;
+        }
+    }
+    return nullptr;
+}
+
+
+enum class outcome { pass, fail, deadlock, hang };
+
+/**
+ * @brief what a run reports back through its pipe
+ */
+struct run_report {
+    uint64_t switches;
+    pico_host_fifo_stats_t fifo[2];
+};
+
+struct run_result {
+    outcome result;
+    bool reported;
+    run_report report;
+};
+
+
+/**
+ * @brief run a function in a child process with the emulation configured
+ */
+template <typename Fn>
+run_result run_child(pico_host_sched_t sched, uint32_t seed, const char* trace, Fn fn, bool quiet = false) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        std::perror("pipe");
+        std::exit(1);
+    }
+    std::fflush(stdout);
+    std::fflush(stderr);
+    pid_t pid = fork();
+    if (pid < 0) {
+        std::perror("fork");
+        std::exit(1);
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        alarm(RUN_TIMEOUT_S);
+        if (quiet && !std::freopen("/dev/null", "w", stderr)) {
+            std::exit(1);
+        }
+        pico_host_configure(sched, seed, trace);
+        int status = fn();
+        run_report rep = {};
+        rep.switches = pico_host_switches();
+        pico_host_fifo_stats(0, &rep.fifo[0]);
+        pico_host_fifo_stats(1, &rep.fifo[1]);
+        ssize_t written = write(fds[1], &rep, sizeof(rep));
+        (void)written;
+        std::fflush(stdout);
+        std::fflush(stderr);
+        // core 1 may still be running, don't wait for it
+        std::exit(status);
+    }
+
+    close(fds[1]);
+    run_result r = {};
+    r.reported = read(fds[0], &r.report, sizeof(r.report)) == ssize_t(sizeof(r.report));
+    close(fds[0]);
+    int status;
+    waitpid(pid, &status, 0);
+    if (WIFSIGNALED(status)) {
+        r.result = WTERMSIG(status) == SIGALRM ? outcome::hang : outcome::fail;
+    } else if (WEXITSTATUS(status) == PICO_HOST_DEADLOCK_STATUS) {
+        r.result = outcome::deadlock;
+    } else {
+        r.result = WEXITSTATUS(status) == 0 && r.reported ? outcome::pass : outcome::fail;
+    }
+    return r;
+}
+
+
+/**
+ * @brief outcomes and coverage of one scenario over many runs
+ */
+struct tally {
+    uint32_t runs = 0;
+    uint32_t outcomes[4] = {};
+    uint32_t full[2] = {};          // runs in which the FIFO from core N filled
+    uint32_t push_blocked[2] = {};
+    uint32_t pop_blocked[2] = {};
+    uint64_t switches_min = UINT64_MAX;
+    uint64_t switches_max = 0;
+    std::vector<uint32_t> bad_seeds;
+
+    void add(const run_result& r, bool det, uint32_t seed, bool deadlock_expected) {
+        runs++;
+        outcomes[int(r.result)]++;
+        bool good = deadlock_expected ? r.result == outcome::deadlock : r.result == outcome::pass;
+        if (!good && det) {
+            bad_seeds.push_back(seed);
+        }
+        if (!r.reported) {
+            return;
+        }
+        for (int c = 0; c < 2; c++) {
+            full[c] += r.report.fifo[c].max_level == PICO_HOST_FIFO_DEPTH;
+            push_blocked[c] += r.report.fifo[c].push_blocks != 0;
+            pop_blocked[c] += r.report.fifo[c].pop_blocks != 0;
+        }
+        if (det) {
+            switches_min = std::min(switches_min, r.report.switches);
+            switches_max = std::max(switches_max, r.report.switches);
+        }
+    }
+};
+
+
+/**
+ * @brief run scenarios over seeds 1 to seeds and free runs, print the summary
+ *
+ * @return true if every run had its expected outcome
+ */
+bool stress(const std::vector<const scenario*>& which, uint32_t seeds, uint32_t free_runs) {
+    bool ok = true;
+    std::printf("scenario   runs  pass  fail  deadlock  hang  full 0>1 1>0  push blocked  pop blocked  hand-overs\n");
+    for (const scenario* s : which) {
+        tally det, all;
+        for (uint32_t seed = 1; seed <= seeds; seed++) {
+            run_result r = run_child(PICO_HOST_DETERMINISTIC, seed, nullptr, s->run, s->deadlocks);
+            det.add(r, true, seed, s->deadlocks);
+            all.add(r, true, seed, s->deadlocks);
+        }
+        // a free run can't detect a deadlock, it would only hang
+        for (uint32_t i = 0; i < free_runs && !s->deadlocks; i++) {
+            all.add(run_child(PICO_HOST_FREE, 0, nullptr, s->run), false, 0, false);
+        }
+
+        uint32_t good = s->deadlocks ? all.outcomes[int(outcome::deadlock)] : all.outcomes[int(outcome::pass)];
+        ok &= good == all.runs;
+
+        std::printf("%-9s %5u %5u %5u %9u %5u %8u %3u %8u %4u %7u %4u", s->name, all.runs,
+                    all.outcomes[int(outcome::pass)], all.outcomes[int(outcome::fail)],
+                    all.outcomes[int(outcome::deadlock)], all.outcomes[int(outcome::hang)], all.full[0], all.full[1],
+                    all.push_blocked[0], all.push_blocked[1], all.pop_blocked[0], all.pop_blocked[1]);
+        if (det.switches_max) {
+            std::printf("  %llu-%llu", (unsigned long long)det.switches_min, (unsigned long long)det.switches_max);
+        }
+        std::printf("\n");
+        if (!det.bad_seeds.empty()) {
+            std::printf("  unexpected outcome with seeds");
+            for (size_t i = 0; i < det.bad_seeds.size() && i < 10; i++) {
+                std::printf(" %u", det.bad_seeds[i]);
+            }
+            std::printf("%s, rerun one with --seed S --trace file %s\n", det.bad_seeds.size() > 10 ? " ..." : "",
+                        s->name);
+        }
+    }
+    return ok;
+}
+
+
+uint32_t overhead_jobs = 100000;
+
+/**
+ * @brief time empty jobs one at a time and pipelined, in the child
+ */
+int overhead() {
+    using clk = std::chrono::steady_clock;
+    multicore_launch_core1(dispatcher);
+
+    std::vector<double> rtt;
+    rtt.reserve(overhead_jobs);
+    for (uint32_t i = 0; i < overhead_jobs; i++) {
+        auto t0 = clk::now();
+        multicore_fifo_push_blocking(reinterpret_cast<uintptr_t>(&nothing));
+        multicore_fifo_push_blocking(i);
+        multicore_fifo_pop_blocking();
+        rtt.push_back(std::chrono::duration<double, std::micro>(clk::now() - t0).count());
+    }
+    std::sort(rtt.begin(), rtt.end());
+    double sum = 0;
+    for (double t : rtt) {
+        sum += t;
+    }
+    std::printf("one at a time: %u jobs, round trip mean %.2f us, p50 %.2f us, p99 %.2f us, max %.1f us\n",
+                overhead_jobs, sum / rtt.size(), rtt[rtt.size() / 2], rtt[rtt.size() * 99 / 100], rtt.back());
+
+    for (uint32_t depth : {2u, 4u, 8u}) {
+        auto t0 = clk::now();
+        for (uint32_t i = 0; i < overhead_jobs; i += depth) {
+            for (uint32_t j = 0; j < depth; j++) {
+                multicore_fifo_push_blocking(reinterpret_cast<uintptr_t>(&nothing));
+                multicore_fifo_push_blocking(j);
+            }
+            for (uint32_t j = 0; j < depth; j++) {
+                multicore_fifo_pop_blocking();
+            }
+        }
+        double us = std::chrono::duration<double, std::micro>(clk::now() - t0).count();
+        std::printf("%u in flight:   %.2f us per job\n", depth, us / overhead_jobs);
+    }
+    std::fflush(stdout);
+    pico_host_print_stats();
+    return 0;
+}
+
+
+bool same_file(const std::string& a, const std::string& b) {
+    std::ifstream fa(a, std::ios::binary), fb(b, std::ios::binary);
+    std::string ca{std::istreambuf_iterator<char>(fa), std::istreambuf_iterator<char>()};
+    std::string cb{std::istreambuf_iterator<char>(fb), std::istreambuf_iterator<char>()};
+    return fa && fb && !ca.empty() && ca == cb;
+}
+
+
+/**
+ * @brief check the emulation itself: outcomes, reproducibility and the deadlock report
+ */
+int selftest() {
+    selftest_checks check;
+
+    std::vector<const scenario*> all;
+    for (const scenario& s : scenarios) {
+        all.push_back(&s);
+    }
+    check(stress(all, 20, 1), "scenario outcomes");
+
+    // a seed gives the same interleaving every time, and the seeds differ
+    char dir[] = "/tmp/multicore_stress.XXXXXX";
+    check(mkdtemp(dir) != nullptr, "temporary directory");
+    std::string a = std::string(dir) + "/a.csv", b = std::string(dir) + "/b.csv", c = std::string(dir) + "/c.csv";
+    run_child(PICO_HOST_DETERMINISTIC, 7, a.c_str(), scenario_stream);
+    run_child(PICO_HOST_DETERMINISTIC, 7, b.c_str(), scenario_stream);
+    run_child(PICO_HOST_DETERMINISTIC, 8, c.c_str(), scenario_stream);
+    check(same_file(a, b), "same seed, same trace");
+    check(!same_file(a, c), "different seeds, different traces");
+
+    // the deadlock is found at the same point every time and ends the trace
+    run_child(PICO_HOST_DETERMINISTIC, 3, a.c_str(), scenario_overrun, true);
+    std::ifstream in(a);
+    std::string line, last;
+    while (std::getline(in, line)) {
+        last = line;
+    }
+    check(last.find(",deadlock,") != std::string::npos, "deadlock in the trace");
+
+    // the FIFO holds exactly 8 words: a 9th push blocks until core 1 pops
+    run_result r = run_child(PICO_HOST_DETERMINISTIC, 1, nullptr, [] {
+        multicore_launch_core1([] {
+            sleep_ms(1);
+            for (int i = 0; i < 9; i++) {
+                multicore_fifo_pop_blocking();
+            }
+        });
+        for (int i = 0; i < 8; i++) {
+            if (!multicore_fifo_push_timeout_us(i, 0)) {
+                return 1;
+            }
+        }
+        if (multicore_fifo_push_timeout_us(8, 0) || multicore_fifo_wready()) {
+            return 1;
+        }
+        multicore_fifo_push_blocking(8);
+        return time_us_64() >= 1000 ? 0 : 1;
+    });
+    check(r.result == outcome::pass && r.report.fifo[0].max_level == 8 && r.report.fifo[0].push_blocks == 1,
+          "8 word FIFO");
+
+    for (const std::string& f : {a, b, c}) {
+        std::remove(f.c_str());
+    }
+    rmdir(dir);
+
+    return check.finish();
+}
+
+
+void usage() {
+    std::fprintf(stderr, "usage: multicore_stress [--seeds N] [--free N] [scenario...]\n"
+                         "       multicore_stress --seed S [--trace file] <scenario>\n"
+                         "       multicore_stress --overhead [jobs]\n"
+                         "       multicore_stress --selftest\n"
+                         "scenarios:");
+    for (const scenario& s : scenarios) {
+        std::fprintf(stderr, " %s", s.name);
+    }
+    std::fprintf(stderr, "\n");
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    uint32_t seeds = 100;
+    uint32_t free_runs = 3;
+    long seed = -1;
+    const char* trace = nullptr;
+    std::vector<const scenario*> which;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--selftest") {
+            return selftest();
+        } else if (arg == "--overhead") {
+            if (has_value) {
+                overhead_jobs = uint32_t(std::max(8ul, std::strtoul(argv[++i], nullptr, 0)));
+            }
+            return run_child(PICO_HOST_FREE, 0, nullptr, overhead).result == outcome::pass ? 0 : 1;
+        } else if (arg == "--seeds" && has_value) {
+            seeds = uint32_t(std::strtoul(argv[++i], nullptr, 0));
+        } else if (arg == "--free" && has_value) {
+            free_runs = uint32_t(std::strtoul(argv[++i], nullptr, 0));
+        } else if (arg == "--seed" && has_value) {
+            seed = long(std::strtoul(argv[++i], nullptr, 0));
+        } else if (arg == "--trace" && has_value) {
+            trace = argv[++i];
+        } else if (const scenario* s = find_scenario(arg.c_str())) {
+            which.push_back(s);
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    if (seed >= 0) {
+        if (which.size() != 1) {
+            usage();
+            return 2;
+        }
+        run_result r = run_child(PICO_HOST_DETERMINISTIC, uint32_t(seed), trace, which[0]->run);
+        static const char* const names[] = {"pass", "fail", "deadlock", "hang"};
+        std::printf("%s seed %ld: %s", which[0]->name, seed, names[int(r.result)]);
+        if (r.reported) {
+            std::printf(", %llu hand-overs", (unsigned long long)r.report.switches);
+        }
+        std::printf("\n");
+        return r.result == (which[0]->deadlocks ? outcome::deadlock : outcome::pass) ? 0 : 1;
+    }
+
+    if (which.empty()) {
+        for (const scenario& s : scenarios) {
+            which.push_back(&s);
+        }
+    }
+    return stress(which, seeds, free_runs) ? 0 : 1;
+}
@@ -0,0 +1,42 @@
+/*****************************************************************//**
+ * \file   multicore.h
+ * \brief  host shim of the SDK's core 1 launch and inter-core FIFO
+ *
+ * FIFO words are uintptr_t rather than uint32_t so function pointers
+ * survive the trip on a 64 bit host, see pico_host.h. The timeout
+ * pop keeps the SDK's uint32_t out parameter.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#ifndef PICO_MULTICORE_H
+#define PICO_MULTICORE_H
+
+#include "pico/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void multicore_launch_core1(void (*entry)(void));
+void multicore_reset_core1(void);
+
+bool multicore_fifo_rvalid(void);
+bool multicore_fifo_wready(void);
+
+void multicore_fifo_push_blocking(uintptr_t data);
+bool multicore_fifo_push_timeout_us(uintptr_t data, uint64_t timeout_us);
+uintptr_t multicore_fifo_pop_blocking(void);
+bool multicore_fifo_pop_timeout_us(uint64_t timeout_us, uint32_t *out);
+void multicore_fifo_drain(void);
+
+// there are no FIFO interrupts on the host
+static inline void multicore_fifo_clear_irq(void) {
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICO_MULTICORE_H
@@ -0,0 +1,38 @@
+/*****************************************************************//**
+ * \file   stdlib.h
+ * \brief  host shim of the SDK's pico/stdlib.h
+ *
+ * Only the parts the dual-core examples use: the types, the time
+ * functions and the core number. stdio goes straight to the host's.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#ifndef PICO_STDLIB_H
+#define PICO_STDLIB_H
+
+#include "pico/types.h"
+#include "pico/time.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline bool stdio_init_all(void) {
+    return true;
+}
+
+static inline void tight_loop_contents(void) {
+}
+
+/**
+ * @brief 0 on the thread running main(), 1 on the one started by multicore_launch_core1()
+ */
+uint get_core_num(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICO_STDLIB_H
@@ -0,0 +1,86 @@
+/*****************************************************************//**
+ * \file   time.h
+ * \brief  host shim of the SDK's timestamp and sleep functions
+ *
+ * Backed by the host's monotonic clock under the free schedule and by
+ * virtual time under the deterministic one, see pico_host.h.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#ifndef PICO_TIME_H
+#define PICO_TIME_H
+
+#include "pico/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint64_t time_us_64(void);
+
+static inline uint32_t time_us_32(void) {
+    return (uint32_t)time_us_64();
+}
+
+static inline absolute_time_t get_absolute_time(void) {
+    return time_us_64();
+}
+
+static inline uint64_t to_us_since_boot(absolute_time_t t) {
+    return t;
+}
+
+static inline uint32_t to_ms_since_boot(absolute_time_t t) {
+    return (uint32_t)(t / 1000);
+}
+
+static inline absolute_time_t delayed_by_us(absolute_time_t t, uint64_t us) {
+    return t + us;
+}
+
+static inline absolute_time_t delayed_by_ms(absolute_time_t t, uint32_t ms) {
+    return t + (uint64_t)ms * 1000;
+}
+
+static inline absolute_time_t make_timeout_time_us(uint64_t us) {
+    return delayed_by_us(get_absolute_time(), us);
+}
+
+static inline absolute_time_t make_timeout_time_ms(uint32_t ms) {
+    return delayed_by_ms(get_absolute_time(), ms);
+}
+
+static inline int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to) {
+    return (int64_t)(to - from);
+}
+
+static inline bool time_reached(absolute_time_t t) {
+    return time_us_64() >= t;
+}
+
+void sleep_until(absolute_time_t t);
+
+static inline void sleep_us(uint64_t us) {
+    sleep_until(make_timeout_time_us(us));
+}
+
+static inline void sleep_ms(uint32_t ms) {
+    sleep_us((uint64_t)ms * 1000);
+}
+
+// there is nothing to gain from spinning on the host
+static inline void busy_wait_us(uint64_t us) {
+    sleep_us(us);
+}
+
+static inline void busy_wait_ms(uint32_t ms) {
+    sleep_ms(ms);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICO_TIME_H
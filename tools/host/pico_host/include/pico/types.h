@@ -0,0 +1,23 @@
+/*****************************************************************//**
+ * \file   types.h
+ * \brief  host shim of the SDK's pico/types.h
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#ifndef PICO_TYPES_H
+#define PICO_TYPES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef unsigned int uint;
+
+// microseconds since boot, as the SDK's release builds define it
+typedef uint64_t absolute_time_t;
+
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+
+#endif // PICO_TYPES_H
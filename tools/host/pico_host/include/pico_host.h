@@ -0,0 +1,126 @@
+/*****************************************************************//**
+ * \file   pico_host.h
+ * \brief  host emulation of the two cores, their FIFOs and the timer
+ *
+ * Lets the dual-core examples run on Linux against shim versions of
+ * pico/stdlib.h, pico/multicore.h and pico/time.h. Core 0 is the
+ * thread that calls main(), multicore_launch_core1() starts core 1 on
+ * a thread of its own, and each direction of the inter-core FIFO
+ * holds 8 words and blocks a pusher while full and a popper while
+ * empty, as the SIO FIFOs do.
+ *
+ * Two schedules are available:
+ *
+ *   free            both cores run at once on native threads, with
+ *                   time read from the host's monotonic clock
+ *   deterministic   only one core runs at a time. Every FIFO call,
+ *                   sleep and poll of the FIFO status hands over to a
+ *                   core picked from the runnable ones by a seeded
+ *                   PRNG, and time is virtual: it only moves on
+ *                   sleeps, timeouts and by 1 us per read of the
+ *                   timer. A seed always gives the same interleaving,
+ *                   and both cores blocked with nothing left to wake
+ *                   them is reported as a deadlock (exit status 3).
+ *
+ * Unless pico_host_configure() is called first, the schedule comes
+ * from the environment:
+ *
+ *   PICO_HOST_SCHED=free | det[:seed]
+ *   PICO_HOST_TRACE=<file> or - for stderr, one CSV line per FIFO event
+ *   PICO_HOST_STATS=1 prints the FIFO statistics to stderr at exit
+ *
+ * The host FIFO words are pointer sized, so the function pointers the
+ * examples pass through them survive on a 64 bit host. On the RP2040
+ * both are 32 bits wide.
+ *
+ * multicore_reset_core1() stops core 1 at its next call into the
+ * emulation rather than at once; a core 1 stuck in a loop that never
+ * calls it can't be stopped.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#ifndef PICO_HOST_H
+#define PICO_HOST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// depth of each direction of the FIFO, as on the RP2040
+#define PICO_HOST_FIFO_DEPTH 8
+
+// exit status when the deterministic schedule finds both cores blocked
+#define PICO_HOST_DEADLOCK_STATUS 3
+
+
+typedef enum {
+    PICO_HOST_FREE,
+    PICO_HOST_DETERMINISTIC,
+} pico_host_sched_t;
+
+
+/**
+ * @brief counters for one direction of the FIFO
+ *
+ * blocked times and latencies are in virtual microseconds under the
+ * deterministic schedule, so only the counts are comparable with a
+ * free run
+ */
+typedef struct {
+    uint32_t words;             // words pushed
+    uint32_t max_level;         // most words waiting at once
+    uint32_t push_blocks;       // pushes that found the FIFO full
+    uint32_t pop_blocks;        // pops that found it empty
+    uint64_t push_blocked_us;   // time pushers spent waiting for room
+    uint64_t pop_blocked_us;    // time poppers spent waiting for a word
+    uint64_t latency_sum_us;    // push to pop, summed over the words popped
+    uint64_t latency_max_us;
+    uint32_t popped;
+} pico_host_fifo_stats_t;
+
+
+/**
+ * @brief choose the schedule, before anything else touches the emulation
+ *
+ * @param sched free or deterministic
+ * @param seed PRNG seed of the deterministic schedule
+ * @param trace_path file for the FIFO event trace, "-" for stderr, NULL for none
+ */
+void pico_host_configure(pico_host_sched_t sched, uint32_t seed, const char *trace_path);
+
+
+/**
+ * @brief copy the counters of the FIFO written by a core
+ *
+ * @param from_core 0 for the FIFO core 0 pushes into, 1 for the other
+ */
+void pico_host_fifo_stats(unsigned from_core, pico_host_fifo_stats_t *stats);
+
+
+/**
+ * @brief the schedule in use, from pico_host_configure() or PICO_HOST_SCHED
+ */
+pico_host_sched_t pico_host_schedule(void);
+
+
+/**
+ * @brief hand-overs between the cores so far, deterministic schedule only
+ */
+uint64_t pico_host_switches(void);
+
+
+/**
+ * @brief print the schedule and the counters of both FIFOs to stderr
+ */
+void pico_host_print_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICO_HOST_H
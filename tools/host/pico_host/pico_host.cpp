@@ -0,0 +1,633 @@
+/*****************************************************************//**
+ * \file   pico_host.cpp
+ * \brief  host emulation of the two cores, their FIFOs and the timer
+ *
+ * All state sits behind one mutex. Under the free schedule a blocked
+ * core waits on the condition variable for the other to change the
+ * FIFO. Under the deterministic one the mutex is only half the story:
+ * `running` names the one core allowed to execute, and at every
+ * scheduling point the caller records what it waits for, picks the
+ * next core from those able to go on and sleeps until it is picked
+ * again. Nothing able to go on advances virtual time to the earliest
+ * deadline, and no deadline either is a deadlock.
+ *
+ * Core 1 is a raw pthread so a reset can end it with pthread_exit()
+ * from inside the emulation; each launch gets a new generation and a
+ * thread of an older one leaves at its next call.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include "pico_host.h"
+#include "pico/multicore.h"
+#include "pico/stdlib.h"
+
+#include <pthread.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+constexpr uint64_t NEVER = UINT64_MAX;
+
+enum class core_state { off, running, push_wait, pop_wait, sleeping, done };
+
+const char* state_name(core_state s) {
+    switch (s) {
+    case core_state::off: return "off";
+    case core_state::running: return "running";
+    case core_state::push_wait: return "waiting to push into a full FIFO";
+    case core_state::pop_wait: return "waiting to pop an empty FIFO";
+    case core_state::sleeping: return "sleeping";
+    case core_state::done: return "returned from its entry function";
+    }
+    return "?";
+}
+
+
+/**
+ * @brief one direction of the inter-core FIFO
+ */
+struct fifo {
+    uintptr_t words[PICO_HOST_FIFO_DEPTH];
+    uint64_t pushed_at[PICO_HOST_FIFO_DEPTH];
+    unsigned head = 0;
+    unsigned count = 0;
+    pico_host_fifo_stats_t stats = {};
+
+    bool full() const { return count == PICO_HOST_FIFO_DEPTH; }
+
+    void push(uintptr_t w, uint64_t now) {
+        unsigned i = (head + count) % PICO_HOST_FIFO_DEPTH;
+        words[i] = w;
+        pushed_at[i] = now;
+        count++;
+        stats.words++;
+        if (count > stats.max_level) {
+            stats.max_level = count;
+        }
+    }
+
+    uintptr_t pop(uint64_t now) {
+        uintptr_t w = words[head];
+        uint64_t latency = now - pushed_at[head];
+        head = (head + 1) % PICO_HOST_FIFO_DEPTH;
+        count--;
+        stats.popped++;
+        stats.latency_sum_us += latency;
+        if (latency > stats.latency_max_us) {
+            stats.latency_max_us = latency;
+        }
+        return w;
+    }
+
+    void clear() {
+        head = 0;
+        count = 0;
+    }
+};
+
+
+struct config {
+    bool set = false;
+    pico_host_sched_t sched = PICO_HOST_FREE;
+    uint32_t seed = 1;
+    std::string trace;
+};
+
+
+struct runtime {
+    explicit runtime(const config& c);
+
+    std::mutex m;
+    std::condition_variable cv;
+    pico_host_sched_t sched;
+    uint32_t seed;
+    uint32_t rng;
+    FILE* trace = nullptr;
+    bool stats_at_exit = false;
+    clock_type::time_point start = clock_type::now();
+
+    // deterministic schedule
+    unsigned running = 0;
+    uint64_t vt = 0;
+    uint64_t switches = 0;
+
+    core_state state[2] = {core_state::running, core_state::off};
+    uint64_t deadline[2] = {NEVER, NEVER};
+    unsigned core1_gen = 0;
+
+    fifo fifos[2];  // indexed by the core that pushes into it
+};
+
+std::atomic<bool> created;
+thread_local unsigned this_core = 0;
+thread_local unsigned my_gen = 0;
+
+
+config& requested() {
+    static config c;
+    return c;
+}
+
+
+void at_exit();
+
+
+runtime::runtime(const config& c) : sched(c.sched), seed(c.seed) {
+    std::string trace_path = c.trace;
+    if (!c.set) {
+        const char* s = std::getenv("PICO_HOST_SCHED");
+        if (s && std::strncmp(s, "det", 3) == 0) {
+            sched = PICO_HOST_DETERMINISTIC;
+            if (s[3] == ':') {
+                seed = uint32_t(std::strtoul(s + 4, nullptr, 0));
+            }
+        } else if (s && std::strcmp(s, "free") != 0) {
+            std::fprintf(stderr, "pico_host: unknown PICO_HOST_SCHED=%s, using free\n", s);
+        }
+        const char* t = std::getenv("PICO_HOST_TRACE");
+        trace_path = t ? t : "";
+        const char* st = std::getenv("PICO_HOST_STATS");
+        stats_at_exit = st && *st && std::strcmp(st, "0") != 0;
+    }
+    rng = seed ^ 0x9e3779b9u;
+    if (!rng) {
+        rng = 1;
+    }
+
+    if (trace_path == "-") {
+        trace = stderr;
+    } else if (!trace_path.empty()) {
+        trace = std::fopen(trace_path.c_str(), "w");
+        if (!trace) {
+            std::fprintf(stderr, "pico_host: can't open %s: %s\n", trace_path.c_str(), std::strerror(errno));
+        }
+    }
+    if (trace) {
+        std::fprintf(trace, "time_us,core,event,value,level\n");
+    }
+    std::atexit(at_exit);
+}
+
+
+// never destroyed, core 1 may still be using it while the process exits
+runtime& rt() {
+    static runtime* r = [] {
+        created = true;
+        return new runtime(requested());
+    }();
+    return *r;
+}
+
+
+uint64_t now(runtime& r) {
+    if (r.sched == PICO_HOST_DETERMINISTIC) {
+        return r.vt;
+    }
+    return uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(clock_type::now() - r.start).count());
+}
+
+
+void record(runtime& r, const char* event, uintptr_t value, unsigned level) {
+    if (r.trace) {
+        std::fprintf(r.trace, "%llu,%u,%s,%llu,%u\n", (unsigned long long)now(r), this_core, event,
+                     (unsigned long long)value, level);
+    }
+}
+
+
+uint32_t next_random(runtime& r) {
+    // xorshift32
+    r.rng ^= r.rng << 13;
+    r.rng ^= r.rng >> 17;
+    r.rng ^= r.rng << 5;
+    return r.rng;
+}
+
+
+bool can_run(runtime& r, unsigned c) {
+    switch (r.state[c]) {
+    case core_state::running:
+        return true;
+    case core_state::push_wait:
+        return !r.fifos[c].full() || r.vt >= r.deadline[c];
+    case core_state::pop_wait:
+        return r.fifos[c ^ 1].count || r.vt >= r.deadline[c];
+    case core_state::sleeping:
+        return r.vt >= r.deadline[c];
+    case core_state::off:
+    case core_state::done:
+        return false;
+    }
+    return false;
+}
+
+
+// true once the calling thread belongs to a core 1 that has been reset
+bool stale(runtime& r) {
+    return this_core == 1 && my_gen != r.core1_gen;
+}
+
+
+void leave_if_stale(runtime& r, std::unique_lock<std::mutex>& lk) {
+    if (stale(r)) {
+        lk.unlock();
+        pthread_exit(nullptr);
+    }
+}
+
+
+[[noreturn]] void deadlock(runtime& r) {
+    std::fprintf(stderr, "pico_host: deadlock at %llu us (seed %u)\n", (unsigned long long)r.vt, r.seed);
+    for (unsigned c = 0; c < 2; c++) {
+        std::fprintf(stderr, "pico_host:   core%u %s, FIFO to core%u holds %u\n", c, state_name(r.state[c]),
+                     c ^ 1, r.fifos[c].count);
+    }
+    record(r, "deadlock", 0, 0);
+    if (r.trace) {
+        std::fflush(r.trace);
+    }
+    std::fflush(stdout);
+    std::_Exit(PICO_HOST_DEADLOCK_STATUS);
+}
+
+
+/**
+ * @brief deterministic scheduling point: pick the next core and wait until it's us again
+ *
+ * the caller's state says what it waits for; a core that has finished
+ * passes leaving and returns at once
+ */
+void hand_over(runtime& r, std::unique_lock<std::mutex>& lk, bool leaving = false) {
+    unsigned pick;
+    for (;;) {
+        unsigned ready[2];
+        unsigned n = 0;
+        for (unsigned c = 0; c < 2; c++) {
+            if (can_run(r, c)) {
+                ready[n++] = c;
+            }
+        }
+        if (n) {
+            pick = n == 1 ? ready[0] : ready[next_random(r) % n];
+            break;
+        }
+        uint64_t next = NEVER;
+        for (unsigned c = 0; c < 2; c++) {
+            if (r.state[c] != core_state::off && r.state[c] != core_state::done && r.deadline[c] < next) {
+                next = r.deadline[c];
+            }
+        }
+        if (next == NEVER) {
+            deadlock(r);
+        }
+        r.vt = next;
+    }
+
+    if (pick != r.running) {
+        r.switches++;
+        r.running = pick;
+    }
+    if (pick == this_core && !leaving) {
+        return;
+    }
+    r.cv.notify_all();
+    if (!leaving) {
+        r.cv.wait(lk, [&] { return r.running == this_core || stale(r); });
+        leave_if_stale(r, lk);
+    }
+}
+
+
+/**
+ * @brief wait in a state until ready() or the deadline passes
+ *
+ * @return time spent blocked, NEVER if it didn't block
+ */
+template <typename Ready>
+uint64_t wait(runtime& r, std::unique_lock<std::mutex>& lk, core_state s, uint64_t deadline, Ready ready) {
+    unsigned self = this_core;
+    uint64_t t0 = now(r);
+    bool blocked = !ready() && now(r) < deadline;
+
+    if (r.sched == PICO_HOST_DETERMINISTIC) {
+        r.state[self] = s;
+        r.deadline[self] = deadline;
+        hand_over(r, lk);
+        r.state[self] = core_state::running;
+        r.deadline[self] = NEVER;
+    } else if (blocked) {
+        auto done = [&] { return ready() || stale(r); };
+        if (deadline == NEVER) {
+            r.cv.wait(lk, done);
+        } else {
+            r.cv.wait_until(lk, r.start + std::chrono::microseconds(deadline), done);
+        }
+        leave_if_stale(r, lk);
+    }
+    return blocked ? now(r) - t0 : NEVER;
+}
+
+
+uint64_t deadline_after(runtime& r, uint64_t timeout_us) {
+    uint64_t t = now(r);
+    return timeout_us >= NEVER - t ? NEVER : t + timeout_us;
+}
+
+
+bool push(uintptr_t data, uint64_t timeout_us) {
+    runtime& r = rt();
+    std::unique_lock<std::mutex> lk(r.m);
+    leave_if_stale(r, lk);
+    fifo& f = r.fifos[this_core];
+
+    uint64_t blocked = wait(r, lk, core_state::push_wait, deadline_after(r, timeout_us), [&] { return !f.full(); });
+    if (blocked != NEVER) {
+        f.stats.push_blocks++;
+        f.stats.push_blocked_us += blocked;
+        record(r, "push_blocked", blocked, f.count);
+    }
+    if (f.full()) {
+        record(r, "push_timeout", data, f.count);
+        return false;
+    }
+    f.push(data, now(r));
+    record(r, "push", data, f.count);
+    r.cv.notify_all();
+    return true;
+}
+
+
+bool pop(uintptr_t* data, uint64_t timeout_us) {
+    runtime& r = rt();
+    std::unique_lock<std::mutex> lk(r.m);
+    leave_if_stale(r, lk);
+    fifo& f = r.fifos[this_core ^ 1];
+
+    uint64_t blocked = wait(r, lk, core_state::pop_wait, deadline_after(r, timeout_us), [&] { return f.count != 0; });
+    if (blocked != NEVER) {
+        f.stats.pop_blocks++;
+        f.stats.pop_blocked_us += blocked;
+        record(r, "pop_blocked", blocked, f.count);
+    }
+    if (!f.count) {
+        record(r, "pop_timeout", 0, 0);
+        return false;
+    }
+    *data = f.pop(now(r));
+    record(r, "pop", *data, f.count);
+    r.cv.notify_all();
+    return true;
+}
+
+
+/**
+ * @brief a scheduling point for polls that don't block
+ */
+void yield(runtime& r, std::unique_lock<std::mutex>& lk) {
+    leave_if_stale(r, lk);
+    if (r.sched == PICO_HOST_DETERMINISTIC) {
+        hand_over(r, lk);
+    }
+}
+
+
+struct core1_start {
+    void (*entry)(void);
+    unsigned gen;
+};
+
+
+void* core1_thread(void* arg) {
+    core1_start start = *static_cast<core1_start*>(arg);
+    delete static_cast<core1_start*>(arg);
+    this_core = 1;
+    my_gen = start.gen;
+
+    runtime& r = rt();
+    {
+        std::unique_lock<std::mutex> lk(r.m);
+        if (r.sched == PICO_HOST_DETERMINISTIC) {
+            r.cv.wait(lk, [&] { return r.running == 1 || stale(r); });
+        }
+        leave_if_stale(r, lk);
+    }
+
+    start.entry();
+
+    std::unique_lock<std::mutex> lk(r.m);
+    leave_if_stale(r, lk);
+    r.state[1] = core_state::done;
+    record(r, "exit", 0, 0);
+    if (r.sched == PICO_HOST_DETERMINISTIC) {
+        hand_over(r, lk, true);
+    }
+    return nullptr;
+}
+
+
+void at_exit() {
+    runtime& r = rt();
+    if (r.stats_at_exit) {
+        pico_host_print_stats();
+    }
+    if (r.trace) {
+        std::fflush(r.trace);
+    }
+}
+
+} // namespace
+
+
+extern "C" {
+
+void pico_host_configure(pico_host_sched_t sched, uint32_t seed, const char* trace_path) {
+    if (created) {
+        std::fprintf(stderr, "pico_host: pico_host_configure() called after the emulation started\n");
+        std::abort();
+    }
+    config& c = requested();
+    c.set = true;
+    c.sched = sched;
+    c.seed = seed;
+    c.trace = trace_path ? trace_path : "";
+}
+
+
+void pico_host_fifo_stats(unsigned from_core, pico_host_fifo_stats_t* stats) {
+    runtime& r = rt();
+    std::lock_guard<std::mutex> lk(r.m);
+    *stats = r.fifos[from_core & 1].stats;
+}
+
+
+pico_host_sched_t pico_host_schedule(void) {
+    return rt().sched;
+}
+
+
+uint64_t pico_host_switches(void) {
+    runtime& r = rt();
+    std::lock_guard<std::mutex> lk(r.m);
+    return r.switches;
+}
+
+
+void pico_host_print_stats(void) {
+    runtime& r = rt();
+    std::lock_guard<std::mutex> lk(r.m);
+    if (r.sched == PICO_HOST_DETERMINISTIC) {
+        std::fprintf(stderr, "pico_host: deterministic schedule, seed %u: %llu hand-overs in %llu us of virtual time\n",
+                     r.seed, (unsigned long long)r.switches, (unsigned long long)r.vt);
+    } else {
+        std::fprintf(stderr, "pico_host: free schedule, %llu us\n", (unsigned long long)now(r));
+    }
+    for (unsigned c = 0; c < 2; c++) {
+        const pico_host_fifo_stats_t& s = r.fifos[c].stats;
+        std::fprintf(stderr,
+                     "pico_host: core%u->core%u: %u words, at most %u/%u waiting, "
+                     "%u pushes blocked for %llu us, %u pops blocked for %llu us, latency mean %.1f max %llu us\n",
+                     c, c ^ 1, s.words, s.max_level, PICO_HOST_FIFO_DEPTH, s.push_blocks,
+                     (unsigned long long)s.push_blocked_us, s.pop_blocks, (unsigned long long)s.pop_blocked_us,
+                     s.popped ? double(s.latency_sum_us) / s.popped : 0.0, (unsigned long long)s.latency_max_us);
+    }
+}
+
+
+uint get_core_num(void) {
+    return this_core;
+}
+
+
+uint64_t time_us_64(void) {
+    runtime& r = rt();
+    if (r.sched != PICO_HOST_DETERMINISTIC) {
+        return now(r);
+    }
+    // polling loops have to see time move
+    std::lock_guard<std::mutex> lk(r.m);
+    return ++r.vt;
+}
+
+
+void sleep_until(absolute_time_t t) {
+    runtime& r = rt();
+    if (r.sched != PICO_HOST_DETERMINISTIC) {
+        std::this_thread::sleep_until(r.start + std::chrono::microseconds(t));
+        std::unique_lock<std::mutex> lk(r.m);
+        leave_if_stale(r, lk);
+        return;
+    }
+    std::unique_lock<std::mutex> lk(r.m);
+    leave_if_stale(r, lk);
+    wait(r, lk, core_state::sleeping, t, [] { return false; });
+}
+
+
+void multicore_launch_core1(void (*entry)(void)) {
+    runtime& r = rt();
+    std::unique_lock<std::mutex> lk(r.m);
+    if (this_core != 0 || (r.state[1] != core_state::off && r.state[1] != core_state::done)) {
+        std::fprintf(stderr, "pico_host: multicore_launch_core1() needs core 0 and core 1 reset\n");
+        std::abort();
+    }
+    // the SDK's launch handshake leaves both FIFOs empty
+    r.fifos[0].clear();
+    r.fifos[1].clear();
+    r.core1_gen++;
+    r.state[1] = core_state::running;
+    r.deadline[1] = NEVER;
+    record(r, "launch", r.core1_gen, 0);
+
+    pthread_t t;
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    if (pthread_create(&t, &attr, core1_thread, new core1_start{entry, r.core1_gen}) != 0) {
+        std::fprintf(stderr, "pico_host: can't start core 1\n");
+        std::abort();
+    }
+    pthread_attr_destroy(&attr);
+    yield(r, lk);
+}
+
+
+void multicore_reset_core1(void) {
+    runtime& r = rt();
+    std::unique_lock<std::mutex> lk(r.m);
+    r.core1_gen++;
+    r.state[1] = core_state::off;
+    r.deadline[1] = NEVER;
+    record(r, "reset", r.core1_gen, 0);
+    r.cv.notify_all();
+}
+
+
+bool multicore_fifo_rvalid(void) {
+    runtime& r = rt();
+    std::unique_lock<std::mutex> lk(r.m);
+    yield(r, lk);
+    return r.fifos[this_core ^ 1].count != 0;
+}
+
+
+bool multicore_fifo_wready(void) {
+    runtime& r = rt();
+    std::unique_lock<std::mutex> lk(r.m);
+    yield(r, lk);
+    return !r.fifos[this_core].full();
+}
+
+
+void multicore_fifo_push_blocking(uintptr_t data) {
+    push(data, NEVER);
+}
+
+
+bool multicore_fifo_push_timeout_us(uintptr_t data, uint64_t timeout_us) {
+    return push(data, timeout_us);
+}
+
+
+uintptr_t multicore_fifo_pop_blocking(void) {
+    uintptr_t data = 0;
+    pop(&data, NEVER);
+    return data;
+}
+
+
+bool multicore_fifo_pop_timeout_us(uint64_t timeout_us, uint32_t* out) {
+    uintptr_t data;
+    if (!pop(&data, timeout_us)) {
+        return false;
+    }
+    *out = uint32_t(data);
+    return true;
+}
+
+
+void multicore_fifo_drain(void) {
+    runtime& r = rt();
+    std::unique_lock<std::mutex> lk(r.m);
+    yield(r, lk);
+    fifo& f = r.fifos[this_core ^ 1];
+    while (f.count) {
+        record(r, "drain", f.pop(now(r)), f.count);
+    }
+    r.cv.notify_all();
+}
+
+} // extern "C"
@@ -0,0 +1,236 @@
+/*****************************************************************//**
+ * \file   profile_report.cpp
+ * \brief  symbolises sampling profiler histograms against a firmware ELF
+ *
+ * Reads the (PC, LR) histograms written by lib/profiler, either as the
+ * text printed by profiler_dump() (other lines in the capture are
+ * ignored) or as a raw dump of profiler_histograms read over SWD, and
+ * maps every address to the function containing it.
+ *
+ *   profile_report [--collapsed] <firmware.elf> <dump | ->
+ *
+ * The default output is a flat profile per core: samples and share of
+ * the total for each function the PC landed in. --collapsed prints
+ * "core;caller;function count" lines instead, the input format of
+ * flamegraph.pl and speedscope. The caller comes from the sampled LR,
+ * so it is only right when the function has not yet pushed LR and
+ * called something else; "[exception]" marks samples whose LR was an
+ * EXC_RETURN value, i.e. code running at the top of a handler.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "elf_file.hpp"
+
+namespace {
+
+// must match lib/profiler/include/profiler.h
+constexpr uint32_t PROFILER_MAGIC = 0x464f5250;
+constexpr size_t HEADER_WORDS = 6;
+constexpr size_t SLOT_WORDS = 3;
+
+// values of LR above this are EXC_RETURN codes rather than addresses
+constexpr uint32_t EXC_RETURN_BASE = 0xfffffff0;
+
+
+struct sample {
+    uint32_t pc;
+    uint32_t lr;
+    uint32_t count;
+};
+
+
+struct core_profile {
+    unsigned core = 0;
+    uint32_t rate_hz = 0;
+    uint32_t samples = 0;
+    uint32_t lost = 0;
+    std::vector<sample> slots;
+};
+
+
+uint32_t get_u32(const std::vector<uint8_t>& data, size_t offset) {
+    return uint32_t(data[offset]) | uint32_t(data[offset + 1]) << 8 |
+           uint32_t(data[offset + 2]) << 16 | uint32_t(data[offset + 3]) << 24;
+}
+
+
+/**
+ * @brief parse a raw memory dump of profiler_histograms[]
+ */
+bool parse_raw(const std::vector<uint8_t>& data, std::vector<core_profile>& profiles) {
+    size_t offset = 0;
+    while (offset + HEADER_WORDS * 4 <= data.size() && get_u32(data, offset) == PROFILER_MAGIC) {
+        uint32_t slot_count = get_u32(data, offset + 4);
+        size_t end = offset + (HEADER_WORDS + size_t(slot_count) * SLOT_WORDS) * 4;
+        if (end > data.size()) {
+            return false;
+        }
+
+        core_profile p;
+        p.core = get_u32(data, offset + 8);
+        p.rate_hz = get_u32(data, offset + 12);
+        p.samples = get_u32(data, offset + 16);
+        p.lost = get_u32(data, offset + 20);
+        for (size_t at = offset + HEADER_WORDS * 4; at < end; at += SLOT_WORDS * 4) {
+            sample s{get_u32(data, at), get_u32(data, at + 4), get_u32(data, at + 8)};
+            if (s.count) {
+                p.slots.push_back(s);
+            }
+        }
+        profiles.push_back(std::move(p));
+        offset = end;
+    }
+    return !profiles.empty();
+}
+
+
+/**
+ * @brief parse the text printed by profiler_dump(), skipping anything else in the capture
+ */
+bool parse_text(const std::string& text, std::vector<core_profile>& profiles) {
+    std::istringstream in(text);
+    std::string line;
+    while (std::getline(in, line)) {
+        unsigned core;
+        uint32_t rate, samples, lost, pc, lr, count;
+        if (std::sscanf(line.c_str(), "# profile core %u rate %" SCNu32 " samples %" SCNu32 " lost %" SCNu32,
+                        &core, &rate, &samples, &lost) == 4) {
+            core_profile p;
+            p.core = core;
+            p.rate_hz = rate;
+            p.samples = samples;
+            p.lost = lost;
+            profiles.push_back(std::move(p));
+        } else if (!profiles.empty() &&
+                   std::sscanf(line.c_str(), "%u %" SCNx32 " %" SCNx32 " %" SCNu32, &core, &pc, &lr, &count) == 4 &&
+                   core == profiles.back().core) {
+            profiles.back().slots.push_back({pc, lr, count});
+        }
+    }
+    return !profiles.empty();
+}
+
+
+std::string caller_name(const elf_file& elf, uint32_t lr) {
+    if (lr >= EXC_RETURN_BASE) {
+        return "[exception]";
+    }
+    // the return address follows the call, step back into the calling instruction
+    return elf.function_name((lr & ~1u) - 1);
+}
+
+
+void print_flat(const elf_file& elf, const core_profile& p) {
+    std::map<std::string, uint64_t> by_function;
+    uint64_t total = 0;
+    for (const sample& s : p.slots) {
+        by_function[elf.function_name(s.pc)] += s.count;
+        total += s.count;
+    }
+
+    std::vector<std::pair<std::string, uint64_t>> rows(by_function.begin(), by_function.end());
+    std::sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+
+    std::printf("core %u: %" PRIu32 " Hz, %" PRIu32 " samples, %" PRIu32 " lost\n",
+                p.core, p.rate_hz, p.samples, p.lost);
+    std::printf("%10s %7s  %s\n", "samples", "%", "function");
+    for (const auto& row : rows) {
+        std::printf("%10" PRIu64 " %6.2f%%  %s\n", row.second, total ? 100.0 * row.second / total : 0.0,
+                    row.first.c_str());
+    }
+    std::printf("\n");
+}
+
+
+void print_collapsed(const elf_file& elf, const core_profile& p) {
+    std::map<std::string, uint64_t> stacks;
+    for (const sample& s : p.slots) {
+        std::string function = elf.function_name(s.pc);
+        std::string caller = caller_name(elf, s.lr);
+        std::string stack = "core" + std::to_string(p.core) + ";";
+        // an LR inside the sampled function is left over from an earlier call, not a caller
+        if (caller != function) {
+            stack += caller + ";";
+        }
+        stacks[stack + function] += s.count;
+    }
+    for (const auto& entry : stacks) {
+        std::printf("%s %" PRIu64 "\n", entry.first.c_str(), entry.second);
+    }
+}
+
+
+void usage() {
+    std::fprintf(stderr, "usage: profile_report [--collapsed] <firmware.elf> <dump | ->\n");
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    bool collapsed = false;
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--collapsed") == 0) {
+            collapsed = true;
+        } else {
+            args.push_back(argv[i]);
+        }
+    }
+    if (args.size() != 2) {
+        usage();
+        return 2;
+    }
+
+    elf_file elf;
+    std::string error;
+    if (!elf.load(args[0], error)) {
+        std::fprintf(stderr, "profile_report: %s\n", error.c_str());
+        return 1;
+    }
+
+    std::vector<uint8_t> data;
+    if (args[1] == "-") {
+        data.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+    } else {
+        std::ifstream in(args[1], std::ios::binary);
+        if (!in) {
+            std::fprintf(stderr, "profile_report: cannot open %s\n", args[1].c_str());
+            return 1;
+        }
+        data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    std::vector<core_profile> profiles;
+    bool raw = data.size() >= 4 && get_u32(data, 0) == PROFILER_MAGIC;
+    if (!(raw ? parse_raw(data, profiles) : parse_text(std::string(data.begin(), data.end()), profiles))) {
+        std::fprintf(stderr, "profile_report: no profile found in %s\n", args[1].c_str());
+        return 1;
+    }
+
+    for (const core_profile& p : profiles) {
+        if (collapsed) {
+            print_collapsed(elf, p);
+        } else {
+            print_flat(elf, p);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,349 @@
+/*****************************************************************//**
+ * \file   size_report.cpp
+ * \brief  compares the sizes and benchmark results of build variants
+ *
+ * Reads the section headers of each firmware .elf given and sorts the
+ * allocated sections into code, read-only data, initialised data, bss
+ * and the stack and heap reservations, then works out what each image
+ * takes in flash and in SRAM. Sections outside flash with contents are
+ * copied from flash at boot, so copy_to_ram images count them twice;
+ * no_flash images take no flash.
+ *
+ *   size_report [--results <dir>] <firmware.elf>...
+ *   size_report --selftest
+ *
+ * Each target is compared with the target whose name is the longest
+ * prefix of its own followed by '_', e.g. lab07_O3_copy_to_ram with
+ * lab07, which is how apps_variants.cmake names the variants. With
+ * --results, <dir>/<target>.csv is read as telemetry_decode CSV and the
+ * bench records (the best time of each scenario, kernel and core) are
+ * tabulated against the same base.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "elf_file.hpp"
+#include "selftest.hpp"
+
+namespace {
+
+constexpr uint64_t FLASH_BASE = 0x10000000;
+constexpr uint64_t FLASH_END = 0x11000000;
+constexpr uint64_t SRAM_BASE = 0x20000000;
+constexpr uint64_t SRAM_END = 0x20042000;
+
+
+struct image_size {
+    uint64_t text = 0;      // code, wherever it runs
+    uint64_t rodata = 0;
+    uint64_t data = 0;
+    uint64_t bss = 0;
+    uint64_t reserved = 0;  // .stack*, .heap
+    uint64_t flash = 0;
+    uint64_t ram = 0;       // SRAM taken by everything but the reservations
+};
+
+
+struct target {
+    std::string name;
+    image_size size;
+    std::map<std::string, uint32_t> results;    // best elapsed_us by "scenario kernel[ coreN]"
+    int base = -1;
+};
+
+
+bool in_range(uint64_t addr, uint64_t start, uint64_t end) {
+    return addr >= start && addr < end;
+}
+
+
+image_size classify(const std::vector<elf_section>& sections) {
+    image_size s;
+    bool has_flash = false;
+    for (const elf_section& sec : sections) {
+        if ((sec.flags & elf_section::SHF_ALLOC) && sec.size && in_range(sec.addr, FLASH_BASE, FLASH_END)) {
+            has_flash = true;
+        }
+    }
+    for (const elf_section& sec : sections) {
+        if (!(sec.flags & elf_section::SHF_ALLOC) || sec.size == 0) {
+            continue;
+        }
+        bool nobits = sec.type == elf_section::SHT_NOBITS;
+        bool reserved = sec.name.compare(0, 6, ".stack") == 0 || sec.name == ".heap";
+        if (reserved) {
+            s.reserved += sec.size;
+        } else if (sec.flags & elf_section::SHF_EXECINSTR) {
+            s.text += sec.size;
+        } else if (nobits) {
+            s.bss += sec.size;
+        } else if (sec.flags & elf_section::SHF_WRITE) {
+            s.data += sec.size;
+        } else {
+            s.rodata += sec.size;
+        }
+        if (!reserved && in_range(sec.addr, SRAM_BASE, SRAM_END)) {
+            s.ram += sec.size;
+        }
+        if (has_flash && !nobits) {
+            s.flash += sec.size;
+        }
+    }
+    return s;
+}
+
+
+/**
+ * @brief best elapsed_us of every bench record in telemetry_decode CSV
+ */
+std::map<std::string, uint32_t> parse_results(const std::string& csv) {
+    std::map<std::string, uint32_t> results;
+    std::istringstream in(csv);
+    std::string line;
+    while (std::getline(in, line)) {
+        std::vector<std::string> cols;
+        std::stringstream fields(line);
+        std::string field;
+        while (std::getline(fields, field, ',')) {
+            cols.push_back(field);
+        }
+        // type,seq,core,time_us,scenario,flags,name,iterations,elapsed_us,...
+        if (cols.size() < 9 || cols[0] != "bench") {
+            continue;
+        }
+        std::string key = cols[4] + " " + cols[6] + (cols[2] == "0" ? "" : " core" + cols[2]);
+        uint32_t us = uint32_t(std::strtoul(cols[8].c_str(), nullptr, 10));
+        auto it = results.find(key);
+        if (it == results.end() || us < it->second) {
+            results[key] = us;
+        }
+    }
+    return results;
+}
+
+
+void find_bases(std::vector<target>& targets) {
+    for (target& t : targets) {
+        size_t best = 0;
+        for (size_t i = 0; i < targets.size(); i++) {
+            const std::string& n = targets[i].name;
+            if (n.size() > best && t.name.size() > n.size() + 1 && t.name.compare(0, n.size(), n) == 0 &&
+                t.name[n.size()] == '_') {
+                best = n.size();
+                t.base = int(i);
+            }
+        }
+    }
+}
+
+
+std::string delta(uint64_t value, uint64_t base) {
+    if (base == 0) {
+        return "";
+    }
+    char buf[16];
+    std::snprintf(buf, sizeof buf, "%+.1f%%", (double(value) - double(base)) * 100.0 / double(base));
+    return buf;
+}
+
+
+void print_sizes(const std::vector<target>& targets) {
+    std::printf("%-28s %8s %8s %8s %8s %8s %8s %9s %8s %9s\n", "target", "text", "rodata", "data", "bss",
+                "stk/heap", "flash", "", "ram", "");
+    for (const target& t : targets) {
+        const image_size& s = t.size;
+        const image_size* b = t.base >= 0 ? &targets[size_t(t.base)].size : nullptr;
+        std::printf("%-28s %8llu %8llu %8llu %8llu %8llu %8llu %9s %8llu %9s\n", t.name.c_str(),
+                    (unsigned long long)s.text, (unsigned long long)s.rodata, (unsigned long long)s.data,
+                    (unsigned long long)s.bss, (unsigned long long)s.reserved, (unsigned long long)s.flash,
+                    b ? delta(s.flash, b->flash).c_str() : "", (unsigned long long)s.ram,
+                    b ? delta(s.ram, b->ram).c_str() : "");
+    }
+}
+
+
+/**
+ * @brief one table per base target with results: a row per benchmark, a column per variant
+ */
+void print_results(const std::vector<target>& targets) {
+    for (size_t i = 0; i < targets.size(); i++) {
+        const target& base = targets[i];
+        if (base.base >= 0) {
+            continue;
+        }
+        std::vector<const target*> group;
+        for (const target& t : targets) {
+            if ((&t == &base || t.base == int(i)) && !t.results.empty()) {
+                group.push_back(&t);
+            }
+        }
+        if (group.empty()) {
+            continue;
+        }
+        std::map<std::string, bool> keys;
+        for (const target* t : group) {
+            for (const auto& r : t->results) {
+                keys[r.first] = true;
+            }
+        }
+
+        std::printf("\n# %s benchmarks, best elapsed us\n%-24s", base.name.c_str(), "scenario kernel");
+        for (const target* t : group) {
+            std::printf(" %20s", t->name.c_str());
+        }
+        std::printf("\n");
+        for (const auto& k : keys) {
+            std::printf("%-24s", k.first.c_str());
+            auto base_us = base.results.find(k.first);
+            for (const target* t : group) {
+                auto r = t->results.find(k.first);
+                if (r == t->results.end()) {
+                    std::printf(" %20s", "-");
+                    continue;
+                }
+                std::string cell = std::to_string(r->second);
+                if (t != &base && base_us != base.results.end()) {
+                    cell += " " + delta(r->second, base_us->second);
+                }
+                std::printf(" %20s", cell.c_str());
+            }
+            std::printf("\n");
+        }
+    }
+}
+
+
+/**
+ * @brief target name from an ELF path, e.g. build/labs/lab07/lab07_O3.elf is lab07_O3
+ */
+std::string target_name(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    size_t dot = name.rfind('.');
+    return dot == std::string::npos ? name : name.substr(0, dot);
+}
+
+
+int selftest() {
+    selftest_checks check;
+
+    const uint64_t AX = elf_section::SHF_ALLOC | elf_section::SHF_EXECINSTR;
+    const uint64_t A = elf_section::SHF_ALLOC;
+    const uint64_t WA = elf_section::SHF_ALLOC | elf_section::SHF_WRITE;
+    const uint32_t PROGBITS = 1;
+    const uint32_t NOBITS = elf_section::SHT_NOBITS;
+    auto sec = [](const char* name, uint32_t type, uint64_t flags, uint64_t addr, uint64_t size) {
+        return elf_section{name, type, flags, addr, size, 4, 0};
+    };
+
+    // flash image: boot2 and text in flash, some code and data copied to RAM
+    std::vector<elf_section> flash = {
+        sec(".boot2", PROGBITS, AX, 0x10000000, 256), sec(".text", PROGBITS, AX, 0x10000100, 10000),
+        sec(".rodata", PROGBITS, A, 0x10002810, 2000), sec(".ram_vector_table", NOBITS, WA, 0x20000000, 192),
+        sec(".data", PROGBITS, WA, 0x200000c0, 500), sec(".time_critical", PROGBITS, AX, 0x200002b4, 100),
+        sec(".bss", NOBITS, WA, 0x20000318, 3000), sec(".heap", NOBITS, WA, 0x20000ed0, 2048),
+        sec(".stack1_dummy", NOBITS, WA, 0x20040000, 2048), sec(".stack_dummy", NOBITS, WA, 0x20041000, 2048),
+        sec(".debug_info", PROGBITS, 0, 0, 99999),
+    };
+    image_size s = classify(flash);
+    check(s.text == 10356 && s.rodata == 2000 && s.data == 500 && s.bss == 3192, "flash image sections");
+    check(s.reserved == 6144, "stack and heap reserved");
+    check(s.flash == 256 + 10000 + 2000 + 500 + 100, "flash image flash");
+    check(s.ram == 192 + 500 + 100 + 3000, "flash image ram");
+
+    // no_flash image: everything in RAM, nothing in flash
+    std::vector<elf_section> no_flash = {
+        sec(".text", PROGBITS, AX, 0x20000000, 12000), sec(".data", PROGBITS, WA, 0x20002ee0, 500),
+        sec(".bss", NOBITS, WA, 0x200030d4, 3000),
+    };
+    s = classify(no_flash);
+    check(s.flash == 0 && s.ram == 15500, "no_flash image");
+
+    std::map<std::string, uint32_t> r = parse_results(
+        "type,seq,core,time_us,scenario,flags,name,iterations,elapsed_us,result,value,text\n"
+        "bench,0,0,100,1,1,float,100000,5000,3.14159,,\n"
+        "bench,1,0,200,1,1,float,100000,4800,3.14159,,\n"
+        "bench,2,1,300,2,3,double,100000,9000,3.14159,,\n"
+        "value,3,0,400,,,stack_used,,,,812,\n");
+    check(r.size() == 2 && r["1 float"] == 4800, "best result kept");
+    check(r.count("2 double core1") == 1, "core in key");
+
+    std::vector<target> targets = {{"lab07", {}, {}, -1}, {"lab07_O3", {}, {}, -1},
+                                   {"lab07_O3_copy_to_ram", {}, {}, -1}, {"lab07x", {}, {}, -1}};
+    find_bases(targets);
+    check(targets[0].base == -1 && targets[1].base == 0 && targets[2].base == 1 && targets[3].base == -1,
+          "variant bases");
+    check(target_name("build/labs/lab07/lab07_O3.elf") == "lab07_O3", "target name");
+    check(delta(90, 100) == "-10.0%", "delta");
+
+    return check.finish();
+}
+
+
+void usage() {
+    std::fprintf(stderr,
+                 "usage: size_report [--results <dir>] <firmware.elf>...\n"
+                 "       size_report --selftest\n");
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    std::string results_dir;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--selftest") == 0) {
+            return selftest();
+        } else if (std::strcmp(argv[i], "--results") == 0 && i + 1 < argc) {
+            results_dir = argv[++i];
+        } else if (argv[i][0] == '-') {
+            usage();
+            return 2;
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.empty()) {
+        usage();
+        return 2;
+    }
+
+    std::vector<target> targets;
+    for (const std::string& path : paths) {
+        elf_file elf;
+        std::string error;
+        if (!elf.load(path, error)) {
+            std::fprintf(stderr, "size_report: %s\n", error.c_str());
+            return 1;
+        }
+        target t;
+        t.name = target_name(path);
+        t.size = classify(elf.sections());
+        if (!results_dir.empty()) {
+            std::ifstream in(results_dir + "/" + t.name + ".csv");
+            if (in) {
+                std::stringstream csv;
+                csv << in.rdbuf();
+                t.results = parse_results(csv.str());
+            }
+        }
+        targets.push_back(t);
+    }
+    find_bases(targets);
+
+    print_sizes(targets);
+    print_results(targets);
+    return 0;
+}
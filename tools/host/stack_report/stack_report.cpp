@@ -0,0 +1,445 @@
+/*****************************************************************//**
+ * \file   stack_report.cpp
+ * \brief  worst-case stack depth per entry point from GCC's call graph
+ *
+ * Reads the .ci files GCC writes with -fcallgraph-info=su (see the
+ * stack_report() CMake function in lib/stack_usage): one VCG graph per
+ * translation unit, with a node per function carrying its frame size
+ * and an edge per call. The graphs are joined and every entry point is
+ * walked down its deepest call chain.
+ *
+ *   stack_report [--stack <bytes>] [--entry <function>]... [--roots] <dir | file.ci>...
+ *   stack_report --selftest
+ *
+ * Directories are searched recursively for .ci files. The entry points
+ * are main, core1_entry and every function whose name marks it as an
+ * exception handler (*_isr, *_handler, isr_*), plus any given with
+ * --entry; --roots adds every function no C code calls, which takes in
+ * those called from assembly. Handlers are charged the 32 byte exception
+ * frame and 4 bytes of alignment on top of their own chain.
+ *
+ * The depth is a lower bound when a chain calls something with no frame
+ * size, such as assembly, newlib or a function pointer, or uses a
+ * dynamically sized frame; these are listed after the path. Recursion
+ * is cut where it closes and flagged. With --stack the tool exits 1
+ * when an entry point needs more than the given number of bytes.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <regex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "selftest.hpp"
+
+namespace {
+
+// hardware stacked r0-r3, r12, lr, pc, xpsr, plus the padding that keeps it 8 byte aligned
+constexpr unsigned EXCEPTION_FRAME = 32 + 4;
+
+// GCC's node for calls through a function pointer
+const char* const INDIRECT_CALL = "__indirect_call";
+
+
+struct function {
+    std::string name;
+    std::string unit;               // .ci file it came from
+    unsigned frame = 0;
+    bool dynamic = false;           // frame size depends on alloca or a VLA
+    std::vector<std::string> callees;
+};
+
+
+struct call_graph {
+    std::vector<function> functions;
+    std::multimap<std::string, size_t> by_name;
+    std::set<std::string> called;   // names called by some function
+};
+
+
+struct chain {
+    unsigned depth = 0;
+    std::vector<std::string> path;
+    std::set<std::string> unknown;  // callees without a frame size
+    bool indirect = false;
+    bool recursive = false;
+    bool dynamic = false;
+};
+
+
+std::string unescape(const std::string& s) {
+    std::string out;
+    for (size_t i = 0; i < s.size(); i++) {
+        if (s[i] == '\\' && i + 1 < s.size()) {
+            i++;
+            out += s[i] == 'n' ? '\n' : s[i];
+        } else {
+            out += s[i];
+        }
+    }
+    return out;
+}
+
+
+/**
+ * @brief value of a quoted VCG attribute, e.g. title: "main"
+ */
+bool attribute(const std::string& line, const char* key, std::string& value) {
+    std::string pattern = std::string(key) + ": \"";
+    size_t pos = line.find(pattern);
+    if (pos == std::string::npos) {
+        return false;
+    }
+    pos += pattern.size();
+    size_t end = pos;
+    while (end < line.size() && line[end] != '"') {
+        end += line[end] == '\\' ? 2 : 1;
+    }
+    value = unescape(line.substr(pos, end - pos));
+    return true;
+}
+
+
+/**
+ * @brief add one .ci file's functions and calls to the graph
+ *
+ * nodes without a frame size are functions this unit only calls
+ */
+void parse_ci(const std::string& text, const std::string& unit, call_graph& graph) {
+    static const std::regex frame_re("([0-9]+) bytes \\(([a-z,]+)\\)");
+    std::map<std::string, size_t> local;
+    std::vector<std::pair<std::string, std::string>> edges;
+
+    std::istringstream in(text);
+    std::string line;
+    while (std::getline(in, line)) {
+        std::string title, label, source, target;
+        if (line.compare(0, 5, "node:") == 0 && attribute(line, "title", title) && attribute(line, "label", label)) {
+            std::smatch m;
+            if (!std::regex_search(label, m, frame_re)) {
+                continue;
+            }
+            function f;
+            f.name = title;
+            f.unit = unit;
+            f.frame = unsigned(std::strtoul(m[1].str().c_str(), nullptr, 10));
+            f.dynamic = m[2].str() != "static";
+            local[title] = graph.functions.size();
+            graph.by_name.emplace(title, graph.functions.size());
+            graph.functions.push_back(f);
+        } else if (line.compare(0, 5, "edge:") == 0 && attribute(line, "sourcename", source) &&
+                   attribute(line, "targetname", target)) {
+            edges.emplace_back(source, target);
+        }
+    }
+    for (const auto& e : edges) {
+        auto it = local.find(e.first);
+        if (it != local.end()) {
+            std::vector<std::string>& callees = graph.functions[it->second].callees;
+            if (std::find(callees.begin(), callees.end(), e.second) == callees.end()) {
+                callees.push_back(e.second);
+            }
+            if (e.first != e.second) {
+                graph.called.insert(e.second);
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief the definition a call from unit resolves to, preferring one in the same unit for statics
+ */
+const function* resolve(const call_graph& graph, const std::string& name, const std::string& unit) {
+    auto range = graph.by_name.equal_range(name);
+    const function* found = nullptr;
+    for (auto it = range.first; it != range.second; ++it) {
+        const function& f = graph.functions[it->second];
+        if (f.unit == unit) {
+            return &f;
+        }
+        if (!found) {
+            found = &f;
+        }
+    }
+    return found;
+}
+
+
+class walker {
+public:
+    explicit walker(const call_graph& graph) : graph_(graph) {}
+
+    chain deepest(const function& f) {
+        auto memo = done_.find(&f);
+        if (memo != done_.end()) {
+            return memo->second;
+        }
+        active_.insert(&f);
+
+        chain best;
+        for (const std::string& callee : f.callees) {
+            chain c;
+            if (callee == INDIRECT_CALL) {
+                c.indirect = true;
+            } else if (const function* g = resolve(graph_, callee, f.unit)) {
+                if (active_.count(g)) {
+                    c.recursive = true;
+                } else {
+                    c = deepest(*g);
+                }
+            } else {
+                c.unknown.insert(callee);
+            }
+            bool deeper = c.depth > best.depth;
+            best.unknown.insert(c.unknown.begin(), c.unknown.end());
+            best.indirect |= c.indirect;
+            best.recursive |= c.recursive;
+            best.dynamic |= c.dynamic;
+            if (deeper) {
+                best.depth = c.depth;
+                best.path = c.path;
+            }
+        }
+        best.depth += f.frame;
+        best.dynamic |= f.dynamic;
+        best.path.insert(best.path.begin(), f.name);
+
+        active_.erase(&f);
+        // a chain cut by recursion depends on where the walk entered the cycle
+        if (!best.recursive) {
+            done_[&f] = best;
+        }
+        return best;
+    }
+
+private:
+    const call_graph& graph_;
+    std::map<const function*, chain> done_;
+    std::set<const function*> active_;
+};
+
+
+bool is_handler(const std::string& name) {
+    auto ends_with = [&](const char* suffix) {
+        size_t n = std::strlen(suffix);
+        return name.size() > n && name.compare(name.size() - n, n, suffix) == 0;
+    };
+    return ends_with("_isr") || ends_with("_handler") || name.compare(0, 4, "isr_") == 0;
+}
+
+
+struct entry_report {
+    std::string name;
+    bool handler;
+    chain c;
+};
+
+
+std::vector<entry_report> report(const call_graph& graph, const std::set<std::string>& entries, bool roots) {
+    walker w(graph);
+    std::vector<entry_report> out;
+    std::set<std::string> seen;
+    for (const function& f : graph.functions) {
+        bool handler = is_handler(f.name);
+        bool wanted = f.name == "main" || f.name == "core1_entry" || handler || entries.count(f.name) ||
+                      (roots && !graph.called.count(f.name));
+        if (!wanted || !seen.insert(f.name + "\n" + f.unit).second) {
+            continue;
+        }
+        entry_report r{f.name, handler, w.deepest(f)};
+        if (handler) {
+            r.c.depth += EXCEPTION_FRAME;
+        }
+        out.push_back(r);
+    }
+    std::stable_sort(out.begin(), out.end(), [](const entry_report& a, const entry_report& b) {
+        return a.c.depth > b.c.depth;
+    });
+    return out;
+}
+
+
+/**
+ * @brief print the entry points, return true if they all fit the budget (0 for none)
+ */
+bool print_report(const std::vector<entry_report>& entries, unsigned budget) {
+    bool fits = true;
+    std::printf("# worst-case stack depth in bytes, + marks a lower bound\n");
+    for (const entry_report& r : entries) {
+        const chain& c = r.c;
+        bool bound = !c.unknown.empty() || c.indirect || c.recursive || c.dynamic;
+        std::string path;
+        for (const std::string& p : c.path) {
+            path += (path.empty() ? "" : " > ") + p;
+        }
+        std::printf("%6u%s %s%s", c.depth, bound ? "+" : " ", path.c_str(), r.handler ? " (+exception frame)" : "");
+        if (!c.unknown.empty()) {
+            std::string names;
+            for (const std::string& u : c.unknown) {
+                names += (names.empty() ? "" : ",") + u;
+            }
+            std::printf("  unknown: %s", names.c_str());
+        }
+        std::printf("%s%s%s", c.indirect ? "  indirect" : "", c.recursive ? "  recursive" : "",
+                    c.dynamic ? "  dynamic" : "");
+        if (budget && c.depth > budget) {
+            std::printf("  OVER %u", budget);
+            fits = false;
+        }
+        std::printf("\n");
+    }
+    return fits;
+}
+
+
+bool load(const std::string& path, call_graph& graph) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    std::stringstream text;
+    text << in.rdbuf();
+    parse_ci(text.str(), path, graph);
+    return true;
+}
+
+
+const entry_report* find(const std::vector<entry_report>& entries, const char* name) {
+    for (const entry_report& r : entries) {
+        if (r.name == name) {
+            return &r;
+        }
+    }
+    return nullptr;
+}
+
+
+int selftest() {
+    selftest_checks check;
+
+    const char* app_ci =
+        "graph: { title: \"app.c\"\n"
+        "node: { title: \"main\" label: \"main\\napp.c:20:5\\n16 bytes (static)\" }\n"
+        "node: { title: \"compute\" label: \"compute\\napp.c:10:7\\n40 bytes (static)\" }\n"
+        "node: { title: \"helper\" label: \"helper\\napp.c:3:13\\n8 bytes (static)\" }\n"
+        "node: { title: \"memcpy\" label: \"memcpy\\n<built-in>\" shape : ellipse }\n"
+        "node: { title: \"log_value\" label: \"log_value\\nlog.h:4:6\" shape : ellipse }\n"
+        "edge: { sourcename: \"main\" targetname: \"compute\" label: \"app.c:22:3\" }\n"
+        "edge: { sourcename: \"main\" targetname: \"helper\" label: \"app.c:23:3\" }\n"
+        "edge: { sourcename: \"compute\" targetname: \"log_value\" label: \"app.c:12:3\" }\n"
+        "edge: { sourcename: \"helper\" targetname: \"memcpy\" label: \"app.c:5:3\" }\n"
+        "node: { title: \"alarm_isr\" label: \"alarm_isr\\napp.c:30:6\\n8 bytes (static)\" }\n"
+        "node: { title: \"__indirect_call\" label: \"Indirect Call Placeholder\" shape : ellipse }\n"
+        "edge: { sourcename: \"alarm_isr\" targetname: \"__indirect_call\" label: \"app.c:31:3\" }\n"
+        "edge: { sourcename: \"alarm_isr\" targetname: \"helper\" label: \"app.c:32:3\" }\n"
+        "node: { title: \"walk\" label: \"walk\\napp.c:40:6\\n24 bytes (dynamic,bounded)\" }\n"
+        "edge: { sourcename: \"walk\" targetname: \"walk\" label: \"app.c:42:5\" }\n"
+        "}\n";
+    const char* log_ci =
+        "graph: { title: \"log.c\"\n"
+        "node: { title: \"log_value\" label: \"log_value\\nlog.c:4:6\\n32 bytes (static)\" }\n"
+        "node: { title: \"helper\" label: \"helper\\nlog.c:2:13\\n100 bytes (static)\" }\n"
+        "edge: { sourcename: \"log_value\" targetname: \"helper\" label: \"log.c:6:3\" }\n"
+        "}\n";
+
+    call_graph graph;
+    parse_ci(app_ci, "app.ci", graph);
+    parse_ci(log_ci, "log.ci", graph);
+    check(graph.functions.size() == 7, "parsed functions");
+
+    std::vector<entry_report> entries = report(graph, {"walk"}, false);
+    const entry_report* main_entry = find(entries, "main");
+    // main 16 > compute 40 > log_value 32 > log.c's static helper 100, not app.c's
+    check(main_entry && main_entry->c.depth == 188, "main depth across units");
+    check(main_entry && main_entry->c.path.size() == 4 && main_entry->c.path[3] == "helper", "main path");
+    check(main_entry && main_entry->c.unknown.count("memcpy") == 1, "unknown callee");
+    const entry_report* isr = find(entries, "alarm_isr");
+    check(isr && isr->handler && isr->c.depth == 8 + 8 + EXCEPTION_FRAME, "handler frame");
+    check(isr && isr->c.indirect, "indirect call");
+    const entry_report* walk = find(entries, "walk");
+    check(walk && walk->c.recursive && walk->c.dynamic && walk->c.depth == 24, "recursion");
+    check(!entries.empty() && entries[0].name == "main", "deepest first");
+    check(!find(entries, "compute"), "only entry points");
+    check(find(report(graph, {}, true), "walk") != nullptr, "roots");
+
+    return check.finish();
+}
+
+
+void usage() {
+    std::fprintf(stderr,
+                 "usage: stack_report [--stack <bytes>] [--entry <function>]... [--roots] <dir | file.ci>...\n"
+                 "       stack_report --selftest\n");
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    unsigned budget = 0;
+    bool roots = false;
+    std::set<std::string> entries;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--selftest") == 0) {
+            return selftest();
+        } else if (std::strcmp(argv[i], "--stack") == 0 && i + 1 < argc) {
+            budget = unsigned(std::strtoul(argv[++i], nullptr, 0));
+        } else if (std::strcmp(argv[i], "--entry") == 0 && i + 1 < argc) {
+            entries.insert(argv[++i]);
+        } else if (std::strcmp(argv[i], "--roots") == 0) {
+            roots = true;
+        } else if (argv[i][0] == '-') {
+            usage();
+            return 2;
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.empty()) {
+        usage();
+        return 2;
+    }
+
+    call_graph graph;
+    size_t files = 0;
+    for (const std::string& path : paths) {
+        std::error_code ec;
+        if (std::filesystem::is_directory(path, ec)) {
+            std::vector<std::string> found;
+            for (const auto& e : std::filesystem::recursive_directory_iterator(path, ec)) {
+                if (e.is_regular_file() && e.path().extension() == ".ci") {
+                    found.push_back(e.path().string());
+                }
+            }
+            // directory order is arbitrary, keep the output stable
+            std::sort(found.begin(), found.end());
+            for (const std::string& f : found) {
+                files += load(f, graph);
+            }
+        } else if (load(path, graph)) {
+            files++;
+        } else {
+            std::fprintf(stderr, "stack_report: cannot open %s\n", path.c_str());
+            return 1;
+        }
+    }
+    if (files == 0) {
+        std::fprintf(stderr, "stack_report: no .ci files found, build with -fcallgraph-info=su\n");
+        return 1;
+    }
+
+    return print_report(report(graph, entries, roots), budget) ? 0 : 1;
+}
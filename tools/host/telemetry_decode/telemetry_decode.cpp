@@ -0,0 +1,413 @@
+/*****************************************************************//**
+ * \file   telemetry_decode.cpp
+ * \brief  host decoder for the binary telemetry channel
+ *
+ * Reads COBS framed telemetry records (see lib/telemetry) from a
+ * serial device, a capture file or stdin and prints them as CSV or
+ * as a table. Frames failing the CRC are counted and skipped, and
+ * gaps in the sequence numbers are reported as dropped records.
+ *
+ *   telemetry_decode [--table] [--baud N] <device | file | ->
+ *   telemetry_decode [--table] --loopback
+ *
+ * --loopback opens a pseudo terminal pair, writes a canned run of
+ * records (plus one corrupted frame) into the master side with the
+ * same encoder the firmware uses, and decodes the slave side exactly
+ * as it would a USB-serial adapter. It needs no hardware.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "telemetry_proto.h"
+
+
+/**
+ * @brief one decoded record
+ */
+struct record {
+    uint8_t type;
+    uint8_t core;
+    uint16_t seq;
+    uint32_t time_us;
+    std::vector<uint8_t> payload;
+};
+
+
+/**
+ * @brief frame and record counters, printed at the end of a run
+ */
+struct decode_stats {
+    unsigned long frames = 0;
+    unsigned long bad_frames = 0;
+    unsigned long crc_errors = 0;
+    unsigned long dropped = 0;
+};
+
+
+/**
+ * @brief splits a byte stream into frames and checks each one
+ */
+class frame_decoder {
+public:
+    /**
+     * @brief feed received bytes, calling on_record for every valid record
+     */
+    template <typename F>
+    void feed(const uint8_t* data, size_t len, F&& on_record) {
+        for (size_t i = 0; i < len; i++) {
+            if (data[i] != 0) {
+                // anything longer than the largest frame is noise, wait for the next delimiter
+                if (frame_.size() < TLM_MAX_FRAME) {
+                    frame_.push_back(data[i]);
+                } else {
+                    overflow_ = true;
+                }
+                continue;
+            }
+            if (!frame_.empty() || overflow_) {
+                handle_frame(on_record);
+            }
+            frame_.clear();
+            overflow_ = false;
+        }
+    }
+
+    const decode_stats& stats() const { return stats_; }
+
+private:
+    template <typename F>
+    void handle_frame(F&& on_record) {
+        uint8_t raw[TLM_MAX_FRAME];
+        stats_.frames++;
+
+        size_t len = overflow_ ? 0 : tlm_cobs_decode(frame_.data(), frame_.size(), raw);
+        if (len < TLM_HEADER_SIZE + TLM_CRC_SIZE) {
+            stats_.bad_frames++;
+            return;
+        }
+
+        size_t body = len - TLM_CRC_SIZE;
+        if (tlm_crc16(raw, body) != tlm_get_u16(&raw[body])) {
+            stats_.crc_errors++;
+            return;
+        }
+
+        record rec;
+        rec.type = raw[0];
+        rec.core = raw[1];
+        rec.seq = tlm_get_u16(&raw[2]);
+        rec.time_us = tlm_get_u32(&raw[4]);
+        rec.payload.assign(raw + TLM_HEADER_SIZE, raw + body);
+
+        if (have_seq_) {
+            stats_.dropped += static_cast<uint16_t>(rec.seq - next_seq_);
+        }
+        have_seq_ = true;
+        next_seq_ = static_cast<uint16_t>(rec.seq + 1);
+
+        on_record(rec);
+    }
+
+    std::vector<uint8_t> frame_;
+    bool overflow_ = false;
+    bool have_seq_ = false;
+    uint16_t next_seq_ = 0;
+    decode_stats stats_;
+};
+
+
+// ---- output ---- //
+
+static std::string payload_string(const record& rec, size_t offset) {
+    if (rec.payload.size() <= offset) {
+        return std::string();
+    }
+    return std::string(rec.payload.begin() + offset, rec.payload.end());
+}
+
+
+static double payload_double(const uint8_t* p) {
+    uint64_t bits = tlm_get_u32(p) | (static_cast<uint64_t>(tlm_get_u32(p + 4)) << 32);
+    double d;
+    std::memcpy(&d, &bits, sizeof(d));
+    return d;
+}
+
+
+/**
+ * @brief CSV output, one column set shared by all record types
+ */
+static void print_csv_header() {
+    std::printf("type,seq,core,time_us,scenario,flags,name,iterations,elapsed_us,result,value,text\n");
+}
+
+
+static void print_csv(const record& rec) {
+    const uint8_t* p = rec.payload.data();
+    switch (rec.type) {
+    case TLM_REC_BENCH:
+        if (rec.payload.size() < TLM_BENCH_NAME_OFFSET) break;
+        std::printf("bench,%u,%u,%u,%u,%u,%s,%u,%u,%.11f,,\n", rec.seq, rec.core, rec.time_us,
+                    p[0], p[1], payload_string(rec, TLM_BENCH_NAME_OFFSET).c_str(),
+                    tlm_get_u32(&p[4]), tlm_get_u32(&p[8]), payload_double(&p[12]));
+        return;
+    case TLM_REC_VALUE:
+        if (rec.payload.size() < TLM_VALUE_NAME_OFFSET) break;
+        std::printf("value,%u,%u,%u,,,%s,,,,%u,\n", rec.seq, rec.core, rec.time_us,
+                    payload_string(rec, TLM_VALUE_NAME_OFFSET).c_str(), tlm_get_u32(&p[0]));
+        return;
+    case TLM_REC_TEXT:
+        std::printf("text,%u,%u,%u,,,,,,,,\"%s\"\n", rec.seq, rec.core, rec.time_us,
+                    payload_string(rec, 0).c_str());
+        return;
+    default:
+        break;
+    }
+    std::printf("unknown-%u,%u,%u,%u,,,,,,,,\n", rec.type, rec.seq, rec.core, rec.time_us);
+}
+
+
+static void print_table(const record& rec) {
+    const uint8_t* p = rec.payload.data();
+    switch (rec.type) {
+    case TLM_REC_BENCH:
+        if (rec.payload.size() < TLM_BENCH_NAME_OFFSET) break;
+        std::printf("%10u  core%u  bench  scenario %-3u %-5s %-6s %-16s %8u iters %10u us  %.11f\n",
+                    rec.time_us, rec.core, p[0],
+                    (p[1] & TLM_BENCH_CACHE_EN) ? "cache" : "-",
+                    (p[1] & TLM_BENCH_DUAL_CORE) ? "dual" : "single",
+                    payload_string(rec, TLM_BENCH_NAME_OFFSET).c_str(),
+                    tlm_get_u32(&p[4]), tlm_get_u32(&p[8]), payload_double(&p[12]));
+        return;
+    case TLM_REC_VALUE:
+        if (rec.payload.size() < TLM_VALUE_NAME_OFFSET) break;
+        std::printf("%10u  core%u  value  %-16s = %u\n", rec.time_us, rec.core,
+                    payload_string(rec, TLM_VALUE_NAME_OFFSET).c_str(), tlm_get_u32(&p[0]));
+        return;
+    case TLM_REC_TEXT:
+        std::printf("%10u  core%u  text   %s\n", rec.time_us, rec.core, payload_string(rec, 0).c_str());
+        return;
+    default:
+        break;
+    }
+    std::printf("%10u  core%u  unknown record type %u\n", rec.time_us, rec.core, rec.type);
+}
+
+
+// ---- input ---- //
+
+static speed_t baud_constant(long baud) {
+    switch (baud) {
+    case 9600: return B9600;
+    case 19200: return B19200;
+    case 38400: return B38400;
+    case 57600: return B57600;
+    case 115200: return B115200;
+    case 230400: return B230400;
+    case 460800: return B460800;
+    case 921600: return B921600;
+    default: return B0;
+    }
+}
+
+
+/**
+ * @brief put a tty into raw mode so no byte is translated or swallowed
+ */
+static bool make_raw(int fd, long baud) {
+    termios tio;
+    if (tcgetattr(fd, &tio) != 0) {
+        return false;
+    }
+    cfmakeraw(&tio);
+    if (baud) {
+        speed_t speed = baud_constant(baud);
+        if (speed == B0) {
+            std::fprintf(stderr, "unsupported baud rate %ld\n", baud);
+            return false;
+        }
+        cfsetispeed(&tio, speed);
+        cfsetospeed(&tio, speed);
+    }
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+    return tcsetattr(fd, TCSANOW, &tio) == 0;
+}
+
+
+/**
+ * @brief decode everything readable from fd until end of file
+ */
+static decode_stats decode_fd(int fd, bool table) {
+    frame_decoder decoder;
+    uint8_t buf[256];
+
+    if (!table) {
+        print_csv_header();
+    }
+    for (;;) {
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break; // end of file, or EIO once the pty master is closed
+        }
+        decoder.feed(buf, static_cast<size_t>(n), [table](const record& rec) {
+            table ? print_table(rec) : print_csv(rec);
+        });
+        std::fflush(stdout);
+    }
+    return decoder.stats();
+}
+
+
+// ---- loopback ---- //
+
+/**
+ * @brief write a canned run of records, as lab07 would send them, into fd
+ *
+ * closing the master discards whatever the slave hasn't read yet, so
+ * wait for the reader to drain the slave side (reader_fd) first
+ */
+static void loopback_writer(int fd, int reader_fd) {
+    uint8_t frame[TLM_MAX_FRAME];
+    uint8_t payload[TLM_MAX_RECORD];
+    uint16_t seq = 0;
+    uint32_t now = 5000000;
+
+    auto send = [&](uint8_t type, uint8_t core, size_t len, bool corrupt) {
+        size_t n = tlm_frame_build(type, core, seq++, now, payload, len, frame);
+        if (corrupt) {
+            frame[n / 2] ^= 0x5a;
+        }
+        now += 1000;
+        ssize_t written = write(fd, frame, n);
+        (void)written;
+    };
+
+    static const char banner[] = "lab07 loopback";
+    std::memcpy(payload, banner, sizeof(banner) - 1);
+    send(TLM_REC_TEXT, 0, sizeof(banner) - 1, false);
+
+    static const char* const kernels[] = { "float", "double", "dfloat" };
+    for (uint8_t scenario = 1; scenario <= 2; scenario++) {
+        uint8_t flags = scenario == 1 ? TLM_BENCH_CACHE_EN : 0;
+        for (unsigned k = 0; k < 3; k++) {
+            size_t len = tlm_bench_payload(payload, scenario, flags, 100000, 100000 * (k + 2) * scenario,
+                                           3.14158479966 + k * 1e-9, kernels[k]);
+            send(TLM_REC_BENCH, 0, len, false);
+        }
+    }
+
+    // a corrupted frame, then a skipped sequence number as if the ring had overflowed
+    size_t len = tlm_value_payload(payload, 1, "lstate");
+    send(TLM_REC_VALUE, 0, len, true);
+    seq++;
+    len = tlm_value_payload(payload, 500000, "ltimer");
+    send(TLM_REC_VALUE, 1, len, false);
+
+    for (int idle = 0; idle < 2; ) {
+        int pending = 0;
+        ioctl(reader_fd, FIONREAD, &pending);
+        idle = pending ? 0 : idle + 1;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    close(fd);
+}
+
+
+static int run_loopback(bool table) {
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+        std::perror("posix_openpt");
+        return 1;
+    }
+    const char* name = ptsname(master);
+    int slave = name ? open(name, O_RDWR | O_NOCTTY) : -1;
+    if (slave < 0 || !make_raw(slave, 0) || !make_raw(master, 0)) {
+        std::perror("pty slave");
+        return 1;
+    }
+    std::fprintf(stderr, "loopback through %s\n", name);
+
+    std::thread writer(loopback_writer, master, slave);
+    decode_stats stats = decode_fd(slave, table);
+    writer.join();
+    close(slave);
+
+    std::fprintf(stderr, "frames %lu, bad %lu, crc errors %lu, dropped %lu\n",
+                 stats.frames, stats.bad_frames, stats.crc_errors, stats.dropped);
+
+    // the canned run contains exactly one corrupted frame and one gap
+    return (stats.crc_errors + stats.bad_frames == 1 && stats.dropped == 2) ? 0 : 1;
+}
+
+
+static void usage() {
+    std::fprintf(stderr,
+                 "usage: telemetry_decode [--table] [--baud N] <device | file | ->\n"
+                 "       telemetry_decode [--table] --loopback\n");
+}
+
+
+int main(int argc, char** argv) {
+    bool table = false;
+    bool loopback = false;
+    long baud = 0;
+    const char* path = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--table")) {
+            table = true;
+        } else if (!std::strcmp(argv[i], "--loopback")) {
+            loopback = true;
+        } else if (!std::strcmp(argv[i], "--baud") && i + 1 < argc) {
+            baud = std::strtol(argv[++i], nullptr, 10);
+        } else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+            usage();
+            return 2;
+        } else {
+            path = argv[i];
+        }
+    }
+
+    if (loopback) {
+        return run_loopback(table);
+    }
+    if (!path) {
+        usage();
+        return 2;
+    }
+
+    int fd = std::strcmp(path, "-") ? open(path, O_RDONLY | O_NOCTTY) : STDIN_FILENO;
+    if (fd < 0) {
+        std::perror(path);
+        return 1;
+    }
+    if (isatty(fd) && !make_raw(fd, baud ? baud : 921600)) {
+        std::perror("tcsetattr");
+        return 1;
+    }
+
+    decode_stats stats = decode_fd(fd, table);
+    std::fprintf(stderr, "frames %lu, bad %lu, crc errors %lu, dropped %lu\n",
+                 stats.frames, stats.bad_frames, stats.crc_errors, stats.dropped);
+    return 0;
+}
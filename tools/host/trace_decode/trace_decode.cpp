@@ -0,0 +1,383 @@
+/*****************************************************************//**
+ * \file   trace_decode.cpp
+ * \brief  decodes lib/trace ring buffers dumped over SWD
+ *
+ * Finds the per-core trace buffers in a memory dump (either just
+ * trace_buffers or all of SRAM, see tools/openocd/scripts/tools/
+ * pico_dump.tcl), rebuilds 64 bit cycle times from the 32 bit stamps,
+ * pairs entries with exits and reports per function call counts and
+ * inclusive/exclusive cycle totals.
+ *
+ *   trace_decode [--events] [--elf firmware.elf] <dump | ->
+ *   trace_decode --selftest
+ *
+ * --events prints every event as CSV instead of the summary. Without
+ * --elf functions are shown as addresses. --selftest decodes a
+ * synthetic dump with a wrapped ring, SysTick wraps, a missed wrap and
+ * nesting, and checks the result; it needs no hardware.
+ *
+ * \author marco
+ * \date   October 2026
+ *********************************************************************/
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "elf_file.hpp"
+#include "selftest.hpp"
+
+namespace {
+
+// must match lib/trace/include/trace.h
+constexpr uint32_t TRACE_MAGIC = 0x45435254;
+constexpr uint32_t TRACE_EXIT_BIT = 1;
+constexpr size_t HEADER_SIZE = 16;
+constexpr size_t EVENT_SIZE = 8;
+constexpr uint32_t MAX_CAPACITY = 1u << 20;
+constexpr unsigned NUM_CORES = 2;
+
+// SysTick supplies the low 24 bits of a stamp
+constexpr uint64_t STAMP_WRAP = 1ull << 24;
+
+
+struct event {
+    unsigned core;
+    uint32_t fn;        // exit bit cleared
+    bool exit;
+    uint64_t cycle;     // unwrapped
+    unsigned depth;
+    uint64_t duration;  // exits only
+};
+
+
+struct function_stats {
+    uint64_t calls = 0;
+    uint64_t total = 0;
+    uint64_t self = 0;
+    uint64_t min = UINT64_MAX;
+    uint64_t max = 0;
+};
+
+
+struct trace_result {
+    std::vector<event> events;
+    std::map<std::pair<unsigned, uint32_t>, function_stats> stats;
+    unsigned buffers = 0;
+    uint64_t overwritten = 0;   // events lost to the ring wrapping
+    uint64_t unmatched = 0;     // exits without an entry, entries without an exit
+};
+
+
+uint32_t get_u32(const std::vector<uint8_t>& data, size_t offset) {
+    return uint32_t(data[offset]) | uint32_t(data[offset + 1]) << 8 |
+           uint32_t(data[offset + 2]) << 16 | uint32_t(data[offset + 3]) << 24;
+}
+
+
+void put_u32(std::vector<uint8_t>& data, size_t offset, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        data[offset + i] = uint8_t(value >> (8 * i));
+    }
+}
+
+
+/**
+ * @brief turn stamps into a monotonic cycle count
+ *
+ * the stamps are wrap count:SysTick, so the 32 bit difference between
+ * consecutive events is the elapsed time unless a wrap was missed; that
+ * shows up as time going backwards by less than one SysTick period
+ */
+class stamp_unwrapper {
+public:
+    uint64_t next(uint32_t stamp) {
+        if (!started_) {
+            started_ = true;
+            last_ = stamp;
+            cycle_ = stamp;
+            return cycle_;
+        }
+        uint32_t delta = stamp - last_;
+        if (delta >= 0x80000000u) {
+            delta += uint32_t(STAMP_WRAP);
+        }
+        // track the corrected stamp, later events may miss the same wrap
+        last_ += delta;
+        cycle_ += delta;
+        return cycle_;
+    }
+
+private:
+    bool started_ = false;
+    uint32_t last_ = 0;
+    uint64_t cycle_ = 0;
+};
+
+
+/**
+ * @brief decode the buffer at offset, pairing entries and exits
+ */
+void decode_buffer(const std::vector<uint8_t>& data, size_t offset, trace_result& result) {
+    unsigned core = get_u32(data, offset + 4);
+    uint32_t capacity = get_u32(data, offset + 8);
+    uint32_t head = get_u32(data, offset + 12);
+    uint32_t count = std::min(head, capacity);
+    result.buffers++;
+    result.overwritten += head - count;
+
+    struct frame {
+        uint32_t fn;
+        uint64_t start;
+        uint64_t children;
+    };
+    std::vector<frame> stack;
+    stamp_unwrapper clock;
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t slot = (head - count + i) & (capacity - 1);
+        size_t at = offset + HEADER_SIZE + size_t(slot) * EVENT_SIZE;
+        uint32_t fn = get_u32(data, at);
+
+        event e{core, fn & ~TRACE_EXIT_BIT, (fn & TRACE_EXIT_BIT) != 0, clock.next(get_u32(data, at + 4)), 0, 0};
+
+        if (!e.exit) {
+            e.depth = unsigned(stack.size());
+            stack.push_back({e.fn, e.cycle, 0});
+            result.events.push_back(e);
+            continue;
+        }
+
+        // unwind to the matching entry, anything above it never logged an exit
+        auto match = std::find_if(stack.rbegin(), stack.rend(), [&](const frame& f) { return f.fn == e.fn; });
+        if (match == stack.rend()) {
+            result.unmatched++;
+            result.events.push_back(e);
+            continue;
+        }
+        size_t index = size_t(stack.rend() - match) - 1;
+        result.unmatched += stack.size() - index - 1;
+        stack.resize(index + 1);
+
+        frame f = stack.back();
+        stack.pop_back();
+        e.depth = unsigned(stack.size());
+        e.duration = e.cycle - f.start;
+        if (!stack.empty()) {
+            stack.back().children += e.duration;
+        }
+
+        function_stats& s = result.stats[{core, e.fn}];
+        s.calls++;
+        s.total += e.duration;
+        s.self += e.duration - f.children;
+        s.min = std::min(s.min, e.duration);
+        s.max = std::max(s.max, e.duration);
+        result.events.push_back(e);
+    }
+    result.unmatched += stack.size();
+}
+
+
+/**
+ * @brief find and decode every trace buffer in a dump
+ */
+bool decode_dump(const std::vector<uint8_t>& data, trace_result& result) {
+    for (size_t offset = 0; offset + HEADER_SIZE <= data.size(); offset += 4) {
+        if (get_u32(data, offset) != TRACE_MAGIC) {
+            continue;
+        }
+        uint32_t core = get_u32(data, offset + 4);
+        uint32_t capacity = get_u32(data, offset + 8);
+        if (core >= NUM_CORES || capacity == 0 || capacity > MAX_CAPACITY || (capacity & (capacity - 1)) ||
+            offset + HEADER_SIZE + size_t(capacity) * EVENT_SIZE > data.size()) {
+            continue;
+        }
+        decode_buffer(data, offset, result);
+        offset += HEADER_SIZE + size_t(capacity) * EVENT_SIZE - 4;
+    }
+    return result.buffers != 0;
+}
+
+
+std::string name_of(const elf_file* elf, uint32_t fn) {
+    if (elf) {
+        return elf->function_name(fn);
+    }
+    char buf[16];
+    std::snprintf(buf, sizeof(buf), "0x%08" PRIx32, fn);
+    return buf;
+}
+
+
+void print_summary(const trace_result& result, const elf_file* elf) {
+    std::vector<std::pair<std::pair<unsigned, uint32_t>, function_stats>> rows(result.stats.begin(),
+                                                                               result.stats.end());
+    std::sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) {
+        return a.first.first != b.first.first ? a.first.first < b.first.first : a.second.total > b.second.total;
+    });
+
+    std::printf("%4s %8s %12s %12s %10s %10s %10s  %s\n",
+                "core", "calls", "total", "self", "min", "avg", "max", "function");
+    for (const auto& row : rows) {
+        const function_stats& s = row.second;
+        std::printf("%4u %8" PRIu64 " %12" PRIu64 " %12" PRIu64 " %10" PRIu64 " %10" PRIu64 " %10" PRIu64 "  %s\n",
+                    row.first.first, s.calls, s.total, s.self, s.min, s.total / s.calls, s.max,
+                    name_of(elf, row.first.second).c_str());
+    }
+    std::printf("\n%u buffers, %zu events, %" PRIu64 " overwritten, %" PRIu64 " unmatched, times in cycles\n",
+                result.buffers, result.events.size(), result.overwritten, result.unmatched);
+}
+
+
+void print_events(const trace_result& result, const elf_file* elf) {
+    std::printf("core,cycle,event,depth,duration,function\n");
+    for (const event& e : result.events) {
+        std::printf("%u,%" PRIu64 ",%s,%u,", e.core, e.cycle, e.exit ? "exit" : "enter", e.depth);
+        if (e.exit) {
+            std::printf("%" PRIu64, e.duration);
+        }
+        std::printf(",%s\n", name_of(elf, e.fn).c_str());
+    }
+}
+
+
+/**
+ * @brief build a dump the way the firmware would and check the decoded numbers
+ */
+int selftest() {
+    const uint32_t capacity = 8;
+    const size_t buffer_size = HEADER_SIZE + capacity * EVENT_SIZE;
+    const uint32_t kernel = 0x10000300, leaf = 0x10000400, isr = 0x20000100;
+
+    // some unrelated memory in front, the decoder has to find the buffers itself
+    std::vector<uint8_t> dump(64 + 2 * buffer_size, 0xa5);
+    std::vector<std::pair<uint32_t, uint32_t>> core0 = {
+        {leaf, 0x00fffff0},                         // overwritten by the ring wrapping
+        {leaf | TRACE_EXIT_BIT, 0x00fffff8},        // overwritten
+        {kernel, 0x00ffff00},                       // enter just before a SysTick wrap
+        {leaf, 0x01000010},                         // 0x110 cycles later, after the wrap
+        {leaf | TRACE_EXIT_BIT, 0x01000050},        // leaf took 0x40
+        {leaf, 0x01ffffe0},
+        {leaf | TRACE_EXIT_BIT, 0x01000010},        // wrap missed with interrupts masked, leaf took 0x30
+        {kernel | TRACE_EXIT_BIT, 0x02000100},      // wrap counted again, kernel took 0x1000200
+        {isr, 0x02000200},
+        {isr | TRACE_EXIT_BIT, 0x02000220},         // isr took 0x20
+    };
+    std::vector<std::pair<uint32_t, uint32_t>> core1 = {
+        {kernel | TRACE_EXIT_BIT, 5},               // exit whose entry was never logged
+        {kernel, 10},
+        {kernel | TRACE_EXIT_BIT, 1010},
+    };
+
+    auto write = [&](size_t offset, unsigned core, const std::vector<std::pair<uint32_t, uint32_t>>& events) {
+        put_u32(dump, offset, TRACE_MAGIC);
+        put_u32(dump, offset + 4, core);
+        put_u32(dump, offset + 8, capacity);
+        put_u32(dump, offset + 12, uint32_t(events.size()));
+        for (size_t i = 0; i < events.size(); i++) {
+            size_t at = offset + HEADER_SIZE + (i & (capacity - 1)) * EVENT_SIZE;
+            put_u32(dump, at, events[i].first);
+            put_u32(dump, at + 4, events[i].second);
+        }
+    };
+    write(64, 0, core0);
+    write(64 + buffer_size, 1, core1);
+
+    trace_result result;
+    selftest_checks check;
+    check(decode_dump(dump, result), "decode the dump");
+    auto stats = [&](unsigned core, uint32_t fn) { return result.stats[{core, fn}]; };
+
+    function_stats k0 = stats(0, kernel);
+    function_stats l0 = stats(0, leaf);
+    function_stats i0 = stats(0, isr);
+    function_stats k1 = stats(1, kernel);
+    check(result.buffers == 2, "expected two buffers");
+    check(result.overwritten == 2, "expected two overwritten events");
+    check(result.unmatched == 1, "expected one unmatched exit");
+    check(k0.calls == 1 && k0.total == 0x1000200, "kernel time on core 0");
+    check(l0.calls == 2 && l0.min == 0x30 && l0.max == 0x40, "leaf times on core 0");
+    check(k0.self == 0x1000200 - 0x70, "kernel self time on core 0");
+    check(i0.calls == 1 && i0.total == 0x20, "isr time on core 0");
+    check(k1.calls == 1 && k1.total == 1000, "kernel time on core 1");
+
+    return check.finish();
+}
+
+
+void usage() {
+    std::fprintf(stderr, "usage: trace_decode [--events] [--elf firmware.elf] <dump | ->\n"
+                         "       trace_decode --selftest\n");
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    bool events = false;
+    std::string elf_path;
+    std::string dump_path;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--selftest") == 0) {
+            return selftest();
+        } else if (std::strcmp(argv[i], "--events") == 0) {
+            events = true;
+        } else if (std::strcmp(argv[i], "--elf") == 0 && i + 1 < argc) {
+            elf_path = argv[++i];
+        } else if (dump_path.empty()) {
+            dump_path = argv[i];
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (dump_path.empty()) {
+        usage();
+        return 2;
+    }
+
+    elf_file elf;
+    if (!elf_path.empty()) {
+        std::string error;
+        if (!elf.load(elf_path, error)) {
+            std::fprintf(stderr, "trace_decode: %s\n", error.c_str());
+            return 1;
+        }
+    }
+
+    std::vector<uint8_t> data;
+    if (dump_path == "-") {
+        data.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+    } else {
+        std::ifstream in(dump_path, std::ios::binary);
+        if (!in) {
+            std::fprintf(stderr, "trace_decode: cannot open %s\n", dump_path.c_str());
+            return 1;
+        }
+        data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    trace_result result;
+    if (!decode_dump(data, result)) {
+        std::fprintf(stderr, "trace_decode: no trace buffers found in %s\n", dump_path.c_str());
+        return 1;
+    }
+
+    const elf_file* symbols = elf_path.empty() ? nullptr : &elf;
+    if (events) {
+        print_events(result, symbols);
+    } else {
+        print_summary(result, symbols);
+    }
+    return 0;
+}
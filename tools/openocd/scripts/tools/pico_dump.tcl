@@ -0,0 +1,60 @@
+# Helpers for pulling the trace and profiler buffers out of a running RP2040 over SWD.
+#
+# openocd -f interface/cmsis-dap.cfg -f target/rp2040.cfg -f tools/pico_dump.tcl \
+#         -c "init; trace_dump trace.bin; shutdown"
+#
+# trace.bin is decoded by tools/host/trace_decode, profile.bin by tools/host/profile_report.
+# Addresses come from the firmware, e.g. arm-none-eabi-nm lab07.elf | grep trace_buffers.
+
+set PICO_SRAM_BASE 0x20000000
+set PICO_SRAM_SIZE 0x42000
+set PICO_NUM_CORES 2
+
+# words before the entries of one lib/trace and one lib/profiler buffer
+set TRACE_HEADER_WORDS 4
+set PROFILER_HEADER_WORDS 6
+
+# halt both cores so a buffer isn't written while it is read, resume afterwards if it was running
+proc pico_dump_image { file addr size } {
+	set was_running [expr {[[target current] curstate] eq "running"}]
+	if { $was_running } {
+		halt
+	}
+	dump_image $file $addr $size
+	if { $was_running } {
+		resume
+	}
+}
+
+proc pico_dump_sram { file } {
+	global PICO_SRAM_BASE PICO_SRAM_SIZE
+	pico_dump_image $file $PICO_SRAM_BASE $PICO_SRAM_SIZE
+}
+
+add_usage_text pico_dump_sram "file"
+add_help_text pico_dump_sram "Dump all of SRAM to a file."
+
+# without an address the whole of SRAM is dumped, trace_decode finds the buffers in it
+proc trace_dump { file {addr ""} } {
+	global PICO_NUM_CORES TRACE_HEADER_WORDS
+	if { $addr eq "" } {
+		pico_dump_sram $file
+		return
+	}
+	set capacity [mrw [expr {$addr + 8}]]
+	set size [expr {$PICO_NUM_CORES * ($TRACE_HEADER_WORDS * 4 + $capacity * 8)}]
+	pico_dump_image $file $addr $size
+}
+
+add_usage_text trace_dump "file \[trace_buffers address\]"
+add_help_text trace_dump "Dump the lib/trace ring buffers to a file for trace_decode."
+
+proc profile_dump { file addr } {
+	global PICO_NUM_CORES PROFILER_HEADER_WORDS
+	set slots [mrw [expr {$addr + 4}]]
+	set size [expr {$PICO_NUM_CORES * ($PROFILER_HEADER_WORDS * 4 + $slots * 12)}]
+	pico_dump_image $file $addr $size
+}
+
+add_usage_text profile_dump "file profiler_histograms_address"
+add_help_text profile_dump "Dump the lib/profiler histograms to a file for profile_report."